@@ -0,0 +1,277 @@
+//
+//  main.cpp
+//  Benchmarks
+//
+//  Microbenchmarks and end-to-end scenarios on synthetic EDF files.
+//  Every scenario reports MB/s and samples/s; --json writes the same
+//  numbers in a form that can be tracked between builds.
+//
+//  ./benchmarks [--channels 32] [--samples 256] [--records 3600]
+//               [--repeat 5] [--filter name] [--json out.json] [--keep]
+//
+
+#include "EDFLib.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+using std::cout;
+using std::cerr;
+using std::endl;
+
+struct Options {
+    int channels = 32;
+    int samples = 256;     // samples per record for every data channel
+    int records = 3600;    // 1 s records
+    int repeat = 5;
+    string filter;
+    string json;
+    string dir = ".";
+    bool keep = false;
+};
+
+struct Result {
+    string name;
+    double seconds;  // best of the repeats
+    double bytes;    // bytes processed per run
+    double samples;  // samples produced per run
+};
+
+/***** SYNTHETIC FILES *****/
+
+// writes a file with a sine-plus-noise signal on every channel and, for EDF+C,
+// one event annotated in every record
+bool writeSyntheticFile(const string& path, const Options& opt, bool annotations) {
+    EDFGenerator generator(12345);
+    generator.setFiletype(annotations ? FileType::EDFPLUS : FileType::EDF);
+    generator.setRecordCount(opt.records);
+    generator.addChannels(opt.channels, opt.samples);
+    generator.setAnnotations(annotations ? 1 : 0);
+    return generator.write(path.c_str());
+}
+
+/***** HARNESS *****/
+
+double bestOf(int repeat, const std::function<void()>& run) {
+    double best = 1e300;
+    for (int i = 0; i < repeat; i++) {
+        auto begin = std::chrono::steady_clock::now();
+        run();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(end - begin).count());
+    }
+    return best;
+}
+
+void report(vector<Result>& results, const Options& opt, const string& name, double bytes, double samples, const std::function<void()>& run) {
+    if (!opt.filter.empty() && name.find(opt.filter) == string::npos)
+        return;
+
+    run(); // warm the page cache and any lazily built state
+    Result r = { name, bestOf(opt.repeat, run), bytes, samples };
+    results.push_back(r);
+    cout << std::left << std::setw(36) << name << std::right << std::fixed << std::setprecision(3)
+         << std::setw(12) << r.seconds * 1000 << " ms"
+         << std::setw(12) << std::setprecision(1) << r.bytes / r.seconds / 1e6 << " MB/s"
+         << std::setw(14) << std::setprecision(2) << r.samples / r.seconds / 1e6 << " Msamples/s" << endl;
+}
+
+void writeJson(const vector<Result>& results, const Options& opt) {
+    std::ofstream out(opt.json.c_str());
+    out << "{\n  \"config\": {\"channels\": " << opt.channels << ", \"samples_per_record\": " << opt.samples
+        << ", \"records\": " << opt.records << ", \"repeat\": " << opt.repeat << "},\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"seconds\": " << std::setprecision(9) << r.seconds
+            << ", \"mb_per_s\": " << r.bytes / r.seconds / 1e6
+            << ", \"samples_per_s\": " << r.samples / r.seconds << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+bool parseOptions(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--channels" && hasValue) opt.channels = atoi(argv[++i]);
+        else if (arg == "--samples" && hasValue) opt.samples = atoi(argv[++i]);
+        else if (arg == "--records" && hasValue) opt.records = atoi(argv[++i]);
+        else if (arg == "--repeat" && hasValue) opt.repeat = atoi(argv[++i]);
+        else if (arg == "--filter" && hasValue) opt.filter = argv[++i];
+        else if (arg == "--json" && hasValue) opt.json = argv[++i];
+        else if (arg == "--dir" && hasValue) opt.dir = argv[++i];
+        else if (arg == "--keep") opt.keep = true;
+        else {
+            cerr << "usage: " << argv[0] << " [--channels n] [--samples n] [--records n] [--repeat n]"
+                 << " [--filter name] [--json file] [--dir path] [--keep]" << endl;
+            return false;
+        }
+    }
+    return opt.channels > 0 && opt.samples > 0 && opt.records > 0 && opt.repeat > 0;
+}
+
+/***** SCENARIOS *****/
+
+void decodeBenchmarks(vector<Result>& results, const Options& opt) {
+    // one channel's worth of record bytes, decoded record by record
+    int layouts[] = {200, 256};
+    for (int n : layouts) {
+        int records = 20000;
+        vector<char> bytes(static_cast<size_t>(n) * 2 * records);
+        for (size_t i = 0; i < bytes.size(); i++)
+            bytes[i] = static_cast<char>(i * 31);
+        vector<double> out(n);
+        vector<int16_t> digital(n);
+        double volume = static_cast<double>(bytes.size());
+        double sink = 0;
+
+        // the per-sample loop extraction used before the bulk decoder
+        report(results, opt, "decode/legacy/" + std::to_string(n), volume, volume / 2, [&] {
+            for (int r = 0; r < records; r++) {
+                const char* record = bytes.data() + static_cast<size_t>(r) * n * 2;
+                for (int i = 0; i < n; i++)
+                    out[i] = record[2 * i] + 256 * record[2 * i + 1];
+                sink += out[0];
+            }
+        });
+
+        report(results, opt, "decode/double/" + std::to_string(n), volume, volume / 2, [&] {
+            for (int r = 0; r < records; r++) {
+                decodeSamples(bytes.data() + static_cast<size_t>(r) * n * 2, out.data(), n);
+                sink += out[0];
+            }
+        });
+
+        report(results, opt, "decode/int16/" + std::to_string(n), volume, volume / 2, [&] {
+            for (int r = 0; r < records; r++) {
+                decodeSamples(bytes.data() + static_cast<size_t>(r) * n * 2, digital.data(), n);
+                sink += digital[0];
+            }
+        });
+        if (sink == 0.5) cout << ""; // keep the loops observable
+
+        // the same samples decoded through parseSignal from a one channel file
+        Options single = opt;
+        single.channels = 1;
+        single.samples = n;
+        single.records = records;
+        string path = opt.dir + "/edf_bench_decode.edf";
+        if (!writeSyntheticFile(path, single, false)) {
+            cerr << "Could not write synthetic files in " << opt.dir << endl;
+            continue;
+        }
+        {
+            EDFFile file(path.c_str());
+            report(results, opt, "decode/parseSignal/" + std::to_string(n), volume, volume / 2, [&] {
+                delete file.extractSignalData(0, 0, records);
+            });
+        }
+        if (!opt.keep)
+            remove(path.c_str());
+    }
+}
+
+void statsBenchmarks(vector<Result>& results, const Options& opt) {
+    size_t count = 1 << 22;
+    vector<double> values(count);
+    for (size_t i = 0; i < count; i++)
+        values[i] = 1000 * std::sin(i * 0.001) + (i % 17);
+
+    report(results, opt, "stats/addDataPoints", count * sizeof(double), count, [&] {
+        EDFSignalData data(256, 3200, -3200);
+        data.addDataPoints(values.data(), values.size());
+        if (data.kurtosis() == 0.5) cout << "";
+    });
+}
+
+void fileBenchmarks(vector<Result>& results, const Options& opt) {
+    string plainPath = opt.dir + "/edf_bench_plain.edf";
+    string plusPath = opt.dir + "/edf_bench_plus.edf";
+    if (!writeSyntheticFile(plainPath, opt, false) || !writeSyntheticFile(plusPath, opt, true)) {
+        cerr << "Could not write synthetic files in " << opt.dir << endl;
+        return;
+    }
+
+    // throughput counts the record bytes each scenario has to read from the file
+    double channelSamples = static_cast<double>(opt.samples) * opt.records;
+    double recordBytes = 2.0 * opt.samples * opt.channels;
+    double dataBytes = recordBytes * opt.records;
+    double duration = opt.records;
+
+    report(results, opt, "open/header", 256.0 * (opt.channels + 1), 0, [&] {
+        EDFFile file(plainPath.c_str());
+    });
+
+    report(results, opt, "open/annotations", dataBytes, 0, [&] {
+        EDFFile file(plusPath.c_str());
+    });
+
+    {
+        EDFFile file(plainPath.c_str());
+        report(results, opt, "extract/single", dataBytes, channelSamples, [&] {
+            delete file.extractSignalData(0, 0, duration);
+        });
+
+        report(results, opt, "extract/single/int16", dataBytes, channelSamples, [&] {
+            delete file.extractSamples<int16_t>(0, 0, duration);
+        });
+
+        report(results, opt, "extract/multi", dataBytes * opt.channels, channelSamples * opt.channels, [&] {
+            for (int c = 0; c < opt.channels; c++)
+                delete file.extractSignalData(c, 0, duration);
+        });
+
+        vector<EDFWindow> windows;
+        for (int w = 0; w + 4 < opt.records; w += 7)
+            windows.push_back(EDFWindow{w + 0.5, 4});
+        double windowSamples = windows.size() * 4.0 * opt.samples;
+        report(results, opt, "extract/windows", windows.size() * 5 * recordBytes, windowSamples, [&] {
+            for (auto data : file.extractSignalWindows(0, windows))
+                delete data;
+        });
+
+        file.setReadSpan(0); // one record per read, the original access pattern
+        report(results, opt, "extract/single/record-reads", dataBytes, channelSamples, [&] {
+            delete file.extractSignalData(0, 0, duration);
+        });
+        file.setReadSpan(4 << 20);
+
+        file.setReadAhead(4);
+        report(results, opt, "extract/single/read-ahead", dataBytes, channelSamples, [&] {
+            delete file.extractSignalData(0, 0, duration);
+        });
+    }
+
+    if (!opt.keep) {
+        remove(plainPath.c_str());
+        remove(plusPath.c_str());
+    }
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseOptions(argc, argv, opt))
+        return EXIT_FAILURE;
+
+    vector<Result> results;
+    decodeBenchmarks(results, opt);
+    statsBenchmarks(results, opt);
+    fileBenchmarks(results, opt);
+
+    if (!opt.json.empty())
+        writeJson(results, opt);
+
+    return EXIT_SUCCESS;
+}
@@ -6,6 +6,7 @@
 
 #include "EDFAnnotation.h"
 #include <iomanip>
+#include <utility>
 
 using std::string;
 using std::vector;
@@ -14,7 +15,7 @@ EDFAnnotation::EDFAnnotation(double onset,
         double duration, vector<string> strings) {
     this->a_onset = (onset >= 0) ? onset : 0;
     this->a_duration = (duration >= 0) ? duration : 0;
-    this->a_strings = strings;
+    this->a_strings = std::move(strings);
 }
 
 EDFAnnotation::EDFAnnotation(const EDFAnnotation& orig) {
@@ -23,6 +24,12 @@ EDFAnnotation::EDFAnnotation(const EDFAnnotation& orig) {
     a_strings = orig.a_strings;
 }
 
+EDFAnnotation::EDFAnnotation(EDFAnnotation&& orig) noexcept
+    : a_onset(orig.a_onset)
+    , a_duration(orig.a_duration)
+    , a_strings(std::move(orig.a_strings))
+{}
+
 EDFAnnotation& EDFAnnotation::operator=(const EDFAnnotation& rhs) {
     if (this != &rhs) {
         a_onset = rhs.a_onset;
@@ -33,6 +40,16 @@ EDFAnnotation& EDFAnnotation::operator=(const EDFAnnotation& rhs) {
     return *this;
 }
 
+EDFAnnotation& EDFAnnotation::operator=(EDFAnnotation&& rhs) noexcept {
+    if (this != &rhs) {
+        a_onset = rhs.a_onset;
+        a_duration = rhs.a_duration;
+        a_strings = std::move(rhs.a_strings);
+    }
+
+    return *this;
+}
+
 std::ostream& operator<<(std::ostream& s, EDFAnnotation& ann) {
     vector<string>::iterator it;
     s << std::fixed << std::setprecision(1);
@@ -60,7 +77,7 @@ void EDFAnnotation::setDuration(double duration) {
 }
 
 void EDFAnnotation::setStrings(vector<string> strings) {
-    this->a_strings = strings;
+    this->a_strings = std::move(strings);
 }
 
 void EDFAnnotation::addString(string str) {
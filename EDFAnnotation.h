@@ -36,6 +36,12 @@ public:
      */
     EDFAnnotation(const EDFAnnotation&);
     
+    /**
+     Move constructor. The text is taken without copying.
+     @param orig The object to move from, left without text.
+     */
+    EDFAnnotation(EDFAnnotation&&) noexcept;
+    
     virtual ~EDFAnnotation() = default;
 
     /**
@@ -44,6 +50,12 @@ public:
      */
     EDFAnnotation& operator=(const EDFAnnotation&);
     
+    /**
+     Operator = overload to take the text of another annotation.
+     @param rhs The object to move from, left without text.
+     */
+    EDFAnnotation& operator=(EDFAnnotation&&) noexcept;
+    
     /**
      Output operator to make a readable string of this object.
      @param s An output stream reference to place the data into.
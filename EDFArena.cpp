@@ -0,0 +1,98 @@
+/**
+ @file EDFArena.cpp
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#include "EDFArena.h"
+#include <algorithm>
+#include <cstdint>
+
+EDFArena::EDFArena(size_t blockSize)
+    : a_blockSize(std::max(blockSize, static_cast<size_t>(64)))
+    , a_current(0)
+    , a_offset(0)
+    , a_heapAllocations(0)
+{}
+
+EDFArena::~EDFArena() {
+    for (const Block& block : a_blocks)
+        delete [] block.data;
+}
+
+void* EDFArena::allocate(size_t bytes, size_t align) {
+    if (a_blocks.empty())
+        grow(bytes + align);
+
+    // pad to the alignment inside the current block, moving on if it does not fit
+    Block* block = &a_blocks[a_current];
+    size_t pad = (align - reinterpret_cast<uintptr_t>(block->data + a_offset) % align) % align;
+    if (a_offset + pad + bytes > block->size) {
+        grow(bytes + align);
+        block = &a_blocks[a_current];
+        pad = (align - reinterpret_cast<uintptr_t>(block->data + a_offset) % align) % align;
+    }
+
+    char* result = block->data + a_offset + pad;
+    a_offset += pad + bytes;
+    return result;
+}
+
+size_t EDFArena::mark() const {
+    return a_blocks.empty() ? 0 : a_blocks[a_current].base + a_offset;
+}
+
+void EDFArena::rewind(size_t mark) {
+    if (mark == 0) {
+        reset();
+        return;
+    }
+    while (a_current > 0 && mark < a_blocks[a_current].base)
+        a_current--;
+    a_offset = mark - a_blocks[a_current].base;
+}
+
+void EDFArena::reset() {
+    // merge the blocks so the same demand fits without growing next time
+    if (a_blocks.size() > 1) {
+        size_t total = capacity();
+        for (const Block& block : a_blocks)
+            delete [] block.data;
+        a_blocks.clear();
+        a_blocks.push_back(Block{new char[total], total, 0});
+        a_heapAllocations++;
+    }
+    a_current = 0;
+    a_offset = 0;
+}
+
+size_t EDFArena::used() const { return mark(); }
+
+size_t EDFArena::capacity() const {
+    return a_blocks.empty() ? 0 : a_blocks.back().base + a_blocks.back().size;
+}
+
+unsigned long long EDFArena::heapAllocations() const { return a_heapAllocations; }
+
+void EDFArena::grow(size_t bytes) {
+    // reuse the next block if a rewind left one big enough
+    if (!a_blocks.empty() && a_current + 1 < a_blocks.size() && a_blocks[a_current + 1].size >= bytes) {
+        a_current++;
+        a_offset = 0;
+        return;
+    }
+
+    // otherwise blocks past the current one are unused and replaced by a larger one
+    size_t next = a_blocks.empty() ? 0 : a_current + 1;
+    for (size_t i = next; i < a_blocks.size(); i++)
+        delete [] a_blocks[i].data;
+    a_blocks.resize(next);
+
+    size_t size = a_blocks.empty() ? a_blockSize : a_blocks.back().size * 2;
+    size_t base = a_blocks.empty() ? 0 : a_blocks.back().base + a_blocks.back().size;
+    size = std::max(size, bytes);
+    a_blocks.push_back(Block{new char[size], size, base});
+    a_heapAllocations++;
+    a_current = a_blocks.size() - 1;
+    a_offset = 0;
+}
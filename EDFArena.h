@@ -0,0 +1,117 @@
+/**
+ @file EDFArena.h
+ @brief Monotonic scratch memory for extraction.
+ Allocations bump a pointer through large blocks and are never freed one by
+ one; the whole arena, or everything after a mark, is released at once.
+ When released down to empty, blocks added while growing are merged into a
+ single block big enough for all of them, so a steady stream of requests of
+ similar size stops allocating after the first.
+
+ Memory handed out is uninitialised and only suited to trivially
+ destructible types.
+
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#ifndef _EDFARENA_H
+#define	_EDFARENA_H
+
+#include <cstddef>
+#include <vector>
+
+class EDFArena {
+public:
+    /**
+     Constructor. No memory is allocated until first needed.
+     @param blockSize Bytes of the first block.
+     */
+    EDFArena(size_t = 1 << 16);
+    ~EDFArena();
+
+    EDFArena(const EDFArena&) = delete;
+    EDFArena& operator=(const EDFArena&) = delete;
+
+    /**
+     Allocate raw memory.
+     @param bytes Size in bytes.
+     @param align Alignment in bytes, a power of two.
+     @return Memory valid until released by rewind() or reset().
+     */
+    void* allocate(size_t, size_t = alignof(std::max_align_t));
+
+    /**
+     Allocate an array.
+     @param count Number of elements.
+     @return Uninitialised elements.
+     */
+    template <typename T>
+    T* allocate(size_t count) { return static_cast<T*>(allocate(count * sizeof(T), alignof(T))); }
+
+    /**
+     Get a position that rewind() can later release back to.
+     @return Opaque mark.
+     */
+    size_t mark() const;
+
+    /**
+     Release everything allocated since a mark.
+     @param mark Value returned by mark().
+     */
+    void rewind(size_t);
+
+    /**
+     Release everything.
+     */
+    void reset();
+
+    /**
+     Get the bytes in use.
+     @return Bytes handed out, including alignment padding.
+     */
+    size_t used() const;
+
+    /**
+     Get the bytes held.
+     @return Total size of all blocks.
+     */
+    size_t capacity() const;
+
+    /**
+     Get the number of blocks obtained from the heap since construction.
+     @return Heap allocation count.
+     */
+    unsigned long long heapAllocations() const;
+
+private:
+    struct Block {
+        char* data;
+        size_t size;
+        size_t base; // bytes in all earlier blocks
+    };
+    std::vector<Block> a_blocks;
+    size_t a_blockSize;
+    size_t a_current; // block allocations come from
+    size_t a_offset;  // bytes used in the current block
+    unsigned long long a_heapAllocations;
+
+    void grow(size_t);
+};
+
+/**
+ Releases everything allocated from an arena during its lifetime.
+ */
+class EDFArenaScope {
+public:
+    EDFArenaScope(EDFArena* arena) : arena(arena), start(arena->mark()) {}
+    ~EDFArenaScope() { arena->rewind(start); }
+
+    EDFArenaScope(const EDFArenaScope&) = delete;
+    EDFArenaScope& operator=(const EDFArenaScope&) = delete;
+
+private:
+    EDFArena* arena;
+    size_t start;
+};
+
+#endif	/* _EDFARENA_H */
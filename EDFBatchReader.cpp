@@ -0,0 +1,321 @@
+/**
+ @file EDFBatchReader.cpp
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#include "EDFBatchReader.h"
+#include "EDFDiagnostics.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#ifdef EDFLIB_HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+using std::string;
+using std::vector;
+
+/* io_uring rings, driven through the raw system calls so no extra library is needed */
+
+#ifdef EDFLIB_HAVE_IO_URING
+
+struct EDFUring {
+    int fd;
+    unsigned entries;
+
+    unsigned *sqHead, *sqTail, *sqMask, *sqArray;
+    io_uring_sqe* sqes;
+    unsigned *cqHead, *cqTail, *cqMask;
+    io_uring_cqe* cqes;
+
+    void* sqRing;
+    size_t sqRingSize;
+    void* cqRing;
+    size_t cqRingSize;
+    size_t sqesSize;
+};
+
+EDFUring* uringSetup(unsigned entries) {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (fd < 0)
+        return nullptr;
+
+    EDFUring* ring = new EDFUring();
+    ring->fd = fd;
+    ring->entries = params.sq_entries;
+    ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    ring->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+    bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMap)
+        ring->sqRingSize = ring->cqRingSize = std::max(ring->sqRingSize, ring->cqRingSize);
+
+    ring->sqRing = mmap(nullptr, ring->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    ring->cqRing = singleMap ? ring->sqRing :
+        mmap(nullptr, ring->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    void* sqes = mmap(nullptr, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (ring->sqRing == MAP_FAILED || ring->cqRing == MAP_FAILED || sqes == MAP_FAILED) {
+        if (sqes != MAP_FAILED) munmap(sqes, ring->sqesSize);
+        if (ring->cqRing != MAP_FAILED && !singleMap) munmap(ring->cqRing, ring->cqRingSize);
+        if (ring->sqRing != MAP_FAILED) munmap(ring->sqRing, ring->sqRingSize);
+        close(fd);
+        delete ring;
+        return nullptr;
+    }
+
+    char* sq = static_cast<char*>(ring->sqRing);
+    ring->sqHead  = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    ring->sqTail  = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    ring->sqMask  = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    ring->sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    ring->sqes    = static_cast<io_uring_sqe*>(sqes);
+
+    char* cq = static_cast<char*>(ring->cqRing);
+    ring->cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    ring->cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    ring->cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    ring->cqes   = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    return ring;
+}
+
+void uringTeardown(EDFUring* ring) {
+    if (ring == nullptr)
+        return;
+    munmap(ring->sqes, ring->sqesSize);
+    if (ring->cqRing != ring->sqRing)
+        munmap(ring->cqRing, ring->cqRingSize);
+    munmap(ring->sqRing, ring->sqRingSize);
+    close(ring->fd);
+    delete ring;
+}
+
+#else
+
+struct EDFUring {};
+
+EDFUring* uringSetup(unsigned) { return nullptr; }
+
+void uringTeardown(EDFUring*) {}
+
+#endif
+
+/* EDFBatchReader class */
+
+EDFBatchReader::EDFBatchReader(const string& path, int threads, int queueDepth)
+    : b_path(path)
+    , b_fd(-1)
+    , b_threads(threads > 0 ? threads : 1)
+    , b_queueDepth(queueDepth > 0 ? queueDepth : 1)
+    , b_ring(nullptr)
+{
+    b_fd = open(path.c_str(), O_RDONLY);
+    if (b_fd < 0) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::FILE_ACCESS,
+                               "EDFBatchReader: File '" + b_path + "' cannot be read.");
+        return;
+    }
+
+    // silently fall back to the thread pool when the kernel refuses a ring
+    b_ring = uringSetup(static_cast<unsigned>(b_queueDepth));
+}
+
+EDFBatchReader::~EDFBatchReader() {
+    uringTeardown(b_ring);
+    if (b_fd >= 0)
+        close(b_fd);
+}
+
+bool EDFBatchReader::isOpen() const { return b_fd >= 0; }
+
+bool EDFBatchReader::usingIoUring() const { return b_ring != nullptr; }
+
+bool EDFBatchReader::read(vector<EDFReadRequest>& requests, const std::function<void(size_t, bool)>& completed) {
+    if (b_fd < 0)
+        return false;
+    if (requests.empty())
+        return true;
+
+    return b_ring != nullptr ? readUring(requests, completed) : readThreaded(requests, completed);
+}
+
+#ifdef EDFLIB_HAVE_IO_URING
+
+bool EDFBatchReader::readUring(vector<EDFReadRequest>& requests, const std::function<void(size_t, bool)>& completed) {
+    EDFUring* ring = b_ring;
+    vector<iovec> iovecs(requests.size());
+    vector<size_t> done(requests.size(), 0); // bytes read so far, short reads are resubmitted
+    std::deque<size_t> pending;
+    for (size_t i = 0; i < requests.size(); i++)
+        pending.push_back(i);
+
+    bool success = true;
+    size_t remaining = requests.size();
+    unsigned inFlight = 0;    // taken by the kernel and not yet completed
+    unsigned unsubmitted = 0; // queued in the ring but not yet taken
+
+    while (remaining > 0) {
+        // queue as many reads as the ring has room for
+        unsigned tail = *ring->sqTail;
+        while (!pending.empty() && inFlight + unsubmitted < ring->entries) {
+            size_t idx = pending.front();
+            pending.pop_front();
+
+            iovecs[idx].iov_base = requests[idx].buffer + done[idx];
+            iovecs[idx].iov_len = requests[idx].length - done[idx];
+
+            unsigned slot = tail & *ring->sqMask;
+            io_uring_sqe* sqe = &ring->sqes[slot];
+            memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = IORING_OP_READV;
+            sqe->fd = b_fd;
+            sqe->off = static_cast<unsigned long long>(requests[idx].offset + done[idx]);
+            sqe->addr = reinterpret_cast<unsigned long long>(&iovecs[idx]);
+            sqe->len = 1;
+            sqe->user_data = idx;
+            ring->sqArray[slot] = slot;
+            tail++;
+            unsubmitted++;
+        }
+        __atomic_store_n(ring->sqTail, tail, __ATOMIC_RELEASE);
+
+        // the kernel may take fewer reads than offered, the rest stay queued for the next call
+        int entered = enter(unsubmitted, 1);
+        if (entered >= 0) {
+            unsubmitted -= static_cast<unsigned>(entered);
+            inFlight += static_cast<unsigned>(entered);
+        } else if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::RECORD_READ,
+                                   "EDFBatchReader: io_uring submission failed. Giving up...");
+            // withdraw what the kernel never took and let the rest land before the buffers go away
+            __atomic_store_n(ring->sqTail, tail - unsubmitted, __ATOMIC_RELEASE);
+            drainUring(inFlight);
+            return false;
+        }
+
+        // reap whatever has landed and decode it before waiting again
+        unsigned head = *ring->cqHead;
+        while (head != __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE)) {
+            io_uring_cqe* cqe = &ring->cqes[head & *ring->cqMask];
+            size_t idx = static_cast<size_t>(cqe->user_data);
+            int res = cqe->res;
+            head++;
+            __atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+            inFlight--;
+
+            if (res > 0 && done[idx] + res < requests[idx].length) {
+                done[idx] += res;
+                pending.push_back(idx);
+                continue;
+            }
+
+            bool ok = res > 0 && done[idx] + res == requests[idx].length;
+            success = success && ok;
+            remaining--;
+            completed(idx, ok);
+        }
+    }
+
+    return success;
+}
+
+void EDFBatchReader::drainUring(unsigned inFlight) {
+    EDFUring* ring = b_ring;
+    while (inFlight > 0) {
+        unsigned head = *ring->cqHead;
+        if (head == __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE)) {
+            // completions are posted without entering, so waiting falls back to polling the ring
+            if (enter(0, 1) < 0 && errno != EINTR)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        __atomic_store_n(ring->cqHead, head + 1, __ATOMIC_RELEASE);
+        inFlight--;
+    }
+}
+
+int EDFBatchReader::enter(unsigned toSubmit, unsigned minComplete) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, b_ring->fd, toSubmit, minComplete, IORING_ENTER_GETEVENTS, nullptr, 0));
+}
+
+#else
+
+bool EDFBatchReader::readUring(vector<EDFReadRequest>& requests, const std::function<void(size_t, bool)>& completed) {
+    return readThreaded(requests, completed);
+}
+
+void EDFBatchReader::drainUring(unsigned) {}
+
+int EDFBatchReader::enter(unsigned, unsigned) {
+    errno = ENOSYS;
+    return -1;
+}
+
+#endif
+
+bool EDFBatchReader::readThreaded(vector<EDFReadRequest>& requests, const std::function<void(size_t, bool)>& completed) {
+    std::atomic<size_t> nextRequest(0);
+    std::mutex mutex;
+    std::condition_variable landed;
+    std::deque<std::pair<size_t, bool> > finished;
+
+    auto worker = [&]() {
+        size_t idx;
+        while ((idx = nextRequest++) < requests.size()) {
+            EDFReadRequest& request = requests[idx];
+            size_t got = 0;
+            while (got < request.length) {
+                ssize_t res = pread(b_fd, request.buffer + got, request.length - got, request.offset + got);
+                if (res < 0 && errno == EINTR)
+                    continue;
+                if (res <= 0)
+                    break;
+                got += res;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            finished.push_back(std::make_pair(idx, got == request.length));
+            landed.notify_one();
+        }
+    };
+
+    int threadCount = static_cast<int>(std::min(requests.size(), static_cast<size_t>(b_threads)));
+    vector<std::thread> pool;
+    for (int i = 0; i < threadCount; i++)
+        pool.push_back(std::thread(worker));
+
+    bool success = true;
+    for (size_t handled = 0; handled < requests.size(); handled++) {
+        std::pair<size_t, bool> result;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            landed.wait(lock, [&] { return !finished.empty(); });
+            result = finished.front();
+            finished.pop_front();
+        }
+        success = success && result.second;
+        completed(result.first, result.second);
+    }
+
+    for (auto& thread : pool)
+        thread.join();
+
+    return success;
+}
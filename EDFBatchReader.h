@@ -0,0 +1,92 @@
+/**
+ @file EDFBatchReader.h
+ @brief Issues a batch of positioned reads against one file as asynchronous I/O.
+ Reads are submitted through io_uring where the platform provides it and
+ through a small pool of pread threads otherwise. Completions are handed
+ back on the calling thread as they arrive so decoding overlaps the I/O
+ still in flight.
+
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#ifndef _EDFBATCHREADER_H
+#define	_EDFBATCHREADER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <functional>
+
+/**
+ A single positioned read. The buffer must hold at least length bytes and
+ stay valid until the batch completes.
+ */
+struct EDFReadRequest {
+    long long offset;
+    size_t length;
+    char* buffer;
+};
+
+struct EDFUring;
+
+class EDFBatchReader {
+public:
+    EDFBatchReader() = delete;
+
+    /**
+     Constructor to open a file for batched reads.
+     @param path Path to the file on disk.
+     @param threads Worker count for the pread fallback.
+     @param queueDepth Maximum number of reads in flight at once.
+     */
+    EDFBatchReader(const std::string&, int = 4, int = 64);
+    EDFBatchReader(const EDFBatchReader&) = delete;
+    EDFBatchReader& operator=(const EDFBatchReader&) = delete;
+
+    virtual ~EDFBatchReader();
+
+    /**
+     Submit a batch of reads and wait for all of them.
+     @param requests The reads to perform.
+     @param completed Called on the calling thread once per request, in completion
+     order, with the request index and whether the read filled the buffer.
+     @return true if every read succeeded.
+     */
+    bool read(std::vector<EDFReadRequest>&, const std::function<void(size_t, bool)>&);
+
+    /**
+     Check whether the file was opened successfully.
+     @return true if reads can be issued.
+     */
+    bool isOpen() const;
+
+    /**
+     Check which backend services reads.
+     @return true when reads go through io_uring.
+     */
+    bool usingIoUring() const;
+
+protected:
+    /**
+     Hand queued reads to the kernel and wait for completions. Tests override
+     this to inject failures and partial submissions.
+     @param toSubmit Number of reads queued in the ring.
+     @param minComplete Number of completions to wait for.
+     @return Number of reads the kernel took, or -1 with errno set.
+     */
+    virtual int enter(unsigned, unsigned);
+
+private:
+    std::string b_path;
+    int b_fd;
+    int b_threads;
+    int b_queueDepth;
+    EDFUring* b_ring;
+
+    bool readUring(std::vector<EDFReadRequest>&, const std::function<void(size_t, bool)>&);
+    void drainUring(unsigned);
+    bool readThreaded(std::vector<EDFReadRequest>&, const std::function<void(size_t, bool)>&);
+};
+
+#endif	/* _EDFBATCHREADER_H */
@@ -0,0 +1,275 @@
+/**
+ @file EDFColumns.cpp
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#include "EDFColumns.h"
+#include "EDFDecode.h"
+#include "EDFDiagnostics.h"
+#include "EDFUtil.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <vector>
+#include <sys/stat.h>
+
+using std::string;
+using std::vector;
+
+/* Buffers one column and writes it out in large pieces */
+class ColumnWriter {
+public:
+    ColumnWriter(const string&, size_t);
+
+    template <typename T>
+    void append(const T*, int);
+    bool finish();
+
+private:
+    std::ofstream out;
+    vector<char> buffer;
+    size_t used;
+    bool failed;
+
+    void flush();
+};
+
+double recordOnset(const EDFHeader*, const char*, int);
+string jsonString(const string&);
+string typeName(EDFColumnType);
+bool writeMetadata(EDFFile&, const string&, EDFColumnType, const vector<int>&);
+
+bool exportColumns(EDFFile& file, const string& directory, EDFColumnType type, size_t bufferSize) {
+    const EDFHeader* header = file.header();
+    if (header == nullptr) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::HEADER_FORMAT,
+                               "exportColumns: File has no readable header. Giving up...");
+        return false;
+    }
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::FILE_ACCESS,
+                               "exportColumns: Directory '" + directory + "' cannot be created. Giving up...");
+        return false;
+    }
+
+    vector<int> signals;
+    vector<ColumnWriter*> columns;
+    int widest = 0;
+    range_loop(sig, 0, header->signalCount(), 1) {
+        if (sig == header->annotationIndex())
+            continue;
+        signals.push_back(sig);
+        columns.push_back(new ColumnWriter(directory + "/" + columnFileName(sig, type), bufferSize));
+        widest = std::max(widest, header->signalSampleCount(sig));
+    }
+    ColumnWriter onsets(directory + "/record_onsets.f64", bufferSize);
+
+    // one pass over the records feeds every column
+    vector<int16_t> digital(widest);
+    vector<float> singles(type == EDFColumnType::FLOAT ? widest : 0);
+    vector<double> doubles(type == EDFColumnType::DOUBLE ? widest : 0);
+    bool read = file.visitRecords(0, header->dataRecordCount(), [&](const char* record, int recordNum) {
+        double onset = recordOnset(header, record, recordNum);
+        onsets.append(&onset, 1);
+        range_loop(c, static_cast<size_t>(0), signals.size(), 1) {
+            int sig = signals[c];
+            int count = header->signalSampleCount(sig);
+            decodeSamples(record + header->bufferOffset(sig), digital.data(), count);
+            double gain = header->gain(sig), offset = header->offset(sig);
+            if (type == EDFColumnType::DIGITAL) {
+                columns[c]->append(digital.data(), count);
+            } else if (type == EDFColumnType::FLOAT) {
+                range_loop(i, 0, count, 1)
+                    singles[i] = static_cast<float>(gain * digital[i] + offset);
+                columns[c]->append(singles.data(), count);
+            } else {
+                range_loop(i, 0, count, 1)
+                    doubles[i] = gain * digital[i] + offset;
+                columns[c]->append(doubles.data(), count);
+            }
+        }
+    });
+
+    bool written = onsets.finish() && read;
+    for (ColumnWriter* column : columns) {
+        written = column->finish() && written;
+        delete column;
+    }
+    if (!written) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::FILE_ACCESS,
+                               "exportColumns: Error writing columns to '" + directory + "'. Giving up...");
+        return false;
+    }
+    return writeMetadata(file, directory, type, signals);
+}
+
+double recordOnset(const EDFHeader* header, const char* record, int recordNum) {
+    // an EDF+ record's first annotation list holds its start, plain EDF records follow each other
+    int annotation = header->annotationIndex();
+    if (annotation < 0)
+        return recordNum * header->dataRecordDuration();
+    const char* tal = record + header->bufferOffset(annotation);
+    const char* end = tal + 2 * header->signalSampleCount(annotation);
+    return atof(string(tal, std::find(tal, end, '\x14')).c_str());
+}
+
+string columnFileName(int signal, EDFColumnType type) {
+    const char* extension = type == EDFColumnType::DIGITAL ? "i16" : type == EDFColumnType::FLOAT ? "f32" : "f64";
+    return "channel_" + std::to_string(signal) + "." + extension;
+}
+
+ColumnWriter::ColumnWriter(const string& path, size_t size)
+    : buffer(std::max(size, static_cast<size_t>(64)))
+    , used(0)
+    , failed(false)
+{
+    // the buffer here replaces the stream's own, so each flush is one write
+    out.rdbuf()->pubsetbuf(nullptr, 0);
+    out.open(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    failed = !out.is_open();
+}
+
+template <typename T>
+void ColumnWriter::append(const T* values, int count) {
+    static const uint16_t probe = 1;
+    static const bool littleEndian = *reinterpret_cast<const unsigned char*>(&probe) == 1;
+
+    size_t bytes = sizeof(T) * static_cast<size_t>(count);
+    if (used + bytes > buffer.size())
+        flush();
+    if (bytes > buffer.size())
+        buffer.resize(bytes);
+
+    char* at = buffer.data() + used;
+    memcpy(at, values, bytes);
+    if (!littleEndian) {
+        range_loop(i, 0, count, 1)
+            std::reverse(at + i * sizeof(T), at + (i + 1) * sizeof(T));
+    }
+    used += bytes;
+}
+
+bool ColumnWriter::finish() {
+    flush();
+    out.close();
+    return !failed && !out.fail();
+}
+
+void ColumnWriter::flush() {
+    if (used > 0 && !failed)
+        failed = !out.write(buffer.data(), static_cast<std::streamsize>(used));
+    used = 0;
+}
+
+bool writeMetadata(EDFFile& file, const string& directory, EDFColumnType type, const vector<int>& signals) {
+    const EDFHeader* header = file.header();
+    std::ostringstream json;
+    json.precision(std::numeric_limits<double>::max_digits10);
+
+    char date[32], time[16];
+    snprintf(date, sizeof(date), "%04d-%02d-%02d", header->date().fullYear(), header->date().month(), header->date().day());
+    snprintf(time, sizeof(time), "%02d:%02d:%02d", header->startTime().hour(), header->startTime().minute(), header->startTime().second());
+    EDFPatient patient = header->patient();
+    const char* gender = patient.gender() == Gender::MALE ? "M" : patient.gender() == Gender::FEMALE ? "F" : "";
+
+    json << "{\n"
+         << "  \"format\": \"edflib-columns\",\n"
+         << "  \"version\": 1,\n"
+         << "  \"byteOrder\": \"little\",\n"
+         << "  \"filetype\": \"" << (header->filetype() == FileType::EDFPLUS ? "EDF+" : "EDF") << "\",\n"
+         << "  \"continuous\": " << (header->continuity() == Continuity::CONTINUOUS ? "true" : "false") << ",\n"
+         << "  \"startDate\": \"" << date << "\",\n"
+         << "  \"startTime\": \"" << time << "\",\n"
+         << "  \"patient\": {\"code\": " << jsonString(patient.code()) << ", \"name\": " << jsonString(patient.name())
+         << ", \"gender\": \"" << gender << "\", \"birthdate\": " << jsonString(patient.birthdate())
+         << ", \"additional\": " << jsonString(patient.additional()) << "},\n"
+         << "  \"recording\": {\"info\": " << jsonString(header->recording())
+         << ", \"adminCode\": " << jsonString(header->adminCode())
+         << ", \"technician\": " << jsonString(header->technician())
+         << ", \"equipment\": " << jsonString(header->equipment())
+         << ", \"additional\": " << jsonString(header->recordingAdditional()) << "},\n"
+         << "  \"recordCount\": " << header->dataRecordCount() << ",\n"
+         << "  \"recordDuration\": " << header->dataRecordDuration() << ",\n"
+         << "  \"recordOnsets\": {\"file\": \"record_onsets.f64\", \"type\": \"float64\"},\n"
+         << "  \"channels\": [";
+
+    range_loop(c, static_cast<size_t>(0), signals.size(), 1) {
+        int sig = signals[c];
+        int samplesPerRecord = header->signalSampleCount(sig);
+        json << (c > 0 ? ",\n" : "\n")
+             << "    {\"index\": " << sig
+             << ", \"label\": " << jsonString(header->label(sig))
+             << ", \"file\": \"" << columnFileName(sig, type) << "\""
+             << ", \"type\": \"" << typeName(type) << "\""
+             << ", \"samples\": " << static_cast<long long>(samplesPerRecord) * header->dataRecordCount()
+             << ", \"samplesPerRecord\": " << samplesPerRecord
+             << ", \"sampleRate\": " << samplesPerRecord / header->dataRecordDuration()
+             << ", \"physicalDimension\": " << jsonString(header->physicalDimension(sig))
+             << ", \"physicalMin\": " << header->physicalMin(sig)
+             << ", \"physicalMax\": " << header->physicalMax(sig)
+             << ", \"digitalMin\": " << header->digitalMin(sig)
+             << ", \"digitalMax\": " << header->digitalMax(sig)
+             << ", \"gain\": " << header->gain(sig)
+             << ", \"offset\": " << header->offset(sig)
+             << ", \"transducer\": " << jsonString(header->transducer(sig))
+             << ", \"prefilter\": " << jsonString(header->prefilter(sig)) << "}";
+    }
+    json << "\n  ],\n  \"annotations\": [";
+
+    const vector<EDFAnnotation>* annotations = file.annotations();
+    if (annotations != nullptr) {
+        range_loop(a, static_cast<size_t>(0), annotations->size(), 1) {
+            const EDFAnnotation& annotation = annotations->at(a);
+            json << (a > 0 ? ",\n" : "\n")
+                 << "    {\"onset\": " << annotation.onset() << ", \"duration\": " << annotation.duration() << ", \"texts\": [";
+            vector<string> texts = annotation.strings();
+            range_loop(t, static_cast<size_t>(0), texts.size(), 1)
+                json << (t > 0 ? ", " : "") << jsonString(texts[t]);
+            json << "]}";
+        }
+    }
+    json << "\n  ]\n}\n";
+
+    string path = directory + "/metadata.json";
+    std::ofstream out(path.c_str(), std::ios::out | std::ios::trunc);
+    string text = json.str();
+    if (!out.write(text.data(), text.size())) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::FILE_ACCESS,
+                               "exportColumns: Metadata cannot be written to '" + path + "'. Giving up...");
+        return false;
+    }
+    return true;
+}
+
+string jsonString(const string& value) {
+    string quoted = "\"";
+    for (char c : value) {
+        switch (c) {
+            case '"': quoted += "\\\""; break;
+            case '\\': quoted += "\\\\"; break;
+            case '\n': quoted += "\\n"; break;
+            case '\r': quoted += "\\r"; break;
+            case '\t': quoted += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    quoted += escaped;
+                } else {
+                    quoted += c;
+                }
+        }
+    }
+    return quoted + "\"";
+}
+
+string typeName(EDFColumnType type) {
+    return type == EDFColumnType::DIGITAL ? "int16" : type == EDFColumnType::FLOAT ? "float32" : "float64";
+}
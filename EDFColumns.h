@@ -0,0 +1,53 @@
+/**
+ @file EDFColumns.h
+ @brief Conversion of an EDF file into a columnar directory for analytics.
+ Every signal except the annotation signal becomes one file holding all of
+ its samples back to back as little endian values, ready to be memory
+ mapped. A metadata.json file alongside describes the recording, each
+ column's file, type, rate and scaling, and the annotations. The start of
+ every record in seconds is written to record_onsets.f64, so the samples of
+ a discontinuous EDF+ file can be placed in time.
+
+ The source is read once, record by record, and each column is written in
+ large sequential writes from its own buffer.
+
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#ifndef _EDFCOLUMNS_H
+#define	_EDFCOLUMNS_H
+
+#include <cstddef>
+#include <string>
+#include "EDFFile.h"
+
+/**
+ Sample type of the column files.
+ */
+enum class EDFColumnType {
+    DIGITAL, // int16 as stored, physical = gain * digital + offset
+    FLOAT,   // float32 in physical units
+    DOUBLE   // float64 in physical units
+};
+
+/**
+ Write a file's signals as columns.
+ @param file Source file.
+ @param directory Output directory, created if missing. Existing column,
+ record onset and metadata files are replaced.
+ @param type Sample type of the columns.
+ @param bufferSize Bytes gathered per column before each write.
+ @return true if every column and the metadata were written.
+ */
+bool exportColumns(EDFFile&, const std::string&, EDFColumnType = EDFColumnType::FLOAT, size_t = 1 << 20);
+
+/**
+ Get the file name of a column within the output directory.
+ @param signal Signal index in the source header.
+ @param type Sample type of the column.
+ @return Name such as "channel_3.f32".
+ */
+std::string columnFileName(int, EDFColumnType);
+
+#endif	/* _EDFCOLUMNS_H */
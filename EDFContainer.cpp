@@ -0,0 +1,406 @@
+/**
+ @file EDFContainer.cpp
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#include "EDFContainer.h"
+#include "EDFDecode.h"
+#include "EDFDiagnostics.h"
+#include "EDFEncode.h"
+#include "EDFFile.h"
+#include "EDFUtil.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+using std::string;
+using std::vector;
+
+const char CONTAINER_MAGIC[] = "EDFZ";
+const uint32_t CONTAINER_VERSION = 1;
+const size_t CONTAINER_PREFIX = 24;
+const size_t INDEX_ENTRY = 12;
+const size_t RICE_GROUP = 64;   // samples sharing one Rice parameter
+const uint32_t RICE_ESCAPE = 24; // quotient at which the value is stored raw
+
+void putUnsigned(string&, uint64_t, int);
+uint64_t getUnsigned(const char*, int);
+void encodeBlock(const int16_t*, size_t, string&);
+bool decodeBlock(const char*, size_t, int16_t*, size_t);
+
+/* Bits are packed least significant first */
+class BitWriter {
+public:
+    BitWriter(string& out) : out(out), acc(0), bits(0) {}
+
+    void put(uint32_t value, int count) {
+        acc |= static_cast<uint64_t>(value) << bits;
+        bits += count;
+        while (bits >= 8) {
+            out.push_back(static_cast<char>(acc & 0xFF));
+            acc >>= 8;
+            bits -= 8;
+        }
+    }
+
+    void ones(uint32_t count) {
+        while (count >= 16) {
+            put(0xFFFF, 16);
+            count -= 16;
+        }
+        put((1u << count) - 1, count);
+    }
+
+    void flush() {
+        if (bits > 0)
+            out.push_back(static_cast<char>(acc & 0xFF));
+        acc = 0;
+        bits = 0;
+    }
+
+private:
+    string& out;
+    uint64_t acc;
+    int bits;
+};
+
+class BitReader {
+public:
+    BitReader(const char* data, size_t size)
+        : next(reinterpret_cast<const unsigned char*>(data))
+        , end(reinterpret_cast<const unsigned char*>(data) + size)
+        , acc(0)
+        , bits(0)
+    {}
+
+    bool get(int count, uint32_t& value) {
+        refill();
+        if (bits < count)
+            return false;
+        value = static_cast<uint32_t>(acc & ((1ULL << count) - 1));
+        acc >>= count;
+        bits -= count;
+        return true;
+    }
+
+    // count the ones before the next zero, stopping at limit without a zero
+    bool unary(uint32_t limit, uint32_t& count) {
+        count = 0;
+        while (count < limit) {
+            refill();
+            if (bits == 0)
+                return false;
+            if ((acc & 1) == 0) {
+                acc >>= 1;
+                bits--;
+                return true;
+            }
+            // skip a run of ones at once
+            int run = 0;
+            while (run < bits && ((acc >> run) & 1) && count + run < limit)
+                run++;
+            acc >>= run;
+            bits -= run;
+            count += run;
+        }
+        return true;
+    }
+
+private:
+    const unsigned char* next;
+    const unsigned char* end;
+    uint64_t acc;
+    int bits;
+
+    void refill() {
+        while (bits <= 56 && next < end) {
+            acc |= static_cast<uint64_t>(*next++) << bits;
+            bits += 8;
+        }
+    }
+};
+
+bool compressFile(const char* source, const char* target, int recordsPerBlock) {
+    recordsPerBlock = std::max(recordsPerBlock, 1);
+    EDFFile file(source);
+    const EDFHeader* header = file.header();
+    if (header == nullptr)
+        return false;
+
+    // the header is copied as is, with the record count of the records present
+    int signals = header->signalCount();
+    int recordSize = header->dataRecordSize();
+    int recordCount = header->dataRecordCount();
+    string headerBytes(256 + 256 * static_cast<size_t>(signals), ' ');
+    std::ifstream in(source, std::ios::in | std::ios::binary);
+    if (!in.read(&headerBytes[0], headerBytes.size())) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::FILE_ACCESS,
+                               string("compressFile: File '") + source + "' cannot be read. Giving up...");
+        return false;
+    }
+    headerBytes.replace(236, 8, encodeNumber(recordCount, 8));
+
+    std::ofstream out(target, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::FILE_ACCESS,
+                               string("compressFile: File '") + target + "' cannot be written. Giving up...");
+        return false;
+    }
+
+    string prefix(CONTAINER_MAGIC, 4);
+    putUnsigned(prefix, CONTAINER_VERSION, 4);
+    putUnsigned(prefix, static_cast<uint64_t>(recordsPerBlock), 4);
+    putUnsigned(prefix, headerBytes.size(), 4);
+    putUnsigned(prefix, 0, 8); // index offset, filled in last
+    out.write(prefix.data(), prefix.size());
+    out.write(headerBytes.data(), headerBytes.size());
+
+    // each run of records becomes one block per signal
+    vector<char> records(static_cast<size_t>(recordsPerBlock) * recordSize);
+    vector<int16_t> samples;
+    string block, index;
+    uint64_t offset = CONTAINER_PREFIX + headerBytes.size();
+    range_loop(first, 0, recordCount, recordsPerBlock) {
+        int count = std::min(recordsPerBlock, recordCount - first);
+        if (!in.read(records.data(), static_cast<std::streamsize>(count) * recordSize)) {
+            EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::RECORD_READ,
+                                   "compressFile: Error reading signal records from file. Giving up...");
+            return false;
+        }
+
+        range_loop(sig, 0, signals, 1) {
+            int samplesPerRecord = header->signalSampleCount(sig);
+            samples.resize(static_cast<size_t>(count) * samplesPerRecord);
+            range_loop(r, 0, count, 1)
+                decodeSamples(records.data() + static_cast<size_t>(r) * recordSize + header->bufferOffset(sig),
+                              samples.data() + static_cast<size_t>(r) * samplesPerRecord, samplesPerRecord);
+
+            block.clear();
+            encodeBlock(samples.data(), samples.size(), block);
+            out.write(block.data(), block.size());
+            putUnsigned(index, offset, 8);
+            putUnsigned(index, block.size(), 4);
+            offset += block.size();
+        }
+    }
+
+    out.write(index.data(), index.size());
+    string indexOffset;
+    putUnsigned(indexOffset, offset, 8);
+    out.seekp(16);
+    out.write(indexOffset.data(), indexOffset.size());
+    out.close();
+    if (out.fail()) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::FILE_ACCESS,
+                               string("compressFile: Error writing '") + target + "'. Giving up...");
+        return false;
+    }
+    return true;
+}
+
+EDFContainerReader::EDFContainerReader(const string& path)
+    : z_valid(false)
+    , z_recordsPerBlock(0)
+    , z_recordCount(0)
+    , z_recordSize(0)
+    , z_blocksDecoded(0)
+{
+    z_stream.open(path.c_str(), std::ios::in | std::ios::binary);
+    char prefix[CONTAINER_PREFIX];
+    if (!z_stream.read(prefix, sizeof(prefix)) || memcmp(prefix, CONTAINER_MAGIC, 4) != 0 ||
+        getUnsigned(prefix + 4, 4) != CONTAINER_VERSION) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::HEADER_FORMAT,
+                               "EDFContainerReader: File '" + path + "' is not a supported container. Giving up...");
+        return;
+    }
+    z_recordsPerBlock = static_cast<int>(getUnsigned(prefix + 8, 4));
+    uint64_t indexOffset = getUnsigned(prefix + 16, 8);
+
+    // only the fields that fix the record layout are needed here
+    z_header.resize(getUnsigned(prefix + 12, 4));
+    int signals = 0;
+    if (z_header.size() >= 256 && z_stream.read(&z_header[0], z_header.size())) {
+        signals = atoi(z_header.substr(252, 4).c_str());
+        z_recordCount = atoi(z_header.substr(236, 8).c_str());
+    }
+    if (signals <= 0 || z_header.size() != 256 + 256 * static_cast<size_t>(signals) ||
+        z_recordsPerBlock <= 0 || z_recordCount < 0) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::HEADER_FORMAT,
+                               "EDFContainerReader: Container header has bad format. Giving up...");
+        return;
+    }
+    range_loop(sig, 0, signals, 1) {
+        z_samples.push_back(atoi(z_header.substr(256 + 216 * signals + 8 * sig, 8).c_str()));
+        z_offsets.push_back(z_recordSize);
+        z_recordSize += 2 * z_samples.back();
+    }
+
+    size_t runs = (static_cast<size_t>(z_recordCount) + z_recordsPerBlock - 1) / z_recordsPerBlock;
+    vector<char> index(runs * signals * INDEX_ENTRY);
+    z_stream.seekg(static_cast<std::streamoff>(indexOffset));
+    if (!z_stream.read(index.data(), index.size())) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::FILE_LENGTH,
+                               "EDFContainerReader: Block index is missing or short. Giving up...");
+        return;
+    }
+    range_loop(i, static_cast<size_t>(0), runs * signals, 1) {
+        z_blockOffset.push_back(getUnsigned(index.data() + i * INDEX_ENTRY, 8));
+        z_blockSize.push_back(static_cast<uint32_t>(getUnsigned(index.data() + i * INDEX_ENTRY + 8, 4)));
+    }
+
+    z_cache.resize(signals);
+    z_cachedBlock.assign(signals, -1);
+    z_valid = true;
+}
+
+bool EDFContainerReader::detect(std::istream& in) {
+    char magic[4] = {0, 0, 0, 0};
+    in.clear();
+    in.seekg(0, std::ios::beg);
+    in.read(magic, sizeof(magic));
+    in.clear();
+    in.seekg(0, std::ios::beg);
+    return memcmp(magic, CONTAINER_MAGIC, 4) == 0;
+}
+
+bool EDFContainerReader::valid() const { return z_valid; }
+
+const string& EDFContainerReader::headerBytes() const { return z_header; }
+
+int EDFContainerReader::recordsPerBlock() const { return z_recordsPerBlock; }
+
+unsigned long long EDFContainerReader::blocksDecoded() const { return z_blocksDecoded; }
+
+bool EDFContainerReader::read(int startRecord, int endRecord, const int* signals, size_t count, char* records) {
+    int signalCount = static_cast<int>(z_samples.size());
+    if (!z_valid || startRecord < 0 || endRecord > z_recordCount)
+        return false;
+    if (signals == nullptr)
+        count = z_samples.size();
+
+    range_loop(i, static_cast<size_t>(0), count, 1) {
+        int sig = signals != nullptr ? signals[i] : static_cast<int>(i);
+        if (sig < 0 || sig >= signalCount)
+            return false;
+
+        // copy each overlapping block's part back into record layout
+        int samplesPerRecord = z_samples[sig];
+        for (int run = startRecord / z_recordsPerBlock; run * z_recordsPerBlock < endRecord; run++) {
+            if (!loadBlock(sig, run))
+                return false;
+            int runStart = run * z_recordsPerBlock;
+            int first = std::max(startRecord, runStart);
+            int last = std::min(endRecord, runStart + z_recordsPerBlock);
+            range_loop(r, first, last, 1)
+                encodeSamples(z_cache[sig].data() + static_cast<size_t>(r - runStart) * samplesPerRecord,
+                              records + static_cast<size_t>(r - startRecord) * z_recordSize + z_offsets[sig],
+                              samplesPerRecord);
+        }
+    }
+    return true;
+}
+
+bool EDFContainerReader::loadBlock(int signal, int run) {
+    if (z_cachedBlock[signal] == run)
+        return true;
+
+    size_t entry = static_cast<size_t>(run) * z_samples.size() + signal;
+    int records = std::min(z_recordsPerBlock, z_recordCount - run * z_recordsPerBlock);
+    z_compressed.resize(z_blockSize[entry]);
+    z_cache[signal].resize(static_cast<size_t>(records) * z_samples[signal]);
+    z_cachedBlock[signal] = -1;
+
+    z_stream.clear();
+    z_stream.seekg(static_cast<std::streamoff>(z_blockOffset[entry]));
+    if (!z_stream.read(z_compressed.data(), z_compressed.size()) ||
+        !decodeBlock(z_compressed.data(), z_compressed.size(), z_cache[signal].data(), z_cache[signal].size())) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::RECORD_READ,
+                               "EDFContainerReader: Block is missing or corrupt. Giving up...");
+        return false;
+    }
+    z_cachedBlock[signal] = run;
+    z_blocksDecoded++;
+    return true;
+}
+
+void putUnsigned(string& out, uint64_t value, int bytes) {
+    range_loop(i, 0, bytes, 1)
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+uint64_t getUnsigned(const char* in, int bytes) {
+    uint64_t value = 0;
+    range_loop(i, 0, bytes, 1)
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+    return value;
+}
+
+void encodeBlock(const int16_t* samples, size_t count, string& out) {
+    // differences wrap at 16 bits, so every input round trips exactly
+    vector<uint16_t> folded(count);
+    uint16_t previous = 0;
+    range_loop(i, static_cast<size_t>(0), count, 1) {
+        int16_t delta = static_cast<int16_t>(static_cast<uint16_t>(samples[i]) - previous);
+        folded[i] = static_cast<uint16_t>((delta << 1) ^ (delta >> 15));
+        previous = static_cast<uint16_t>(samples[i]);
+    }
+
+    BitWriter bits(out);
+    range_loop(group, static_cast<size_t>(0), count, RICE_GROUP) {
+        size_t end = std::min(count, group + RICE_GROUP);
+
+        // a parameter near log2 of the mean keeps quotients short
+        uint64_t sum = 0;
+        range_loop(i, group, end, 1)
+            sum += folded[i];
+        uint64_t mean = sum / (end - group);
+        uint32_t k = 0;
+        while (k < 15 && (2ULL << k) <= mean)
+            k++;
+        bits.put(k, 4);
+
+        range_loop(i, group, end, 1) {
+            uint32_t quotient = folded[i] >> k;
+            if (quotient < RICE_ESCAPE) {
+                bits.ones(quotient);
+                bits.put(0, 1);
+                bits.put(folded[i] & ((1u << k) - 1), k);
+            } else {
+                bits.ones(RICE_ESCAPE);
+                bits.put(folded[i], 16);
+            }
+        }
+    }
+    bits.flush();
+}
+
+bool decodeBlock(const char* data, size_t size, int16_t* samples, size_t count) {
+    BitReader bits(data, size);
+    uint16_t previous = 0;
+    range_loop(group, static_cast<size_t>(0), count, RICE_GROUP) {
+        size_t end = std::min(count, group + RICE_GROUP);
+        uint32_t k;
+        if (!bits.get(4, k))
+            return false;
+
+        range_loop(i, group, end, 1) {
+            uint32_t quotient, folded;
+            if (!bits.unary(RICE_ESCAPE, quotient))
+                return false;
+            if (quotient < RICE_ESCAPE) {
+                uint32_t remainder = 0;
+                if (k > 0 && !bits.get(k, remainder))
+                    return false;
+                folded = (quotient << k) | remainder;
+            } else if (!bits.get(16, folded)) {
+                return false;
+            }
+
+            uint16_t delta = static_cast<uint16_t>((folded >> 1) ^ (0u - (folded & 1)));
+            previous = static_cast<uint16_t>(previous + delta);
+            samples[i] = static_cast<int16_t>(previous);
+        }
+    }
+    return true;
+}
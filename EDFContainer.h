@@ -0,0 +1,121 @@
+/**
+ @file EDFContainer.h
+ @brief Lossless compressed storage of EDF files with random access.
+ A container keeps the EDF header as is and stores the data records as
+ blocks, one per signal for each run of a fixed number of records. Within a
+ block each sample is replaced by its difference from the one before,
+ zigzag folded so small differences of either sign become small numbers,
+ and Rice coded with a parameter chosen for every 64 samples. A block index
+ at the end of the file locates every block, so a read decompresses only
+ the blocks of the signals and records it needs.
+
+ Layout, all integers little endian:
+   0   "EDFZ"
+   4   uint32 format version
+   8   uint32 records per block
+   12  uint32 EDF header size in bytes
+   16  uint64 offset of the block index
+   24  EDF header, record count filled in
+   ... blocks
+   index: for each block run, for each signal, uint64 offset and uint32 size
+
+ EDFFile recognises containers and reads them like plain files.
+
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#ifndef _EDFCONTAINER_H
+#define	_EDFCONTAINER_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ Compress an EDF or EDF+ file into a container.
+ @param source Path of the EDF file.
+ @param target Path of the container to write, replaced if it exists.
+ @param recordsPerBlock Records in each block. Larger blocks compress a
+ little better; smaller blocks decompress less around a short window.
+ @return true if the container was written.
+ */
+bool compressFile(const char*, const char*, int = 16);
+
+class EDFContainerReader {
+public:
+    /**
+     Open a container and read its block index.
+     @param path Path of the container.
+     */
+    EDFContainerReader(const std::string&);
+
+    EDFContainerReader(const EDFContainerReader&) = delete;
+    EDFContainerReader& operator=(const EDFContainerReader&) = delete;
+
+    /**
+     Check whether a stream holds a container. The stream is rewound.
+     @param in Stream open for reading.
+     @return true if the stream starts with the container signature.
+     */
+    static bool detect(std::istream&);
+
+    /**
+     Check whether the index was read and matches the header.
+     @return true if records can be read.
+     */
+    bool valid() const;
+
+    /**
+     Get the EDF header stored in the container.
+     @return Header bytes as they appear in an EDF file.
+     */
+    const std::string& headerBytes() const;
+
+    /**
+     Get the number of records in each block.
+     @return Records per block.
+     */
+    int recordsPerBlock() const;
+
+    /**
+     Rebuild data records, as they appear in an EDF file, for some signals.
+     Blocks are decompressed only where they overlap the records, and the
+     last block of each signal is kept for the next read.
+     @param startRecord First record.
+     @param endRecord One past the last record.
+     @param signals Signals to fill, or nullptr for all. The bytes of the
+     other signals are left untouched.
+     @param count Number of signals.
+     @param records Destination of (endRecord - startRecord) records.
+     @return false if a block could not be read or is corrupt.
+     */
+    bool read(int, int, const int*, size_t, char*);
+
+    /**
+     Get the number of blocks decompressed since opening.
+     @return Block count.
+     */
+    unsigned long long blocksDecoded() const;
+
+private:
+    std::ifstream z_stream;
+    std::string z_header;
+    bool z_valid;
+    int z_recordsPerBlock;
+    int z_recordCount;
+    int z_recordSize;
+    std::vector<int> z_samples;          // per record of each signal
+    std::vector<int> z_offsets;          // of each signal in a record
+    std::vector<uint64_t> z_blockOffset; // [block run * signals + signal]
+    std::vector<uint32_t> z_blockSize;
+    std::vector<std::vector<int16_t> > z_cache; // last block of each signal
+    std::vector<int> z_cachedBlock;
+    std::vector<char> z_compressed;
+    unsigned long long z_blocksDecoded;
+
+    bool loadBlock(int, int);
+};
+
+#endif	/* _EDFCONTAINER_H */
@@ -94,7 +94,7 @@ std::ostream& operator<<(std::ostream& s, EDFDate date) {
     return s;
 }
 
-bool EDFDate::operator==(const EDFDate& rhs) {
+bool EDFDate::operator==(const EDFDate& rhs) const {
     return this->d_day == rhs.d_day &&
            this->d_month == rhs.d_month &&
            this->d_year == rhs.d_year;
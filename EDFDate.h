@@ -63,7 +63,7 @@ public:
      Test deep equality.
      @return true if all properties are equal, otherwise false.
      */
-    bool operator==(const EDFDate&);
+    bool operator==(const EDFDate&) const;
 
     /**
      Get the integer day of month value.
@@ -0,0 +1,81 @@
+/**
+ @file EDFDecode.h
+ @brief Sample decoding for the data record section.
+ Samples are stored as little endian two's complement 16 bit integers. On
+ little endian hosts a run of samples is copied out of the record in bulk
+ and, for wider outputs, converted in one widening pass; elsewhere each
+ sample is assembled from its bytes.
+
+ Two output widths are provided:
+  double  digital samples widened to double
+  int16_t raw little endian two's complement digital samples
+
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#ifndef _EDFDECODE_H
+#define	_EDFDECODE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+template <typename T>
+inline T decodeSample(const char*);
+
+template <>
+inline int16_t decodeSample<int16_t>(const char* p) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(p);
+    return static_cast<int16_t>(bytes[0] | (bytes[1] << 8));
+}
+
+template <>
+inline double decodeSample<double>(const char* p) {
+    return decodeSample<int16_t>(p);
+}
+
+/**
+ Check whether the host stores integers in the same byte order as EDF.
+ @return true on little endian hosts.
+ */
+inline bool hostLittleEndian() {
+    const uint16_t probe = 1;
+    return *reinterpret_cast<const unsigned char*>(&probe) == 1;
+}
+
+/**
+ Decode any number of consecutive samples.
+ @param in First byte of the first sample.
+ @param out Destination for count values.
+ @param count Number of samples.
+ */
+template <typename T>
+void decodeSamples(const char* in, T* out, int count) {
+    if (!hostLittleEndian()) {
+        for (int i = 0; i < count; i++)
+            out[i] = decodeSample<T>(in + 2 * i);
+        return;
+    }
+
+    // copy a chunk in one go, then widen it
+    int16_t chunk[512];
+    for (int done = 0; done < count; done += 512) {
+        int n = std::min(512, count - done);
+        memcpy(chunk, in + 2 * done, 2 * n);
+        for (int i = 0; i < n; i++)
+            out[done + i] = chunk[i];
+    }
+}
+
+template <>
+inline void decodeSamples<int16_t>(const char* in, int16_t* out, int count) {
+    if (hostLittleEndian()) {
+        memcpy(out, in, 2 * static_cast<size_t>(count));
+        return;
+    }
+    for (int i = 0; i < count; i++)
+        out[i] = decodeSample<int16_t>(in + 2 * i);
+}
+
+#endif	/* _EDFDECODE_H */
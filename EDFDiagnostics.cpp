@@ -0,0 +1,149 @@
+/**
+ @file EDFDiagnostics.cpp
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#include "EDFDiagnostics.h"
+#include <chrono>
+#include <iostream>
+#include <mutex>
+
+using std::string;
+typedef std::chrono::steady_clock Clock;
+
+const int CODES = static_cast<int>(EDFDiagnosticCode::CODE_COUNT);
+const int SEVERITIES = 3;
+
+/* Prints each report on its own line, as the library did before it had sinks */
+class StderrSink : public EDFDiagnosticSink {
+public:
+    void report(const EDFDiagnostic& diagnostic) {
+        std::cerr << diagnostic.message << std::endl;
+    }
+};
+
+/* Counters and rate limit windows shared by every file in the process */
+struct DiagnosticsState {
+    std::mutex mutex;
+    StderrSink stderrSink;
+    EDFDiagnosticSink* sink;
+    unsigned int rateLimit;
+    unsigned long long counts[CODES];
+    unsigned long long severityCounts[SEVERITIES];
+    unsigned long long suppressedCounts[CODES];
+    unsigned int delivered[CODES]; // in the current window
+    bool noticed[CODES];           // suppression notice sent in the current window
+    Clock::time_point windowStart[CODES];
+
+    DiagnosticsState() : sink(&stderrSink), rateLimit(10) { reset(); }
+
+    void reset() {
+        for (int c = 0; c < CODES; c++) {
+            counts[c] = suppressedCounts[c] = 0;
+            delivered[c] = 0;
+            noticed[c] = false;
+            windowStart[c] = Clock::time_point();
+        }
+        for (int s = 0; s < SEVERITIES; s++)
+            severityCounts[s] = 0;
+    }
+
+    // start a new window for the code when a second has passed, then check its budget
+    bool open(int c) {
+        if (rateLimit == 0)
+            return true;
+        Clock::time_point now = Clock::now();
+        if (now - windowStart[c] >= std::chrono::seconds(1)) {
+            windowStart[c] = now;
+            delivered[c] = 0;
+            noticed[c] = false;
+        }
+        return delivered[c] < rateLimit;
+    }
+};
+
+DiagnosticsState& diagnosticsState() {
+    static DiagnosticsState state;
+    return state;
+}
+
+void EDFDiagnostics::report(EDFSeverity severity, EDFDiagnosticCode code, const string& message, unsigned long long occurrences) {
+    DiagnosticsState& state = diagnosticsState();
+    int c = static_cast<int>(code);
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.counts[c] += occurrences;
+    state.severityCounts[static_cast<int>(severity)] += occurrences;
+
+    if (state.open(c)) {
+        state.delivered[c]++;
+        EDFDiagnostic diagnostic = { severity, code, message, occurrences };
+        state.sink->report(diagnostic);
+        return;
+    }
+
+    state.suppressedCounts[c] += occurrences;
+    if (!state.noticed[c]) {
+        state.noticed[c] = true;
+        EDFDiagnostic notice = { EDFSeverity::INFO, code,
+            string("Further ") + name(code) + " reports are suppressed for the next second...", 0 };
+        state.sink->report(notice);
+    }
+}
+
+bool EDFDiagnostics::accepts(EDFDiagnosticCode code) {
+    DiagnosticsState& state = diagnosticsState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    return state.open(static_cast<int>(code));
+}
+
+void EDFDiagnostics::setSink(EDFDiagnosticSink* sink) {
+    DiagnosticsState& state = diagnosticsState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.sink = sink != nullptr ? sink : &state.stderrSink;
+}
+
+void EDFDiagnostics::setRateLimit(unsigned int perSecond) {
+    DiagnosticsState& state = diagnosticsState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.rateLimit = perSecond;
+}
+
+unsigned long long EDFDiagnostics::count(EDFDiagnosticCode code) {
+    DiagnosticsState& state = diagnosticsState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    return state.counts[static_cast<int>(code)];
+}
+
+unsigned long long EDFDiagnostics::count(EDFSeverity severity) {
+    DiagnosticsState& state = diagnosticsState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    return state.severityCounts[static_cast<int>(severity)];
+}
+
+unsigned long long EDFDiagnostics::suppressed(EDFDiagnosticCode code) {
+    DiagnosticsState& state = diagnosticsState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    return state.suppressedCounts[static_cast<int>(code)];
+}
+
+void EDFDiagnostics::resetCounters() {
+    DiagnosticsState& state = diagnosticsState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.reset();
+}
+
+const char* EDFDiagnostics::name(EDFDiagnosticCode code) {
+    switch (code) {
+        case EDFDiagnosticCode::FILE_ACCESS:       return "FILE_ACCESS";
+        case EDFDiagnosticCode::HEADER_FORMAT:     return "HEADER_FORMAT";
+        case EDFDiagnosticCode::FILE_LENGTH:       return "FILE_LENGTH";
+        case EDFDiagnosticCode::ANNOTATION_SIGNAL: return "ANNOTATION_SIGNAL";
+        case EDFDiagnosticCode::ANNOTATION_FORMAT: return "ANNOTATION_FORMAT";
+        case EDFDiagnosticCode::RECORD_READ:       return "RECORD_READ";
+        case EDFDiagnosticCode::WINDOW_RANGE:      return "WINDOW_RANGE";
+        case EDFDiagnosticCode::VALUE_RANGE:       return "VALUE_RANGE";
+        case EDFDiagnosticCode::CHANNEL_INDEX:     return "CHANNEL_INDEX";
+        default:                                   return "UNKNOWN";
+    }
+}
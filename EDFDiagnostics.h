@@ -0,0 +1,126 @@
+/**
+ @file EDFDiagnostics.h
+ @brief Structured reporting of the problems found while reading EDF files.
+ Every warning and error of the library goes through EDFDiagnostics, which
+ counts it by kind and severity and hands it to a sink. Delivery is rate
+ limited per kind, so a file with millions of bad samples costs a few counter
+ updates rather than millions of writes to stderr. The default sink prints to
+ std::cerr as the library always has.
+
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#ifndef _EDFDIAGNOSTICS_H
+#define	_EDFDIAGNOSTICS_H
+
+#include <string>
+
+enum class EDFSeverity { INFO, WARNING, ERROR };
+
+enum class EDFDiagnosticCode {
+    FILE_ACCESS,       // a file could not be opened or written
+    HEADER_FORMAT,     // header bytes are unreadable or malformed
+    FILE_LENGTH,       // data section does not match the header
+    ANNOTATION_SIGNAL, // unexpected or repeated annotation signals
+    ANNOTATION_FORMAT, // malformed TAL onset or duration
+    RECORD_READ,       // a read of data records failed
+    WINDOW_RANGE,      // requested time lies outside the recording
+    VALUE_RANGE,       // sample outside the declared signal range
+    CHANNEL_INDEX,     // nonexistent channel addressed
+    CODE_COUNT
+};
+
+/**
+ One delivered report.
+ */
+struct EDFDiagnostic {
+    EDFSeverity severity;
+    EDFDiagnosticCode code;
+    std::string message;
+    unsigned long long occurrences; // problems this report stands for
+};
+
+/**
+ Receives the reports that pass the rate limit.
+ */
+class EDFDiagnosticSink {
+public:
+    virtual ~EDFDiagnosticSink() = default;
+
+    /**
+     Handle one report. Called with the library's diagnostics lock held, so
+     implementations must not report diagnostics themselves.
+     @param diagnostic The report.
+     */
+    virtual void report(const EDFDiagnostic&) = 0;
+};
+
+class EDFDiagnostics {
+public:
+    /**
+     Count a problem and deliver it to the sink unless its kind is over the rate limit.
+     @param severity How serious the problem is.
+     @param code Kind of problem.
+     @param message Readable description.
+     @param occurrences Number of problems the report stands for.
+     */
+    static void report(EDFSeverity, EDFDiagnosticCode, const std::string&, unsigned long long = 1);
+
+    /**
+     Check whether a report of a kind would currently be delivered. Lets hot
+     paths skip building a message that would be dropped.
+     @param code Kind of problem.
+     @return true if the next report of this kind reaches the sink.
+     */
+    static bool accepts(EDFDiagnosticCode);
+
+    /**
+     Set the receiver of reports.
+     @param sink Sink to call, not owned. nullptr restores the std::cerr sink.
+     */
+    static void setSink(EDFDiagnosticSink*);
+
+    /**
+     Set how many reports of each kind are delivered per second. Once a kind
+     reaches the limit one notice is delivered and the rest of the second's
+     reports are only counted.
+     @param perSecond Reports per kind per second, 0 for no limit. Defaults to 10.
+     */
+    static void setRateLimit(unsigned int);
+
+    /**
+     Get the number of problems counted of one kind.
+     @param code Kind of problem.
+     @return Occurrences since start or the last resetCounters.
+     */
+    static unsigned long long count(EDFDiagnosticCode);
+
+    /**
+     Get the number of problems counted of one severity.
+     @param severity Severity.
+     @return Occurrences since start or the last resetCounters.
+     */
+    static unsigned long long count(EDFSeverity);
+
+    /**
+     Get the number of problems of one kind that were counted but not delivered.
+     @param code Kind of problem.
+     @return Suppressed occurrences since start or the last resetCounters.
+     */
+    static unsigned long long suppressed(EDFDiagnosticCode);
+
+    /**
+     Zero all counters and rate limit windows.
+     */
+    static void resetCounters();
+
+    /**
+     Get a short name for a kind of problem.
+     @param code Kind of problem.
+     @return Name such as "VALUE_RANGE".
+     */
+    static const char* name(EDFDiagnosticCode);
+};
+
+#endif	/* _EDFDIAGNOSTICS_H */
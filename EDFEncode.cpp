@@ -0,0 +1,114 @@
+/**
+ @file EDFEncode.cpp
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#include "EDFEncode.h"
+#include "EDFUtil.h"
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+using std::string;
+
+string encodeSubfield(const string&);
+string encodeDate(const EDFDate&);
+string encodeTime(const EDFTime&);
+
+string encodeField(const string& value, size_t width) {
+    string s = value.substr(0, width);
+    s.resize(width, ' ');
+    return s;
+}
+
+string encodeNumber(double value, size_t width) {
+    // shortest representation first, then give up precision until it fits
+    string s;
+    for (int precision = 12; precision > 0; precision--) {
+        std::ostringstream out;
+        out << std::setprecision(precision) << value;
+        s = out.str();
+        if (s.size() <= width)
+            break;
+    }
+    return encodeField(s, width);
+}
+
+string encodeHeader(const EDFHeader& header) {
+    int signalCount = header.signalCount();
+    bool plus = header.filetype() == FileType::EDFPLUS;
+    string h;
+    h.reserve(256 + signalCount * 256);
+
+    h += encodeField("0", 8);
+
+    // identification subfields are space separated and may not contain spaces,
+    // EDF+ requires them and EDFFile reads the patient that way for both types
+    EDFPatient patient = header.patient();
+    string gender = patient.gender() == Gender::FEMALE ? "F" : patient.gender() == Gender::MALE ? "M" : "X";
+    h += encodeField(encodeSubfield(patient.code()) + " " + gender + " " +
+                     encodeSubfield(patient.birthdate()) + " " + encodeSubfield(patient.name()), 80);
+    if (plus) {
+        EDFDate date = header.date();
+        const string months = "JANFEBMARAPRMAYJUNJULAUGSEPOCTNOVDEC";
+        std::ostringstream start;
+        start << std::setw(2) << std::setfill('0') << date.day() << "-"
+              << months.substr((date.month() - 1) * 3, 3) << "-" << date.fullYear();
+        h += encodeField("Startdate " + start.str() + " " + encodeSubfield(header.adminCode()) + " " +
+                         encodeSubfield(header.technician()) + " " + encodeSubfield(header.equipment()), 80);
+    } else {
+        h += encodeField(header.recording(), 80);
+    }
+
+    h += encodeDate(header.date());
+    h += encodeTime(header.startTime());
+    h += encodeNumber(256 + signalCount * 256, 8);
+
+    string reserved;
+    if (plus)
+        reserved = header.continuity() == Continuity::DISCONTINUOUS ? "EDF+D" : "EDF+C";
+    h += encodeField(reserved, 44);
+
+    h += encodeNumber(header.dataRecordCount(), 8);
+    h += encodeNumber(header.dataRecordDuration(), 8);
+    h += encodeNumber(signalCount, 4);
+
+    range_loop(sig, 0, signalCount, 1) h += encodeField(header.label(sig), 16);
+    range_loop(sig, 0, signalCount, 1) h += encodeField(header.transducer(sig), 80);
+    range_loop(sig, 0, signalCount, 1) h += encodeField(header.physicalDimension(sig), 8);
+    range_loop(sig, 0, signalCount, 1) h += encodeNumber(header.physicalMin(sig), 8);
+    range_loop(sig, 0, signalCount, 1) h += encodeNumber(header.physicalMax(sig), 8);
+    range_loop(sig, 0, signalCount, 1) h += encodeNumber(header.digitalMin(sig), 8);
+    range_loop(sig, 0, signalCount, 1) h += encodeNumber(header.digitalMax(sig), 8);
+    range_loop(sig, 0, signalCount, 1) h += encodeField(header.prefilter(sig), 80);
+    range_loop(sig, 0, signalCount, 1) h += encodeNumber(header.signalSampleCount(sig), 8);
+    range_loop(sig, 0, signalCount, 1) h += encodeField(header.reserved(sig), 32);
+
+    return h;
+}
+
+string encodeTAL(double onset, const string& text) {
+    std::ostringstream tal;
+    tal << (onset < 0 ? '-' : '+') << std::setprecision(15) << std::fabs(onset) << '\x14';
+    tal << text << '\x14' << '\0';
+    return tal.str();
+}
+
+string encodeSubfield(const string& value) {
+    return value.empty() ? "X" : convertSpaces(value);
+}
+
+string encodeDate(const EDFDate& date) {
+    std::ostringstream s;
+    s << std::setfill('0') << std::setw(2) << date.day() << "." << std::setw(2) << date.month()
+      << "." << std::setw(2) << date.year();
+    return s.str();
+}
+
+string encodeTime(const EDFTime& time) {
+    std::ostringstream s;
+    s << std::setfill('0') << std::setw(2) << time.hour() << "." << std::setw(2) << time.minute()
+      << "." << std::setw(2) << time.second();
+    return s.str();
+}
@@ -0,0 +1,68 @@
+/**
+ @file EDFEncode.h
+ @brief Serialisation of EDF structures back into file bytes.
+ The inverse of the parsing done by EDFFile: a header model becomes the fixed
+ width ASCII header block, digital samples become little endian two's
+ complement pairs and annotations become time-stamped annotation lists (TALs).
+
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#ifndef _EDFENCODE_H
+#define	_EDFENCODE_H
+
+#include <cstdint>
+#include <string>
+#include "EDFHeader.h"
+
+/**
+ Left align a value in a fixed width, space padded header field.
+ Values longer than the field are truncated.
+ @param value Field contents.
+ @param width Field width in bytes.
+ @return String of exactly width characters.
+ */
+std::string encodeField(const std::string&, size_t);
+
+/**
+ Format a number in at most width characters, dropping precision as needed.
+ @param value Number to format.
+ @param width Field width in bytes.
+ @return String of exactly width characters.
+ */
+std::string encodeNumber(double, size_t);
+
+/**
+ Build the complete header block for a file, 256 bytes plus 256 bytes for
+ each signal. Data record size and buffer offsets are derived from the
+ signal sample counts, so only the descriptive fields need to be set.
+ @param header The header to serialise.
+ @return The header bytes.
+ */
+std::string encodeHeader(const EDFHeader&);
+
+/**
+ Build one TAL. An empty text produces the timekeeping form "+onset<20><20><0>"
+ that starts the annotation signal of every EDF+ data record.
+ @param onset Seconds from the start of the recording.
+ @param text Annotation text, may be empty.
+ @return The TAL bytes, including the terminating zero.
+ */
+std::string encodeTAL(double, const std::string&);
+
+/**
+ Encode digital samples into record bytes.
+ @param in Samples to encode.
+ @param out Destination for 2 * count bytes.
+ @param count Number of samples.
+ */
+inline void encodeSamples(const int16_t* in, char* out, int count) {
+    for (int i = 0; i < count; i++) {
+        uint16_t v = static_cast<uint16_t>(in[i]);
+        out[2 * i] = static_cast<char>(v & 0xff);
+        out[2 * i + 1] = static_cast<char>(v >> 8);
+    }
+}
+
+#endif	/* _EDFENCODE_H */
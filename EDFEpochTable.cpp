@@ -0,0 +1,138 @@
+/**
+ @file EDFEpochTable.cpp
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#include "EDFEpochTable.h"
+#include "EDFUtil.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+using std::vector;
+
+EDFEpochTable::EDFEpochTable(EDFHeader* header, const vector<int>& channels, double length, double overlap)
+    : e_length(length)
+    , e_step(length - overlap)
+    , e_epochs(0)
+{
+    // whole epochs only, tolerating rounding in the recording time
+    double recording = header->recordingTime();
+    if (recording >= length)
+        e_epochs = static_cast<int>(floor((recording - length) / e_step + 1e-9)) + 1;
+
+    e_rows.resize(channels.size());
+    range_loop(r, static_cast<size_t>(0), channels.size(), 1) {
+        Row& row = e_rows[r];
+        int signal = channels[r];
+        row.channel = signal;
+        row.next = 0;
+        row.firstOpen = 0;
+        row.previous = 0;
+
+        row.gain = header->gain(signal);
+        row.offset = header->offset(signal);
+
+        // same sample boundaries a window extraction of each epoch uses
+        double freq = header->signalSampleCount(signal) / header->dataRecordDuration();
+        row.begin.resize(e_epochs);
+        row.end.resize(e_epochs);
+        range_loop(e, 0, e_epochs, 1) {
+            row.begin[e] = static_cast<long long>(floor(epochStart(e) * freq));
+            row.end[e] = static_cast<long long>(floor((epochStart(e) + length) * freq));
+        }
+    }
+
+    Accumulator empty;
+    empty.min = INT16_MAX;
+    empty.max = INT16_MIN;
+    empty.lineLength = 0;
+    e_accumulators.assign(e_rows.size() * e_epochs, empty);
+}
+
+void EDFEpochTable::addDigitalSamples(int r, const int16_t* vals, size_t length) {
+    Row& row = e_rows[r];
+    long long first = row.next, last = first + static_cast<long long>(length);
+    Accumulator* cells = e_accumulators.data() + static_cast<size_t>(r) * e_epochs;
+
+    // every epoch overlapping [first, last) takes its part of the samples
+    for (int e = row.firstOpen; e < e_epochs && row.begin[e] < last; e++) {
+        long long from = std::max(first, row.begin[e]);
+        long long to = std::min(last, row.end[e]);
+        if (from >= to)
+            continue;
+
+        Accumulator& cell = cells[e];
+        const int16_t* x = vals + (from - first);
+        size_t count = static_cast<size_t>(to - from);
+        cell.moments.add(x, count);
+
+        // the step into the first sample counts when the previous one is in the epoch too
+        int16_t lo = cell.min, hi = cell.max;
+        long long line = 0;
+        int16_t prev = from > row.begin[e] ? (from > first ? x[-1] : row.previous) : x[0];
+        for (size_t i = 0; i < count; i++) {
+            lo = x[i] < lo ? x[i] : lo;
+            hi = x[i] > hi ? x[i] : hi;
+            line += std::abs(x[i] - prev);
+            prev = x[i];
+        }
+        cell.min = lo;
+        cell.max = hi;
+        cell.lineLength += line;
+    }
+
+    // epochs ending inside what has been added are complete
+    while (row.firstOpen < e_epochs && row.end[row.firstOpen] <= last)
+        row.firstOpen++;
+    if (length > 0)
+        row.previous = vals[length - 1];
+    row.next = last;
+}
+
+void EDFEpochTable::finish() {
+    e_stats.resize(e_accumulators.size());
+    range_loop(r, static_cast<size_t>(0), e_rows.size(), 1) {
+        const Row& row = e_rows[r];
+        range_loop(e, 0, e_epochs, 1) {
+            size_t cell = r * e_epochs + e;
+            const Accumulator& acc = e_accumulators[cell];
+            EDFEpochStats& stats = e_stats[cell];
+            stats = EDFEpochStats();
+            stats.count = static_cast<size_t>(acc.moments.count());
+            if (stats.count == 0)
+                continue;
+
+            EDFMoments physical = acc.moments.scaled(row.gain, row.offset);
+            stats.mean = physical.mean();
+            stats.variance = stats.count > 1 ? physical.variance() : 0;
+            stats.rms = sqrt(stats.mean * stats.mean + physical.centralSum(2) / stats.count);
+
+            // a negative gain swaps the extremes
+            double a = row.gain * acc.min + row.offset, b = row.gain * acc.max + row.offset;
+            stats.min = std::min(a, b);
+            stats.max = std::max(a, b);
+            stats.lineLength = std::fabs(row.gain) * acc.lineLength;
+        }
+    }
+    vector<Accumulator>().swap(e_accumulators);
+}
+
+int EDFEpochTable::channelCount() const { return static_cast<int>(e_rows.size()); }
+
+int EDFEpochTable::epochCount() const { return e_epochs; }
+
+int EDFEpochTable::channel(int r) const { return e_rows[r].channel; }
+
+double EDFEpochTable::epochStart(int epoch) const { return epoch * e_step; }
+
+double EDFEpochTable::epochLength() const { return e_length; }
+
+const EDFEpochStats& EDFEpochTable::at(int r, int epoch) const {
+    return e_stats[static_cast<size_t>(r) * e_epochs + epoch];
+}
+
+const EDFEpochStats* EDFEpochTable::row(int r) const {
+    return e_stats.data() + static_cast<size_t>(r) * e_epochs;
+}
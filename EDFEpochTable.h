@@ -0,0 +1,137 @@
+/**
+ @file EDFEpochTable.h
+ @brief Per-epoch statistics of several channels, filled in one pass.
+ Epochs are fixed length windows laid out from the start of the recording,
+ one every (length - overlap) seconds, with the same sample boundaries
+ extractSignalData would use for each window. Only epochs that end inside
+ the recording are included.
+
+ Samples are fed in record order as raw digital values. Each epoch keeps
+ digital moments, extremes and line length, which are converted to physical
+ units once the pass is finished.
+
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#ifndef _EDFEPOCHTABLE_H
+#define	_EDFEPOCHTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "EDFHeader.h"
+#include "EDFMoments.h"
+
+/**
+ Statistics of one channel over one epoch, in physical units.
+ */
+struct EDFEpochStats {
+    size_t count;      // samples in the epoch
+    double mean;
+    double rms;        // root mean square
+    double variance;   // sample variance
+    double min, max;
+    double lineLength; // sum of absolute differences between consecutive samples
+};
+
+class EDFEpochTable {
+public:
+    /**
+     Lay out the epochs of some channels of a file.
+     @param header Header of the file the samples come from.
+     @param channels Signal indices, one table row each.
+     @param length Epoch length in fractional seconds, greater than zero.
+     @param overlap Seconds shared by consecutive epochs, less than length.
+     */
+    EDFEpochTable(EDFHeader*, const std::vector<int>&, double, double);
+
+    /**
+     Add the next digital samples of a row. Samples of a row must arrive in
+     order and without gaps, starting from the first sample of the recording.
+     @param row Row of the channel the samples belong to.
+     @param vals Digital samples.
+     @param length Length of vals array.
+     */
+    void addDigitalSamples(int, const int16_t*, size_t);
+
+    /**
+     Convert the accumulated values to physical statistics. Call once after
+     the last samples were added and before reading the table.
+     */
+    void finish();
+
+    /**
+     Get the number of channels.
+     @return Number of rows.
+     */
+    int channelCount() const;
+
+    /**
+     Get the number of epochs.
+     @return Number of columns.
+     */
+    int epochCount() const;
+
+    /**
+     Get the signal index of a row.
+     @param row Table row.
+     @return Signal index in the file.
+     */
+    int channel(int) const;
+
+    /**
+     Get the start time of an epoch.
+     @param epoch Table column.
+     @return Start in fractional seconds from the start of the recording.
+     */
+    double epochStart(int) const;
+
+    /**
+     Get the epoch length.
+     @return Length in fractional seconds.
+     */
+    double epochLength() const;
+
+    /**
+     Get the statistics of one channel in one epoch. An epoch without samples
+     has a count and statistics of zero.
+     @param row Table row.
+     @param epoch Table column.
+     @return Statistics in physical units.
+     */
+    const EDFEpochStats& at(int, int) const;
+
+    /**
+     Get all epochs of one channel.
+     @param row Table row.
+     @return epochCount() consecutive statistics.
+     */
+    const EDFEpochStats* row(int) const;
+
+private:
+    /* Running digital values of one cell */
+    struct Accumulator {
+        EDFMoments moments;
+        int16_t min, max;
+        long long lineLength;
+    };
+
+    /* Sample boundaries and feed position of one row */
+    struct Row {
+        int channel;
+        double gain, offset;
+        std::vector<long long> begin, end; // sample index range of each epoch
+        long long next;                    // index of the next sample to arrive
+        int firstOpen;                     // first epoch not yet complete
+        int16_t previous;                  // last sample added
+    };
+
+    double e_length, e_step;
+    int e_epochs;
+    std::vector<Row> e_rows;
+    std::vector<Accumulator> e_accumulators; // row major, released by finish
+    std::vector<EDFEpochStats> e_stats;      // row major
+};
+
+#endif	/* _EDFEPOCHTABLE_H */
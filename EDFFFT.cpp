@@ -0,0 +1,87 @@
+/**
+ @file EDFFFT.cpp
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#include "EDFFFT.h"
+#include <cmath>
+
+using std::complex;
+
+const double PI = 3.14159265358979323846;
+
+EDFFFT::EDFFFT(int size)
+    : f_size(roundUp(size))
+{
+    int half = f_size / 2;
+
+    int bits = 0;
+    while ((1 << bits) < half)
+        bits++;
+    f_bitReverse.resize(half);
+    for (int j = 0; j < half; j++) {
+        int r = 0;
+        for (int b = 0; b < bits; b++)
+            r |= ((j >> b) & 1) << (bits - 1 - b);
+        f_bitReverse[j] = r;
+    }
+
+    f_twiddle.resize(half / 2 > 0 ? half / 2 : 1);
+    for (int j = 0; j < half / 2; j++)
+        f_twiddle[j] = std::polar(1.0, -2 * PI * j / half);
+
+    f_split.resize(half + 1);
+    for (int k = 0; k <= half; k++)
+        f_split[k] = std::polar(1.0, -2 * PI * k / f_size);
+
+    f_scratch.resize(half);
+    f_spectrum.resize(half + 1);
+}
+
+int EDFFFT::size() const { return f_size; }
+
+int EDFFFT::bins() const { return f_size / 2 + 1; }
+
+void EDFFFT::forward(const double* in, complex<double>* out) {
+    int half = f_size / 2;
+    complex<double>* z = f_scratch.data();
+
+    // pack even and odd values as one complex sequence, in bit reversed order
+    for (int j = 0; j < half; j++)
+        z[f_bitReverse[j]] = complex<double>(in[2 * j], in[2 * j + 1]);
+
+    // iterative radix-2 butterflies
+    for (int span = 1; span < half; span *= 2) {
+        int stride = half / (2 * span);
+        for (int first = 0; first < half; first += 2 * span) {
+            for (int j = 0; j < span; j++) {
+                complex<double> t = f_twiddle[j * stride] * z[first + j + span];
+                z[first + j + span] = z[first + j] - t;
+                z[first + j] += t;
+            }
+        }
+    }
+
+    // split into the transforms of the even and odd values and recombine
+    for (int k = 0; k <= half; k++) {
+        complex<double> a = z[k % half];
+        complex<double> b = std::conj(z[(half - k) % half]);
+        complex<double> even = 0.5 * (a + b);
+        complex<double> odd = complex<double>(0, -0.5) * (a - b);
+        out[k] = even + f_split[k] * odd;
+    }
+}
+
+void EDFFFT::power(const double* in, double* out) {
+    forward(in, f_spectrum.data());
+    for (int k = 0; k < bins(); k++)
+        out[k] = std::norm(f_spectrum[k]);
+}
+
+int EDFFFT::roundUp(int count) {
+    int n = 2;
+    while (n < count)
+        n *= 2;
+    return n;
+}
@@ -0,0 +1,70 @@
+/**
+ @file EDFFFT.h
+ @brief Real-input fast Fourier transform plan.
+ A plan fixes the transform size and holds its bit reversal table, twiddle
+ factors and scratch space, so repeated transforms of the same size allocate
+ nothing. A real sequence of n values is transformed as a complex sequence of
+ n / 2 values and then split into the n / 2 + 1 non-negative frequency bins.
+
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#ifndef _EDFFFT_H
+#define	_EDFFFT_H
+
+#include <complex>
+#include <vector>
+
+class EDFFFT {
+public:
+    /**
+     Build a plan.
+     @param size Number of real input values. Rounded up to a power of two, at least 2.
+     */
+    EDFFFT(int);
+
+    /**
+     Get the transform size.
+     @return Number of real input values.
+     */
+    int size() const;
+
+    /**
+     Get the number of output bins.
+     @return size() / 2 + 1.
+     */
+    int bins() const;
+
+    /**
+     Transform real values. Not thread safe, a plan's scratch space is shared
+     by its calls; use one plan per thread.
+     @param in size() real values.
+     @param out bins() complex values, bin k at k / size() cycles per sample.
+     */
+    void forward(const double*, std::complex<double>*);
+
+    /**
+     Transform real values and keep only the squared magnitudes.
+     @param in size() real values.
+     @param out bins() values of |X[k]|^2.
+     */
+    void power(const double*, double*);
+
+    /**
+     Get the smallest power of two not less than a count.
+     @param count Value to round.
+     @return Power of two, at least 2.
+     */
+    static int roundUp(int);
+
+private:
+    int f_size;
+    std::vector<int> f_bitReverse;                   // of the half size complex transform
+    std::vector<std::complex<double> > f_twiddle;    // e^(-2 pi i j / (size / 2))
+    std::vector<std::complex<double> > f_split;      // e^(-2 pi i k / size)
+    std::vector<std::complex<double> > f_scratch;
+    std::vector<std::complex<double> > f_spectrum;   // used by power
+};
+
+#endif	/* _EDFFFT_H */
@@ -5,21 +5,108 @@
 */
 
 #include "EDFFile.h"
+#include "EDFBatchReader.h"
+#include "EDFContainer.h"
+#include "EDFDecode.h"
+#include "EDFDiagnostics.h"
+#include "EDFPrefetchReader.h"
 #include "EDFUtil.h"
-#include <iostream>
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstring>
+#include <functional>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+#ifdef EDFLIB_HAVE_INOTIFY
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
 
 using std::fstream;
 using std::string;
 using std::vector;
-using std::cerr;
-using std::endl;
+
+/* Tracks which samples of one channel each data record contributes to a window of time */
+class SignalWindow {
+public:
+    SignalWindow(EDFHeader*, int, double, double);
+    
+    bool valid() const { return inRange; }
+    int count() const;
+    int take(int, int&);
+    
+    int startRecord, endRecord; // record index range covering the requested time
+    int signal;
+    double freq;
+    int startInRecordBuffer, endInRecordBuffer;
+    
+private:
+    EDFHeader* header;
+    double startTime;
+    int numberOfSamples;
+    bool inRange;
+};
+
+/* Decodes one channel out of consecutive data records into an EDFSignalData */
+class SignalDecoder : public SignalWindow {
+public:
+    SignalDecoder(EDFHeader*, int, double, double, EDFFilterChain* = nullptr);
+    ~SignalDecoder();
+    
+    void decode(const char*, int);
+    EDFSignalData* release();
+    
+private:
+    EDFSignalData* data;
+    EDFFilterChain* filter;
+    double gain;
+    double offset;
+    std::vector<double> converted;
+};
+
+/* Decodes one channel out of consecutive data records into an EDFSignalSamples */
+template <typename T>
+class SampleDecoder : public SignalWindow {
+public:
+    SampleDecoder(EDFHeader*, int, double, double, EDFFilterChain* = nullptr);
+    ~SampleDecoder();
+    
+    void decode(const char*, int);
+    EDFSignalSamples<T>* release();
+    
+private:
+    EDFSignalSamples<T>* data;
+    EDFFilterChain* filter;
+    std::vector<int16_t> digital;
+    std::vector<double> physical;    // filtered samples
+};
 
 /* Parsing operations prototypes */
-EDFHeader* parseHeader(std::fstream&);
-std::vector<EDFAnnotation>* parseAnnotations(std::fstream&, EDFHeader*);
+EDFHeader* parseHeader(std::istream&, bool = true);
+std::vector<EDFAnnotation>* parseAnnotations(std::fstream&, EDFHeader*, size_t, EDFInstrument* = nullptr,
+                                             EDFContainerReader* = nullptr);
+bool appendAnnotations(std::fstream&, EDFHeader*, size_t, int, int, std::vector<EDFAnnotation>*, EDFInstrument* = nullptr,
+                       EDFContainerReader* = nullptr);
 EDFSignalData* parseSignal(std::fstream&, EDFHeader*, int);
-EDFSignalData* parseSignal(std::fstream&, EDFHeader*, int, double, double);
+EDFSignalData* parseSignal(std::fstream&, EDFHeader*, int, double, double, size_t,
+                           EDFPrefetchReader* = nullptr, EDFInstrument* = nullptr, EDFFilterChain* = nullptr,
+                           EDFArena* = nullptr, EDFContainerReader* = nullptr);
+template <typename T>
+EDFSignalSamples<T>* parseSamples(std::fstream&, EDFHeader*, int, double, double, size_t,
+                                  EDFPrefetchReader* = nullptr, EDFInstrument* = nullptr, EDFFilterChain* = nullptr,
+                                  EDFArena* = nullptr, EDFContainerReader* = nullptr);
+int recordsPerSpan(EDFHeader*, size_t, int);
+void releaseSlab(char*, EDFArena*, size_t);
+template <typename Decode>
+bool readRecords(std::fstream&, EDFHeader*, int, int, size_t, EDFPrefetchReader*, EDFContainerReader*, const int*, size_t,
+                 EDFInstrument*, EDFArena*, const Decode&);
+template <typename Consume>
+bool streamSamples(std::fstream&, EDFHeader*, int, double, double, size_t, EDFPrefetchReader*, EDFContainerReader*,
+                   EDFInstrument*, EDFArena*, const Consume&);
+template <typename S, typename T>
+void storeSamples(const S*, int, double, double, T*, size_t);
 
 bool validOnset(string&);
 bool validDuration(string&);
@@ -29,38 +116,77 @@ void parsePatientInfo(const string&, EDFHeader*);
 void parseFileType(const string&, EDFHeader*);
 void parseStdRecordInfo(const string&, EDFHeader*);
 void parsePlusRecordInfo(const string&, EDFHeader*);
-bool parseSignalHeaders(std::fstream&, EDFHeader*);
-bool validFileLength(std::fstream&, EDFHeader*, int);
+bool parseSignalHeaders(std::istream&, EDFHeader*);
+bool validFileLength(std::istream&, EDFHeader*, int);
 string parseOnset(char* const &, int&, int);
 string parseDuration(char* const &, int&, int);
 string parseAnnotation(char* const &, int&);
 
 /* EDFFile class */
 
-EDFFile::EDFFile(const char* path)
+EDFFile::EDFFile(const char* path, EDFTracer* tracer)
     : fileHeader(nullptr)
     , annotation(nullptr)
+    , prefetcher(nullptr)
+    , batchReader(nullptr)
+    , container(nullptr)
+    , readSpan(4 << 20)
+    , arena(&ownArena)
+    , watchDescriptor(-1)
+    , pollInterval(20)
 {
+    resetStats();
+    instrument.tracer = tracer;
+    EDF_SPAN(&instrument, "open");
+    
     filePath = string(path);
     fileStream.open(path, std::ios::in | std::ios::binary);
     if (!fileStream.is_open() || fileStream.fail())
-        cerr << "EDFFile: File '" << filePath << "' does not exist or cannot be read." << endl;
-    
-    fileHeader = parseHeader(fileStream);
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::FILE_ACCESS,
+                               "EDFFile: File '" + filePath + "' does not exist or cannot be read.");
+    
+    // compressed containers carry the header as is and are checked against their block index
+    if (EDFContainerReader::detect(fileStream)) {
+        container = new EDFContainerReader(filePath);
+        std::istringstream headerStream(container->headerBytes());
+        if (container->valid())
+            fileHeader = parseHeader(headerStream, false);
+    } else {
+        fileHeader = parseHeader(fileStream);
+    }
     if (fileHeader != nullptr && fileHeader->hasAnnotations())
-        annotation = parseAnnotations(fileStream, fileHeader);
+        annotation = parseAnnotations(fileStream, fileHeader, readSpan, &instrument, container);
+    
+    if (fileHeader != nullptr) {
+        filters.assign(fileHeader->signalCount(), nullptr);
+        range_loop(sig, 0, fileHeader->signalCount(), 1)
+            if (sig != fileHeader->annotationIndex())
+                dataSignals.push_back(sig);
+    }
 }
 
 EDFFile::~EDFFile() {
+    delete batchReader;
+    delete prefetcher;
+    delete container;
     delete annotation;
     delete fileHeader;
     fileStream.close();
+    if (watchDescriptor >= 0)
+        close(watchDescriptor);
 }
 
 EDFHeader* EDFFile::header() const { return fileHeader; }
 
 vector<EDFAnnotation>* EDFFile::annotations() const { return annotation; }
 
+vector<EDFAnnotation> EDFFile::takeAnnotations() {
+    vector<EDFAnnotation> taken;
+    if (annotation != nullptr)
+        taken.swap(*annotation);
+    return taken;
+}
+
 EDFSignalData* EDFFile::extractSignalData(int channel, double start, double length) {
     if (channel == fileHeader->annotationIndex() || !fileHeader->signalAvailable(channel))
         return nullptr;
@@ -69,13 +195,703 @@ EDFSignalData* EDFFile::extractSignalData(int channel, double start, double leng
     if (start + length > fileHeader->recordingTime())
         length = fileHeader->recordingTime() - start;
 
-    return parseSignal(fileStream, fileHeader, channel, start, length);
+    EDF_SPAN(&instrument, "extract");
+    return parseSignal(fileStream, fileHeader, channel, start, length, readSpan, prefetcher, &instrument, filters[channel],
+                       arena, container);
+}
+
+template <typename T>
+EDFSignalSamples<T>* EDFFile::extractSamples(int channel, double start, double length) {
+    if (channel == fileHeader->annotationIndex() || !fileHeader->signalAvailable(channel))
+        return nullptr;
+    
+    // fix length arg if it goes beyond end of recording length
+    if (start + length > fileHeader->recordingTime())
+        length = fileHeader->recordingTime() - start;
+    
+    EDF_SPAN(&instrument, "extract");
+    return parseSamples<T>(fileStream, fileHeader, channel, start, length, readSpan, prefetcher, &instrument, filters[channel],
+                           arena, container);
+}
+
+template EDFSignalSamples<int16_t>* EDFFile::extractSamples(int, double, double);
+template EDFSignalSamples<float>* EDFFile::extractSamples(int, double, double);
+template EDFSignalSamples<double>* EDFFile::extractSamples(int, double, double);
+
+std::unique_ptr<EDFSignalData> EDFFile::signalData(int channel, double start, double length) {
+    return std::unique_ptr<EDFSignalData>(extractSignalData(channel, start, length));
+}
+
+template <typename T>
+std::unique_ptr<EDFSignalSamples<T> > EDFFile::signalSamples(int channel, double start, double length) {
+    return std::unique_ptr<EDFSignalSamples<T> >(extractSamples<T>(channel, start, length));
+}
+
+template std::unique_ptr<EDFSignalSamples<int16_t> > EDFFile::signalSamples(int, double, double);
+template std::unique_ptr<EDFSignalSamples<float> > EDFFile::signalSamples(int, double, double);
+template std::unique_ptr<EDFSignalSamples<double> > EDFFile::signalSamples(int, double, double);
+
+vector<EDFSignalData*> EDFFile::extractSignalWindows(int channel, const vector<EDFWindow>& windows) {
+    vector<EDFSignalData*> results(windows.size(), nullptr);
+    if (channel == fileHeader->annotationIndex() || !fileHeader->signalAvailable(channel))
+        return results;
+    
+    EDF_SPAN(&instrument, "windows");
+    
+    // build a decoder per window, each knows the record range it needs
+    vector<SignalDecoder*> decoders(windows.size(), nullptr);
+    vector<size_t> order;
+    range_loop(w, static_cast<size_t>(0), windows.size(), 1) {
+        double start = windows[w].start;
+        double length = windows[w].length;
+        if (start + length > fileHeader->recordingTime())
+            length = fileHeader->recordingTime() - start;
+        
+        decoders[w] = new SignalDecoder(fileHeader, channel, start, length);
+        if (!decoders[w]->valid())
+            continue;
+        EDF_COUNT(&instrument, allocations, 1);
+        if (decoders[w]->startRecord >= decoders[w]->endRecord) {
+            results[w] = decoders[w]->release(); // nothing to read, empty signal
+            continue;
+        }
+        order.push_back(w);
+    }
+    
+    // coalesce overlapping and adjacent record ranges into single reads
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return decoders[a]->startRecord < decoders[b]->startRecord;
+    });
+    
+    vector<int> spanStart, spanEnd;
+    vector<vector<size_t> > spanWindows;
+    for (size_t w : order) {
+        if (spanStart.empty() || decoders[w]->startRecord > spanEnd.back()) {
+            spanStart.push_back(decoders[w]->startRecord);
+            spanEnd.push_back(decoders[w]->endRecord);
+            spanWindows.push_back(vector<size_t>());
+        } else {
+            spanEnd.back() = std::max(spanEnd.back(), decoders[w]->endRecord);
+        }
+        spanWindows.back().push_back(w);
+    }
+    
+    // containers decompress blocks in file order, each span feeding the windows it covers
+    if (container != nullptr) {
+        range_loop(s, static_cast<size_t>(0), spanStart.size(), 1) {
+            auto decode = [&](const char* record, int recordNum) {
+                EDF_TIMER(&instrument, decodeSeconds);
+                for (size_t w : spanWindows[s])
+                    if (recordNum >= decoders[w]->startRecord && recordNum < decoders[w]->endRecord)
+                        decoders[w]->decode(record, recordNum);
+            };
+            if (!readRecords(fileStream, fileHeader, spanStart[s], spanEnd[s], readSpan, nullptr, container,
+                             &channel, 1, &instrument, arena, decode))
+                continue;
+            for (size_t w : spanWindows[s])
+                results[w] = decoders[w]->release();
+        }
+        for (auto decoder : decoders)
+            delete decoder;
+        return results;
+    }
+    
+    if (batchReader == nullptr)
+        batchReader = new EDFBatchReader(filePath);
+    
+    int recordSize = fileHeader->dataRecordSize();
+    long long dataOffset = fileHeader->signalCount() * 256 + 256;
+    vector<vector<char> > buffers(spanStart.size());
+    vector<EDFReadRequest> requests(spanStart.size());
+    range_loop(s, static_cast<size_t>(0), spanStart.size(), 1) {
+        buffers[s].resize(static_cast<size_t>(spanEnd[s] - spanStart[s]) * recordSize);
+        requests[s].offset = dataOffset + static_cast<long long>(spanStart[s]) * recordSize;
+        requests[s].length = buffers[s].size();
+        requests[s].buffer = buffers[s].data();
+        EDF_COUNT(&instrument, allocations, 1);
+    }
+    
+    // decode every window in a span as soon as its read completes
+    batchReader->read(requests, [&](size_t s, bool ok) {
+        if (!ok) {
+            EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::RECORD_READ,
+                                   "Error reading signal records from file. Giving up...");
+            return;
+        }
+        EDF_COUNT(&instrument, readCalls, 1);
+        EDF_COUNT(&instrument, bytesRead, requests[s].length);
+        EDF_COUNT(&instrument, recordsRead, spanEnd[s] - spanStart[s]);
+        EDF_COUNT(&instrument, cacheHits, spanWindows[s].size() - 1); // windows sharing the read
+        for (size_t w : spanWindows[s]) {
+            SignalDecoder* decoder = decoders[w];
+            {
+                EDF_TIMER(&instrument, decodeSeconds);
+                range_loop(recordNum, decoder->startRecord, decoder->endRecord, 1)
+                    decoder->decode(buffers[s].data() + static_cast<size_t>(recordNum - spanStart[s]) * recordSize, recordNum);
+            }
+            results[w] = decoder->release();
+        }
+        vector<char>().swap(buffers[s]);
+    });
+    
+    for (auto decoder : decoders)
+        delete decoder;
+    
+    return results;
+}
+
+EDFEpochTable* EDFFile::epochStatistics(double length, double overlap, const vector<int>& channels) {
+    if (!(length > 0) || overlap < 0 || overlap >= length) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::WINDOW_RANGE,
+                               "Epoch length must be positive and longer than the overlap. Giving up...");
+        return nullptr;
+    }
+    
+    vector<int> signals(channels);
+    if (signals.empty()) {
+        range_loop(s, 0, fileHeader->signalCount(), 1)
+            if (s != fileHeader->annotationIndex())
+                signals.push_back(s);
+    }
+    for (int s : signals) {
+        if (s == fileHeader->annotationIndex() || !fileHeader->signalAvailable(s)) {
+            EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::CHANNEL_INDEX,
+                                   "Epoch statistics requested for a channel without signal data. Giving up...");
+            return nullptr;
+        }
+    }
+    
+    EDF_SPAN(&instrument, "epochs");
+    EDFEpochTable* table = new EDFEpochTable(fileHeader, signals, length, overlap);
+    EDF_COUNT(&instrument, allocations, 1);
+    
+    // only the records up to the end of the last epoch are needed
+    int endRecord = 0;
+    if (table->epochCount() > 0) {
+        double end = table->epochStart(table->epochCount() - 1) + length;
+        endRecord = std::min(fileHeader->dataRecordCount(),
+                             static_cast<int>(ceil(end / fileHeader->dataRecordDuration() - 1e-9)));
+    }
+    
+    int widest = 0;
+    for (int s : signals)
+        widest = std::max(widest, fileHeader->signalSampleCount(s));
+    vector<int16_t> digital(widest);
+    
+    auto decode = [&](const char* record, int) {
+        EDF_TIMER(&instrument, decodeSeconds);
+        range_loop(r, static_cast<size_t>(0), signals.size(), 1) {
+            int s = signals[r];
+            decodeSamples(record + fileHeader->bufferOffset(s), digital.data(), fileHeader->signalSampleCount(s));
+            table->addDigitalSamples(static_cast<int>(r), digital.data(), fileHeader->signalSampleCount(s));
+        }
+    };
+    if (endRecord > 0 && !readRecords(fileStream, fileHeader, 0, endRecord, readSpan, prefetcher, container,
+                                      signals.data(), signals.size(), &instrument, arena, decode)) {
+        delete table;
+        return nullptr;
+    }
+    
+    table->finish();
+    return table;
+}
+
+bool EDFFile::sketchSignal(int channel, double start, double length, EDFHistogram* histogram, EDFQuantileSketch* quantiles) {
+    if (channel == fileHeader->annotationIndex() || !fileHeader->signalAvailable(channel))
+        return false;
+    
+    // fix length arg if it goes beyond end of recording length
+    if (start + length > fileHeader->recordingTime())
+        length = fileHeader->recordingTime() - start;
+    
+    EDF_SPAN(&instrument, "sketch");
+    double gain = fileHeader->gain(channel), offset = fileHeader->offset(channel);
+    EDFArenaScope scope(arena);
+    double* physical = arena->allocate<double>(quantiles != nullptr ? fileHeader->signalSampleCount(channel) : 0);
+    
+    auto consume = [&](const int16_t* digital, int count) {
+        if (histogram != nullptr)
+            histogram->add(digital, count);
+        if (quantiles != nullptr) {
+            range_loop(i, 0, count, 1)
+                physical[i] = gain * digital[i] + offset;
+            quantiles->add(physical, count);
+        }
+    };
+    return streamSamples(fileStream, fileHeader, channel, start, length, readSpan, prefetcher, container, &instrument,
+                         arena, consume);
+}
+
+bool EDFFile::spectrum(int channel, double start, double length, EDFWelch* welch) {
+    if (channel == fileHeader->annotationIndex() || !fileHeader->signalAvailable(channel))
+        return false;
+    
+    // fix length arg if it goes beyond end of recording length
+    if (start + length > fileHeader->recordingTime())
+        length = fileHeader->recordingTime() - start;
+    
+    EDF_SPAN(&instrument, "spectrum");
+    double gain = fileHeader->gain(channel), offset = fileHeader->offset(channel);
+    EDFArenaScope scope(arena);
+    double* physical = arena->allocate<double>(fileHeader->signalSampleCount(channel));
+    
+    auto consume = [&](const int16_t* digital, int count) {
+        range_loop(i, 0, count, 1)
+            physical[i] = gain * digital[i] + offset;
+        welch->add(physical, count);
+    };
+    return streamSamples(fileStream, fileHeader, channel, start, length, readSpan, prefetcher, container, &instrument,
+                         arena, consume);
+}
+
+EDFMatrix* EDFFile::extractResampled(const vector<int>& channels, double start, double length, double rate, int quality) {
+    if (!(rate > 0)) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::VALUE_RANGE,
+                               "Resampling rate must be positive. Giving up...");
+        return nullptr;
+    }
+    
+    vector<int> signals(channels);
+    if (signals.empty()) {
+        range_loop(s, 0, fileHeader->signalCount(), 1)
+            if (s != fileHeader->annotationIndex())
+                signals.push_back(s);
+    }
+    for (int s : signals) {
+        if (s == fileHeader->annotationIndex() || !fileHeader->signalAvailable(s)) {
+            EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::CHANNEL_INDEX,
+                                   "Resampling requested for a channel without signal data. Giving up...");
+            return nullptr;
+        }
+    }
+    
+    // fix length arg if it goes beyond end of recording length
+    if (start + length > fileHeader->recordingTime())
+        length = fileHeader->recordingTime() - start;
+    
+    EDF_SPAN(&instrument, "resample");
+    size_t count = static_cast<size_t>(floor(std::max(length, 0.0) * rate + 1e-9));
+    
+    // one window and resampler per channel, offset by where the window starts inside its first sample
+    vector<SignalWindow> windows;
+    vector<EDFResampler> resamplers;
+    int startRecord = fileHeader->dataRecordCount(), endRecord = 0, widest = 0;
+    for (int s : signals) {
+        windows.push_back(SignalWindow(fileHeader, s, start, length));
+        if (!windows.back().valid())
+            return nullptr;
+        // samples per record on both sides, so slow signals keep their exact ratio instead of a rounded rate
+        double first = start * windows.back().freq;
+        double perRecord = fileHeader->dataRecordDuration();
+        resamplers.push_back(EDFResampler(fileHeader->signalSampleCount(s), rate * perRecord, first - floor(first), quality));
+        startRecord = std::min(startRecord, windows.back().startRecord);
+        endRecord = std::max(endRecord, windows.back().endRecord);
+        widest = std::max(widest, fileHeader->signalSampleCount(s));
+    }
+    
+    vector<vector<double> > outputs(signals.size());
+    for (auto& output : outputs)
+        output.reserve(count + 1);
+    vector<int16_t> digital(widest);
+    vector<double> physical(widest);
+    
+    auto decode = [&](const char* record, int recordNum) {
+        EDF_TIMER(&instrument, decodeSeconds);
+        range_loop(r, static_cast<size_t>(0), signals.size(), 1) {
+            SignalWindow& window = windows[r];
+            if (recordNum < window.startRecord || recordNum >= window.endRecord)
+                continue;
+            int first;
+            int end = window.take(recordNum, first);
+            if (end <= first)
+                continue;
+            
+            int s = signals[r];
+            decodeSamples(record + window.startInRecordBuffer + 2 * first, digital.data(), end - first);
+            
+            double gain = fileHeader->gain(s), offset = fileHeader->offset(s);
+            range_loop(i, 0, end - first, 1)
+                physical[i] = gain * digital[i] + offset;
+            resamplers[r].process(physical.data(), end - first, outputs[r]);
+        }
+    };
+    if (startRecord < endRecord && !readRecords(fileStream, fileHeader, startRecord, endRecord, readSpan, prefetcher, container,
+                                                signals.data(), signals.size(), &instrument, arena, decode))
+        return nullptr;
+    
+    vector<string> labels;
+    for (int s : signals)
+        labels.push_back(fileHeader->label(s));
+    EDFMatrix* matrix = new EDFMatrix(signals, count, rate, start, labels);
+    EDF_COUNT(&instrument, allocations, 1);
+    range_loop(r, static_cast<size_t>(0), signals.size(), 1) {
+        resamplers[r].flush(count, outputs[r]);
+        std::copy(outputs[r].begin(), outputs[r].begin() + count, matrix->row(static_cast<int>(r)));
+    }
+    return matrix;
+}
+
+EDFMatrix* EDFFile::extractMontage(const EDFMontage& montage, double start, double length) {
+    // distinct source signals, with each derivation's terms pointing into them
+    vector<int> signals;
+    vector<vector<std::pair<int, double> > > terms(montage.size());
+    vector<double> bias(montage.size(), 0);
+    range_loop(d, 0, montage.size(), 1) {
+        for (const EDFMontageTerm& term : montage.terms(d)) {
+            int s = EDFMontage::findSignal(fileHeader, term.label);
+            if (s < 0 || !fileHeader->signalAvailable(s)) {
+                EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::CHANNEL_INDEX,
+                                       "Montage label '" + term.label + "' matches no signal. Giving up...");
+                return nullptr;
+            }
+            if (!signals.empty() && fileHeader->signalSampleCount(s) != fileHeader->signalSampleCount(signals[0])) {
+                EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::VALUE_RANGE,
+                                       "Montage channels differ in sample rate. Giving up...");
+                return nullptr;
+            }
+            int source = static_cast<int>(std::find(signals.begin(), signals.end(), s) - signals.begin());
+            if (source == static_cast<int>(signals.size()))
+                signals.push_back(s);
+    
+            // gain folds into the weight and offset into a constant per derivation
+            terms[d].push_back(std::make_pair(source, term.weight * fileHeader->gain(s)));
+            bias[d] += term.weight * fileHeader->offset(s);
+        }
+    }
+    if (signals.empty()) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::CHANNEL_INDEX,
+                               "Montage uses no channels. Giving up...");
+        return nullptr;
+    }
+    
+    // fix length arg if it goes beyond end of recording length
+    if (start + length > fileHeader->recordingTime())
+        length = fileHeader->recordingTime() - start;
+    
+    EDF_SPAN(&instrument, "montage");
+    // every source shares one layout, so one window serves them all
+    SignalWindow window(fileHeader, signals[0], start, length);
+    if (!window.valid())
+        return nullptr;
+    
+    int samplesPerRecord = fileHeader->signalSampleCount(signals[0]);
+    vector<vector<double> > outputs(montage.size());
+    for (auto& output : outputs)
+        output.reserve(static_cast<size_t>(std::max(length, 0.0) * window.freq) + 1);
+    vector<int16_t> digital(signals.size() * samplesPerRecord);
+    
+    auto decode = [&](const char* record, int recordNum) {
+        EDF_TIMER(&instrument, decodeSeconds);
+        int first;
+        int end = window.take(recordNum, first);
+        int count = end - first;
+        if (count <= 0)
+            return;
+    
+        range_loop(k, static_cast<size_t>(0), signals.size(), 1) {
+            int s = signals[k];
+            decodeSamples(record + fileHeader->bufferOffset(s) + 2 * first, digital.data() + k * samplesPerRecord, count);
+        }
+    
+        // each derived sample is its constant plus the weighted digital sources
+        range_loop(d, static_cast<size_t>(0), outputs.size(), 1) {
+            vector<double>& output = outputs[d];
+            size_t at = output.size();
+            output.resize(at + count, bias[d]);
+            double* y = output.data() + at;
+            for (const auto& term : terms[d]) {
+                const int16_t* x = digital.data() + term.first * samplesPerRecord;
+                double weight = term.second;
+                range_loop(i, 0, count, 1)
+                    y[i] += weight * x[i];
+            }
+        }
+    };
+    if (window.startRecord < window.endRecord &&
+        !readRecords(fileStream, fileHeader, window.startRecord, window.endRecord, readSpan, prefetcher, container,
+                     signals.data(), signals.size(), &instrument, arena, decode))
+        return nullptr;
+    
+    vector<string> names;
+    range_loop(d, 0, montage.size(), 1)
+        names.push_back(montage.name(d));
+    size_t count = outputs[0].size();
+    double first = floor(start * window.freq) / window.freq; // time of the first whole sample
+    EDFMatrix* matrix = new EDFMatrix(vector<int>(montage.size(), -1), count, window.freq, first, names);
+    EDF_COUNT(&instrument, allocations, 1);
+    range_loop(d, static_cast<size_t>(0), outputs.size(), 1)
+        std::copy(outputs[d].begin(), outputs[d].end(), matrix->row(static_cast<int>(d)));
+    return matrix;
+}
+
+size_t EDFFile::sampleCount(int channel, double start, double length) {
+    if (channel == fileHeader->annotationIndex() || !fileHeader->signalAvailable(channel))
+        return 0;
+    
+    // fix length arg if it goes beyond end of recording length
+    if (start + length > fileHeader->recordingTime())
+        length = fileHeader->recordingTime() - start;
+    
+    SignalWindow window(fileHeader, channel, start, length);
+    return window.valid() ? static_cast<size_t>(window.count()) : 0;
+}
+
+template <typename T>
+bool EDFFile::extractMatrix(const vector<int>& channels, double start, double length, T* buffer, EDFLayout layout, size_t stride) {
+    const vector<int>& signals = channels.empty() ? dataSignals : channels;
+    for (int s : signals) {
+        if (s == fileHeader->annotationIndex() || !fileHeader->signalAvailable(s)) {
+            EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::CHANNEL_INDEX,
+                                   "Matrix requested for a channel without signal data. Giving up...");
+            return false;
+        }
+        if (fileHeader->signalSampleCount(s) != fileHeader->signalSampleCount(signals[0])) {
+            EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::VALUE_RANGE,
+                                   "Matrix channels differ in sample rate. Giving up...");
+            return false;
+        }
+    }
+    if (signals.empty())
+        return true;
+    
+    // fix length arg if it goes beyond end of recording length
+    if (start + length > fileHeader->recordingTime())
+        length = fileHeader->recordingTime() - start;
+    
+    EDF_SPAN(&instrument, "matrix");
+    // every channel shares one layout, so one window serves them all
+    SignalWindow window(fileHeader, signals[0], start, length);
+    if (!window.valid())
+        return false;
+    
+    size_t samples = static_cast<size_t>(window.count());
+    size_t row = layout == EDFLayout::CHANNEL_MAJOR ? samples : signals.size();
+    if (stride == 0)
+        stride = row;
+    if (stride < row) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::VALUE_RANGE,
+                               "Matrix stride is shorter than a row. Giving up...");
+        return false;
+    }
+    if (layout == EDFLayout::CHANNEL_MAJOR)
+        return decodeInto(signals.data(), signals.size(), window, buffer, stride, 1);
+    return decodeInto(signals.data(), signals.size(), window, buffer, 1, stride);
+}
+
+template bool EDFFile::extractMatrix(const vector<int>&, double, double, float*, EDFLayout, size_t);
+template bool EDFFile::extractMatrix(const vector<int>&, double, double, double*, EDFLayout, size_t);
+
+template <typename T>
+size_t EDFFile::extractInto(int channel, double start, double length, T* buffer, size_t capacity) {
+    if (channel == fileHeader->annotationIndex() || !fileHeader->signalAvailable(channel))
+        return 0;
+    
+    // fix length arg if it goes beyond end of recording length
+    if (start + length > fileHeader->recordingTime())
+        length = fileHeader->recordingTime() - start;
+    
+    EDF_SPAN(&instrument, "extract");
+    SignalWindow window(fileHeader, channel, start, length);
+    if (!window.valid())
+        return 0;
+    
+    size_t samples = static_cast<size_t>(window.count());
+    if (samples > capacity) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::VALUE_RANGE,
+                               "Buffer is shorter than the extracted window. Giving up...");
+        return 0;
+    }
+    return decodeInto(&channel, 1, window, buffer, 0, 1) ? samples : 0;
+}
+
+template size_t EDFFile::extractInto(int, double, double, float*, size_t);
+template size_t EDFFile::extractInto(int, double, double, double*, size_t);
+
+template <typename T>
+bool EDFFile::decodeInto(const int* signals, size_t channels, SignalWindow& window, T* buffer, size_t channelStep, size_t sampleStep) {
+    // scratch comes from the arena, so steady state extraction stays off the heap
+    EDFArenaScope scope(arena);
+    int samplesPerRecord = fileHeader->signalSampleCount(signals[0]);
+    int16_t* digital = arena->allocate<int16_t>(samplesPerRecord);
+    double* physical = arena->allocate<double>(samplesPerRecord);
+    size_t written = 0;
+    
+    auto decode = [&](const char* record, int recordNum) {
+        EDF_TIMER(&instrument, decodeSeconds);
+        int first;
+        int end = window.take(recordNum, first);
+        int count = end - first;
+        if (count <= 0)
+            return;
+        
+        range_loop(k, static_cast<size_t>(0), channels, 1) {
+            int s = signals[k];
+            decodeSamples(record + fileHeader->bufferOffset(s) + 2 * first, digital, count);
+            
+            T* out = buffer + k * channelStep + written * sampleStep;
+            double gain = fileHeader->gain(s), offset = fileHeader->offset(s);
+            if (filters[s] == nullptr) {
+                storeSamples(digital, count, gain, offset, out, sampleStep);
+                continue;
+            }
+            
+            // filters run on physical values
+            range_loop(i, 0, count, 1)
+                physical[i] = gain * digital[i] + offset;
+            filters[s]->process(physical, count);
+            storeSamples(physical, count, 1.0, 0.0, out, sampleStep);
+        }
+        written += count;
+    };
+    if (window.startRecord < window.endRecord &&
+        !readRecords(fileStream, fileHeader, window.startRecord, window.endRecord, readSpan, prefetcher, container,
+                     signals, channels, &instrument, arena, decode))
+        return false;
+    return true;
+}
+
+bool EDFFile::visitRecords(int startRecord, int endRecord, const EDFRecordVisitor& visitor) {
+    if (fileHeader == nullptr || startRecord < 0 || endRecord > fileHeader->dataRecordCount() || startRecord > endRecord) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::WINDOW_RANGE,
+                               "Record range is outside the recording. Giving up...");
+        return false;
+    }
+    
+    EDF_SPAN(&instrument, "records");
+    return startRecord == endRecord ||
+           readRecords(fileStream, fileHeader, startRecord, endRecord, readSpan, prefetcher, container, nullptr, 0,
+                       &instrument, arena, visitor);
+}
+
+int EDFFile::refresh() {
+    if (fileHeader == nullptr || container != nullptr || fileHeader->dataRecordSize() <= 0)
+        return 0;
+    
+    // whole records now on disk, a torn one at the end waits for the next call
+    fileStream.clear();
+    fileStream.seekg(0, std::ios::end);
+    long long last = fileStream.tellg();
+    long long dataOffset = fileHeader->signalCount() * 256LL + 256;
+    int known = fileHeader->dataRecordCount();
+    if (last < dataOffset || (last - dataOffset) / fileHeader->dataRecordSize() <= known)
+        return 0;
+    int whole = static_cast<int>((last - dataOffset) / fileHeader->dataRecordSize());
+    
+    EDF_SPAN(&instrument, "refresh");
+    if (fileHeader->hasAnnotations()) {
+        if (annotation == nullptr)
+            annotation = new vector<EDFAnnotation>();
+        // a failed read leaves the list as it was, the records are scanned again next time
+        size_t before = annotation->size();
+        if (!appendAnnotations(fileStream, fileHeader, readSpan, known, whole, annotation, &instrument)) {
+            annotation->erase(annotation->begin() + before, annotation->end());
+            return -1;
+        }
+    }
+    fileHeader->setDataRecordCount(whole);
+    
+    for (const EDFRecordsHandler& handler : subscribers)
+        if (handler)
+            handler(known, whole - known);
+    return whole - known;
+}
+
+int EDFFile::follow(int timeout) {
+    int added = refresh();
+    if (added != 0 || fileHeader == nullptr)
+        return added;
+    
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    auto remaining = [&deadline]() {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        return std::max(static_cast<int>(left.count()), 0);
+    };
+    
+#ifdef EDFLIB_HAVE_INOTIFY
+    if (watchDescriptor < 0) {
+        watchDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (watchDescriptor >= 0 && inotify_add_watch(watchDescriptor, filePath.c_str(), IN_MODIFY) < 0) {
+            close(watchDescriptor);
+            watchDescriptor = -1;
+        }
+    }
+    if (watchDescriptor >= 0) {
+        // sleep until the writer touches the file, then drain the events
+        char events[4096];
+        while (remaining() > 0) {
+            pollfd watch = {watchDescriptor, POLLIN, 0};
+            if (poll(&watch, 1, remaining()) <= 0)
+                continue;
+            while (read(watchDescriptor, events, sizeof(events)) > 0) {}
+            if ((added = refresh()) != 0)
+                return added;
+        }
+        return 0;
+    }
+#endif
+    
+    while (remaining() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(std::min(pollInterval, remaining())));
+        if ((added = refresh()) != 0)
+            return added;
+    }
+    return 0;
+}
+
+void EDFFile::setPollInterval(int milliseconds) {
+    pollInterval = std::max(milliseconds, 1);
+}
+
+int EDFFile::subscribe(const EDFRecordsHandler& handler) {
+    subscribers.push_back(handler);
+    return static_cast<int>(subscribers.size()) - 1;
+}
+
+void EDFFile::unsubscribe(int id) {
+    if (id >= 0 && id < static_cast<int>(subscribers.size()))
+        subscribers[id] = nullptr;
+}
+
+EDFStats EDFFile::stats() const { return instrument.stats; }
+
+void EDFFile::resetStats() {
+    instrument.stats = EDFStats();
+}
+
+void EDFFile::setTracer(EDFTracer* tracer) {
+    instrument.tracer = tracer;
+}
+
+void EDFFile::setReadSpan(size_t span) {
+    readSpan = span;
+}
+
+void EDFFile::setFilter(int channel, EDFFilterChain* chain) {
+    if (channel == fileHeader->annotationIndex() || !fileHeader->signalAvailable(channel)) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::CHANNEL_INDEX,
+                               "Filter attached to a channel without signal data. Ignoring...");
+        return;
+    }
+    filters[channel] = chain;
+}
+
+void EDFFile::setArena(EDFArena* scratch) {
+    arena = scratch != nullptr ? scratch : &ownArena;
+}
+
+void EDFFile::setReadAhead(int depth, size_t chunkSize) {
+    delete prefetcher;
+    prefetcher = nullptr;
+    
+    if (depth > 0 && fileHeader != nullptr && container == nullptr)
+        prefetcher = new EDFPrefetchReader(filePath, fileHeader->signalCount() * 256 + 256,
+                                           fileHeader->dataRecordSize(), depth, chunkSize);
 }
 
 
 /* Parsing operations */
 
-EDFHeader* parseHeader(std::fstream &in) {
+EDFHeader* parseHeader(std::istream &in, bool checkLength) {
     EDFHeader* header = new EDFHeader();
     
     // rewind file
@@ -83,7 +899,8 @@ EDFHeader* parseHeader(std::fstream &in) {
     // read first 256 characters of file
     char rootHeaderArray[257] = {0};
     if (in.fail() || !in.get(rootHeaderArray, 257)) {
-        cerr << "Error trying to read header from file. Giving up..." << endl;
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::HEADER_FORMAT,
+                               "Error trying to read header from file. Giving up...");
         return nullptr;
     }
     
@@ -125,9 +942,9 @@ EDFHeader* parseHeader(std::fstream &in) {
     
     // extract file version
     if (versionStr.compare("0       ") != 0)
-        cerr << "Magic number is wrong." << endl <<
-        "All current versions of EDF specifications must" <<
-        " start with '0       ' string. Ignoring..." << endl;
+        EDFDiagnostics::report(EDFSeverity::WARNING, EDFDiagnosticCode::HEADER_FORMAT,
+                               "Magic number is wrong.\nAll current versions of EDF specifications must"
+                               " start with '0       ' string. Ignoring...");
     
     parsePatientInfo(patientStr, header);
     
@@ -157,44 +974,73 @@ EDFHeader* parseHeader(std::fstream &in) {
         return nullptr;
     
     
-    if (!validFileLength(in, header, atoi(recordSizeStr.c_str())))
+    if (checkLength && !validFileLength(in, header, atoi(recordSizeStr.c_str())))
         return nullptr;
     
     return header;
 }
 
-vector<EDFAnnotation>* parseAnnotations(std::fstream& in, EDFHeader* header) {
-    // tal = time-stamped annotations list
-    int annSigIdx = header->annotationIndex();
-    if (annSigIdx < 0)
+vector<EDFAnnotation>* parseAnnotations(std::fstream& in, EDFHeader* header, size_t readSpan, EDFInstrument* instrument,
+                                        EDFContainerReader* container) {
+    if (header->annotationIndex() < 0)
         return nullptr;
     
     vector<EDFAnnotation>* annotations = new vector<EDFAnnotation>();
+    if (!appendAnnotations(in, header, readSpan, 0, header->dataRecordCount(), annotations, instrument, container)) {
+        delete annotations;
+        return nullptr;
+    }
+    return annotations;
+}
+
+bool appendAnnotations(std::fstream& in, EDFHeader* header, size_t readSpan, int startRecord, int endRecord,
+                       vector<EDFAnnotation>* annotations, EDFInstrument* instrument, EDFContainerReader* container) {
+    // tal = time-stamped annotations list
+    int annSigIdx = header->annotationIndex();
+    if (annSigIdx < 0 || startRecord >= endRecord)
+        return true;
+    
+    EDF_TIMED_SPAN(instrument, "annotations", annotationSeconds);
     
-    // seek to beginning of data records
-    in.seekg(header->signalCount() * 256 + 256, std::ios::beg);
+    // seek to the first record to scan
+    int recordSize = header->dataRecordSize();
+    in.clear();
+    in.seekg(header->signalCount() * 256 + 256 + static_cast<long long>(recordSize) * startRecord, std::ios::beg);
     
-    char* record = new char[header->dataRecordSize()];
+    // records are read a slab at a time and scanned in place
+    int spanRecords = recordsPerSpan(header, readSpan, endRecord - startRecord);
+    char* slab = new char[static_cast<size_t>(spanRecords) * recordSize];
+    int slabFirst = startRecord, slabCount = 0;
     int talStart = header->bufferOffset(annSigIdx);
     int talEnd = talStart + header->signalSampleCount(annSigIdx) * 2;
     int talLength = talEnd - talStart;
     char* tal = new char[talLength];
+    EDF_COUNT(instrument, allocations, 3);
     
-    range_loop(recordNum, 0, header->dataRecordCount(), 1) {
+    range_loop(recordNum, startRecord, endRecord, 1) {
         string onset, duration;
         vector<string> annotationStrings;
         int talOffset = 0;
         
-        if(!in.read(record, header->dataRecordSize())) {
-            cerr << "Error reading annotations from file. Giving up..." << endl;
-            delete annotations;
-            delete [] record;
-            delete [] tal;
-            return nullptr;
+        if (recordNum >= slabFirst + slabCount) {
+            slabFirst = recordNum;
+            slabCount = std::min(spanRecords, endRecord - recordNum);
+            bool read = container != nullptr ? container->read(recordNum, recordNum + slabCount, &annSigIdx, 1, slab)
+                                             : static_cast<bool>(in.read(slab, static_cast<std::streamsize>(slabCount) * recordSize));
+            if (!read) {
+                EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::RECORD_READ,
+                                       "Error reading annotations from file. Giving up...");
+                delete [] slab;
+                delete [] tal;
+                return false;
+            }
+            EDF_COUNT(instrument, readCalls, 1);
+            EDF_COUNT(instrument, bytesRead, static_cast<unsigned long long>(slabCount) * recordSize);
+            EDF_COUNT(instrument, recordsRead, slabCount);
         }
         
         // and extract TAL section
-        memcpy(tal, record + talStart, talLength);
+        memcpy(tal, slab + static_cast<size_t>(recordNum - slabFirst) * recordSize + talStart, talLength);
         
         while (talOffset < talLength) {
             // find length of onset by checking for 20 or 21
@@ -222,14 +1068,14 @@ vector<EDFAnnotation>* parseAnnotations(std::fstream& in, EDFHeader* header) {
         }
         
         if (annotationStrings.size() > 0) // avoid storing empty objects
-            annotations->push_back(EDFAnnotation(atof(onset.c_str()), atof(duration.c_str()), annotationStrings));
+            annotations->push_back(EDFAnnotation(atof(onset.c_str()), atof(duration.c_str()), std::move(annotationStrings)));
         
     }
     
     delete [] tal;
-    delete [] record;
+    delete [] slab;
     
-    return annotations;
+    return true;
 }
 
 string parseOnset(char* const &tal, int &talOffset, int onsetLength) {
@@ -237,7 +1083,8 @@ string parseOnset(char* const &tal, int &talOffset, int onsetLength) {
     string onset = string(tal, talOffset, onsetLength);
     talOffset += onsetLength;
     if (!validOnset(onset)) {
-        cerr << "TAL onset has bad format. Skipping..." << endl;
+        EDFDiagnostics::report(EDFSeverity::WARNING, EDFDiagnosticCode::ANNOTATION_FORMAT,
+                               "TAL onset has bad format. Skipping...");
         // TODO: need to write code to skip this TAL
         // not sure if anything needs to happen
     }
@@ -255,7 +1102,8 @@ string parseDuration(char* const &tal, int &talOffset, int onsetLength) {
     string duration = string(tal, talOffset, durationLength);
     talOffset += durationLength;
     if (!validDuration(duration)) {
-        cerr << "TAL duration has bad format. Skipping..." << endl;
+        EDFDiagnostics::report(EDFSeverity::WARNING, EDFDiagnosticCode::ANNOTATION_FORMAT,
+                               "TAL duration has bad format. Skipping...");
         // TODO: need to write code to skip this TAL
         // not sure if anything needs to happen
     }
@@ -279,76 +1127,311 @@ string parseAnnotation(char* const &tal, int& talOffset) {
 }
 
 EDFSignalData* parseSignal(std::fstream& in, EDFHeader* header, int signal) {
-    return parseSignal(in, header, signal, 0, header->recordingTime());
+    return parseSignal(in, header, signal, 0, header->recordingTime(), 0);
 }
 
-EDFSignalData* parseSignal(std::fstream& in, EDFHeader* header, int signal, double startTime, double length) {
-    // you should check that the signal value is in range before calling this method
-    if (startTime < 0 || startTime > header->recordingTime()) {
-        cerr << "Signal start time out of range. Giving up..." << endl;
-        return nullptr;
-    }
-    
-    double freq = header->signalSampleCount(signal) / header->dataRecordDuration();
-    EDFSignalData* data = new EDFSignalData(freq, header->physicalMax(signal), header->physicalMin(signal));
-    
-    // seek to beginning of data records
-    //in.seekg(header.signalCount() * 256 + 256, std::ios::beg);
+SignalWindow::SignalWindow(EDFHeader* header, int signal, double startTime, double length)
+    : signal(signal)
+    , header(header)
+    , startTime(startTime)
+{
+    freq = header->signalSampleCount(signal) / header->dataRecordDuration();
     
-    char* record = new char[header->dataRecordSize()]; // each record is the same size
-    int startInRecordBuffer = header->bufferOffset(signal); // this is the byte where the channel starts in each record
-    int endInRecordBuffer = startInRecordBuffer + header->signalSampleCount(signal) * 2; // this is the byte where the channel ends in each record
-    double* convertedSignal;
-    int convertedSignalLength;
+    startInRecordBuffer = header->bufferOffset(signal); // this is the byte where the channel starts in each record
+    endInRecordBuffer = startInRecordBuffer + header->signalSampleCount(signal) * 2; // this is the byte where the channel ends in each record
     
     // convert startTime in seconds to a starting record location
-    int startRecord = floor(startTime / header->dataRecordDuration()); // as record index
-    // convert length in seconds to an ending record location
-    int endRecord = startRecord + ceil(length / header->dataRecordDuration()); // as record index
+    startRecord = floor(startTime / header->dataRecordDuration()); // as record index
+    numberOfSamples = static_cast<int>(floor((startTime + length) * freq));
+    
+    // ending record location is the one after the record holding the last sample
+    int samplesPerRecord = header->signalSampleCount(signal);
+    endRecord = std::max(startRecord, (numberOfSamples + samplesPerRecord - 1) / samplesPerRecord); // as record index
     // truncate if beyond length of file
     if (endRecord > header->dataRecordCount())
         endRecord = header->dataRecordCount();
+    // samples left to take, counted from the start of the first record read
+    numberOfSamples -= startRecord * samplesPerRecord;
+    
+    // you should check that the signal value is in range before building a window
+    inRange = !(startTime < 0 || startTime > header->recordingTime());
+    if (!inRange)
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::WINDOW_RANGE,
+                               "Signal start time out of range. Giving up...");
+}
+
+int SignalWindow::count() const {
+    // samples every take() will return together, valid before the first take()
+    int first = static_cast<int>(floor(startTime * freq)) % header->signalSampleCount(signal);
+    int available = (endRecord - startRecord) * header->signalSampleCount(signal);
+    return std::max(0, std::min(numberOfSamples, available) - first);
+}
+
+int SignalWindow::take(int recordNum, int& start) {
+    // reading, possibly partial, first record
+    if (recordNum == startRecord)
+        start = static_cast<int>(floor(startTime * freq)) % header->signalSampleCount(signal); // in samples
+    else // read the rest of the records from 0 to end
+        start = 0;
+    
+    int end = std::min((endInRecordBuffer - startInRecordBuffer) / 2, numberOfSamples); // in samples
+    numberOfSamples -= header->signalSampleCount(signal); // trim for 'end' calculations
+    return end;
+}
+
+SignalDecoder::SignalDecoder(EDFHeader* header, int signal, double startTime, double length, EDFFilterChain* filter)
+    : SignalWindow(header, signal, startTime, length)
+    , data(nullptr)
+    , filter(filter)
+    , gain(header->gain(signal))
+    , offset(header->offset(signal))
+{
+    if (valid()) {
+        data = new EDFSignalData(freq, header->physicalMax(signal), header->physicalMin(signal));
+        converted.resize(header->signalSampleCount(signal));
+    }
+}
+
+SignalDecoder::~SignalDecoder() {
+    delete data;
+}
+
+void SignalDecoder::decode(const char* record, int recordNum) {
+    int start;
+    int end = take(recordNum, start);
+    int convertedSignalLength = end - start;
+    if (convertedSignalLength <= 0)
+        return;
+    
+    // samples are little endian two's complement
+    decodeSamples(record + startInRecordBuffer + 2 * start, converted.data(), convertedSignalLength);
+    
+    // filters run on physical values, the stored values stay in digital units
+    if (filter != nullptr) {
+        range_loop(i, 0, convertedSignalLength, 1)
+            converted[i] = gain * converted[i] + offset;
+        filter->process(converted.data(), convertedSignalLength);
+        range_loop(i, 0, convertedSignalLength, 1)
+            converted[i] = (converted[i] - offset) / gain;
+    }
+    data->addDataPoints(converted.data(), convertedSignalLength);
+}
+
+EDFSignalData* SignalDecoder::release() {
+    EDFSignalData* result = data;
+    data = nullptr;
+    return result;
+}
+
+template <typename T>
+SampleDecoder<T>::SampleDecoder(EDFHeader* header, int signal, double startTime, double length, EDFFilterChain* filter)
+    : SignalWindow(header, signal, startTime, length)
+    , data(nullptr)
+    , filter(filter)
+{
+    if (valid()) {
+        data = new EDFSignalSamples<T>(freq, header->physicalMax(signal), header->physicalMin(signal),
+                                       header->digitalMax(signal), header->digitalMin(signal));
+        data->reserve(static_cast<size_t>(endRecord - startRecord) * header->signalSampleCount(signal));
+        digital.resize(header->signalSampleCount(signal));
+        if (filter != nullptr)
+            physical.resize(header->signalSampleCount(signal));
+    }
+}
+
+template <typename T>
+SampleDecoder<T>::~SampleDecoder() {
+    delete data;
+}
+
+template <typename T>
+void SampleDecoder<T>::decode(const char* record, int recordNum) {
+    int start;
+    int end = take(recordNum, start);
+    if (end <= start)
+        return;
+    
+    // samples are little endian two's complement
+    decodeSamples(record + startInRecordBuffer + 2 * start, digital.data(), end - start);
+    
+    if (filter == nullptr) {
+        data->addDigitalSamples(digital.data(), end - start);
+        return;
+    }
     
-    // seek to beginning of first record to read
-    in.seekg(header->signalCount() * 256 + 256 + header->dataRecordSize() * startRecord);
-    
-    int numberOfSamples = static_cast<int>(floor((startTime + length) * freq));
-    range_loop(recordNum, startRecord, endRecord, 1) {
-        if(!in.read(record, header->dataRecordSize())) {
-            cerr << "Error reading signal records from file. Giving up..." << endl;
-            delete data;
-            return nullptr;
-        }
+    // filters run on physical values
+    double gain = data->gain(), offset = data->offset();
+    range_loop(i, 0, end - start, 1)
+        physical[i] = gain * digital[i] + offset;
+    filter->process(physical.data(), end - start);
+    data->addPhysicalSamples(physical.data(), end - start);
+}
+
+template <typename T>
+EDFSignalSamples<T>* SampleDecoder<T>::release() {
+    EDFSignalSamples<T>* result = data;
+    data = nullptr;
+    return result;
+}
+
+template <typename S, typename T>
+void storeSamples(const S* vals, int count, double gain, double offset, T* out, size_t step) {
+    // consecutive destinations stay a plain loop the compiler can vectorise
+    if (step == 1) {
+        range_loop(i, 0, count, 1)
+            out[i] = static_cast<T>(gain * vals[i] + offset);
+        return;
+    }
+    range_loop(i, 0, count, 1)
+        out[i * step] = static_cast<T>(gain * vals[i] + offset);
+}
+
+int recordsPerSpan(EDFHeader* header, size_t readSpan, int recordCount) {
+    // how many whole records fit in one read, never less than one
+    int spanRecords = static_cast<int>(std::min(readSpan / header->dataRecordSize(), static_cast<size_t>(recordCount)));
+    return std::max(spanRecords, 1);
+}
+
+template <typename Decode>
+bool readRecords(std::fstream& in, EDFHeader* header, int startRecord, int endRecord, size_t readSpan,
+                 EDFPrefetchReader* prefetch, EDFContainerReader* container, const int* signals, size_t signalCount,
+                 EDFInstrument* instrument, EDFArena* arena, const Decode& decode) {
+    int recordSize = header->dataRecordSize(); // each record is the same size
+    
+    // hand the reads to the background thread, decoding each chunk as it lands
+    if (prefetch != nullptr) {
+        if (!prefetch->start(startRecord, endRecord))
+            return false;
         
-        // reading, possibly partial, first record
-        if (recordNum == startRecord) {
-            // convert from 2's comp to integers
-            int start = static_cast<int>(floor(startTime * freq)) % header->signalSampleCount(signal); // in samples
-            int end = std::min((endInRecordBuffer - startInRecordBuffer) / 2, numberOfSamples); // in samples
-            convertedSignalLength = end - start;
-            convertedSignal = new double[convertedSignalLength];
-            range_loop(i, start, end, 1)
-                convertedSignal[i - start] = record[startInRecordBuffer + 2 * i] + 256 * record[startInRecordBuffer + 2 * i + 1];
-            
-            // read the rest of the records from 0 to end
-        } else {
-            // convert from 2's comp to integers
-            int end = std::min((endInRecordBuffer - startInRecordBuffer) / 2, numberOfSamples); // in bytes
-            convertedSignalLength = end;
-            convertedSignal = new double[convertedSignalLength];
-            range_loop(i, 0, end, 1)
-                convertedSignal[i] = record[startInRecordBuffer + 2 * i] + 256 * record[startInRecordBuffer + 2 * i + 1];
+        int recordNum = startRecord;
+        int recordCount = 0;
+        const char* chunk;
+        while ((chunk = prefetch->next(recordCount)) != nullptr) {
+            EDF_COUNT(instrument, readCalls, 1);
+            EDF_COUNT(instrument, bytesRead, static_cast<unsigned long long>(recordCount) * recordSize);
+            EDF_COUNT(instrument, recordsRead, recordCount);
+            EDF_COUNT(instrument, cacheHits, prefetch->wasReady() ? 1 : 0);
+            range_loop(i, 0, recordCount, 1)
+                decode(chunk + static_cast<size_t>(i) * recordSize, recordNum++);
         }
         
-        data->addDataPoints(convertedSignal, convertedSignalLength);
-        numberOfSamples -= header->signalSampleCount(signal); // trim for 'end' calculations
+        return !prefetch->failed();
+    }
+    
+    // read a slab of consecutive records per call and decode each in place
+    int spanRecords = recordsPerSpan(header, readSpan, endRecord - startRecord);
+    size_t slabSize = static_cast<size_t>(spanRecords) * recordSize;
+    char* slab;
+    size_t mark = 0;
+    if (arena != nullptr) {
+        // scratch from the arena only reaches the heap while the arena grows
+        unsigned long long heap = arena->heapAllocations();
+        mark = arena->mark();
+        slab = arena->allocate<char>(slabSize);
+        EDF_COUNT(instrument, allocations, arena->heapAllocations() - heap);
+    } else {
+        slab = new char[slabSize];
+        EDF_COUNT(instrument, allocations, 1);
+    }
+    
+    // seek to beginning of first record to read
+    in.clear();
+    in.seekg(header->signalCount() * 256 + 256 + static_cast<long long>(recordSize) * startRecord);
+    
+    range_loop(recordNum, startRecord, endRecord, spanRecords) {
+        int slabCount = std::min(spanRecords, endRecord - recordNum);
+        // containers rebuild only the signals the decoder reads
+        bool read = container != nullptr ? container->read(recordNum, recordNum + slabCount, signals, signalCount, slab)
+                                         : static_cast<bool>(in.read(slab, static_cast<std::streamsize>(slabCount) * recordSize));
+        if (!read) {
+            EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::RECORD_READ,
+                                   "Error reading signal records from file. Giving up...");
+            releaseSlab(slab, arena, mark);
+            return false;
+        }
+        EDF_COUNT(instrument, readCalls, 1);
+        EDF_COUNT(instrument, bytesRead, static_cast<unsigned long long>(slabCount) * recordSize);
+        EDF_COUNT(instrument, recordsRead, slabCount);
         
-        delete [] convertedSignal;
+        range_loop(i, 0, slabCount, 1)
+            decode(slab + static_cast<size_t>(i) * recordSize, recordNum + i);
     }
     
-    delete [] record;
+    releaseSlab(slab, arena, mark);
+    
+    return true;
+}
+
+void releaseSlab(char* slab, EDFArena* arena, size_t mark) {
+    if (arena != nullptr)
+        arena->rewind(mark);
+    else
+        delete [] slab;
+}
+
+template <typename Consume>
+bool streamSamples(std::fstream& in, EDFHeader* header, int signal, double startTime, double length, size_t readSpan,
+                   EDFPrefetchReader* prefetch, EDFContainerReader* container, EDFInstrument* instrument,
+                   EDFArena* arena, const Consume& consume) {
+    SignalWindow window(header, signal, startTime, length);
+    if (!window.valid())
+        return false;
+    
+    // decode each record's part of the window into one reused buffer
+    EDFArenaScope scope(arena);
+    int samplesPerRecord = header->signalSampleCount(signal);
+    int16_t* digital = arena->allocate<int16_t>(samplesPerRecord);
+    auto decode = [&](const char* record, int recordNum) {
+        EDF_TIMER(instrument, decodeSeconds);
+        int start;
+        int end = window.take(recordNum, start);
+        if (end <= start)
+            return;
+        
+        decodeSamples(record + window.startInRecordBuffer + 2 * start, digital, end - start);
+        consume(digital, end - start);
+    };
+    return readRecords(in, header, window.startRecord, window.endRecord, readSpan, prefetch, container, &signal, 1,
+                       instrument, arena, decode);
+}
+
+EDFSignalData* parseSignal(std::fstream& in, EDFHeader* header, int signal, double startTime, double length, size_t readSpan,
+                           EDFPrefetchReader* prefetch, EDFInstrument* instrument, EDFFilterChain* filter,
+                           EDFArena* arena, EDFContainerReader* container) {
+    SignalDecoder decoder(header, signal, startTime, length, filter);
+    if (!decoder.valid())
+        return nullptr;
+    EDF_COUNT(instrument, allocations, 1);
+    
+    auto decode = [&](const char* record, int recordNum) {
+        EDF_TIMER(instrument, decodeSeconds);
+        decoder.decode(record, recordNum);
+    };
+    if (!readRecords(in, header, decoder.startRecord, decoder.endRecord, readSpan, prefetch, container, &signal, 1,
+                     instrument, arena, decode))
+        return nullptr;
     
-    return data;
+    return decoder.release();
+}
+
+template <typename T>
+EDFSignalSamples<T>* parseSamples(std::fstream& in, EDFHeader* header, int signal, double startTime, double length, size_t readSpan,
+                                  EDFPrefetchReader* prefetch, EDFInstrument* instrument, EDFFilterChain* filter,
+                                  EDFArena* arena, EDFContainerReader* container) {
+    SampleDecoder<T> decoder(header, signal, startTime, length, filter);
+    if (!decoder.valid())
+        return nullptr;
+    EDF_COUNT(instrument, allocations, 1);
+    
+    auto decode = [&](const char* record, int recordNum) {
+        EDF_TIMER(instrument, decodeSeconds);
+        decoder.decode(record, recordNum);
+    };
+    if (!readRecords(in, header, decoder.startRecord, decoder.endRecord, readSpan, prefetch, container, &signal, 1,
+                     instrument, arena, decode))
+        return nullptr;
+    
+    return decoder.release();
 }
 
 void parsePatientInfo(const string &pStr, EDFHeader *header) {
@@ -421,7 +1504,8 @@ void parsePlusRecordInfo(const string &recordStr, EDFHeader *header) {
     if ((fieldLength = recordStr.find(' ', fieldStart) - fieldStart) != string::npos) {
         string recordingStart = recordStr.substr(fieldStart, fieldLength);
         if (recordingStart.compare("Startdate") != 0)
-            cerr << "\"Startdate\" text not found in recording information header. Ignoring..." << endl;
+            EDFDiagnostics::report(EDFSeverity::WARNING, EDFDiagnosticCode::HEADER_FORMAT,
+                                   "\"Startdate\" text not found in recording information header. Ignoring...");
         else
             fieldStart += fieldLength + 1;
     }
@@ -450,12 +1534,13 @@ void parsePlusRecordInfo(const string &recordStr, EDFHeader *header) {
         header->setEquipment(recordStr.substr(fieldStart, fieldLength));
 }
 
-bool parseSignalHeaders(std::fstream &in, EDFHeader *header) {
+bool parseSignalHeaders(std::istream &in, EDFHeader *header) {
     // read signal data characters 257 -> signal count * 256
     int signalHeaderLength = header->signalCount() * 256 + 1;
     char* signalHeaderArray = new char[signalHeaderLength];
     if (in.fail() || !in.get(signalHeaderArray, signalHeaderLength)) {
-        cerr << "Error reading header from file. Giving up..." << endl;
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::HEADER_FORMAT,
+                               "Error reading header from file. Giving up...");
         delete [] signalHeaderArray;
         return false;
     }
@@ -480,11 +1565,13 @@ bool parseSignalHeaders(std::fstream &in, EDFHeader *header) {
         header->setLabel(sigNum, trim(signalHeader.substr(headerLoc, 16)));
         if (header->label(sigNum).compare("EDF Annotations") == 0) {
             if (annotationIndex != -1) {
-                cerr << "More than one annotation signals defined. Only the first is accessible..." << endl;
+                EDFDiagnostics::report(EDFSeverity::WARNING, EDFDiagnosticCode::ANNOTATION_SIGNAL,
+                                       "More than one annotation signals defined. Only the first is accessible...");
             } else {
                 header->setAnnotationIndex(sigNum);
                 if (header->filetype() == FileType::EDF)
-                    cerr << "Annotations not expected in EDF file. Handling them anyway..." << endl;
+                    EDFDiagnostics::report(EDFSeverity::WARNING, EDFDiagnosticCode::ANNOTATION_SIGNAL,
+                                           "Annotations not expected in EDF file. Handling them anyway...");
             }
         }
         headerLoc += 16;
@@ -559,7 +1646,8 @@ bool parseSignalHeaders(std::fstream &in, EDFHeader *header) {
 bool charactersValid(char *str, int len) {
     range_loop(i, 0, len, 1) {
         if (str[i] < 32 || str[i] > 126) {
-            cerr << "Invalid characters detected in header" << endl;
+            EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::HEADER_FORMAT,
+                                   "Invalid characters detected in header");
             return false;
         }
     }
@@ -567,17 +1655,28 @@ bool charactersValid(char *str, int len) {
     return true;
 }
 
-bool validFileLength(std::fstream &in, EDFHeader* header, int recordSize) {
-    // jump to end of file and make sure all data is present and there is no extra data
+bool validFileLength(std::istream &in, EDFHeader* header, int recordSize) {
+    // jump to end of file and make sure all data is present
     in.seekg(0, std::ios::end);
     long long last = in.tellg();
-    long long lengthDiff = last - header->dataRecordCount() * header->dataRecordSize() - recordSize;
+    
+    // a recording still being written declares -1 records until its first update
+    if (header->dataRecordCount() < 0 && header->dataRecordSize() > 0 && last >= recordSize) {
+        header->setDataRecordCount(static_cast<int>((last - recordSize) / header->dataRecordSize()));
+        EDFDiagnostics::report(EDFSeverity::WARNING, EDFDiagnosticCode::FILE_LENGTH,
+                               "Data record count is -1. Reading the whole records present...");
+        return true;
+    }
+    
+    long long lengthDiff = last - static_cast<long long>(header->dataRecordCount()) * header->dataRecordSize() - recordSize;
     if (lengthDiff < 0) {
-        cerr << "Data segement has excessive information. Signal data will not be accessible..." << endl;
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::FILE_LENGTH,
+                               "Data segement has missing information. Signal data will not be accessible...");
         return false;
     } else if (lengthDiff > 0) {
-        cerr << "Data segement has missing information. Signal data will not be accessible..." << endl;
-        return false;
+        // records appended after the last count update, or a torn record being written
+        EDFDiagnostics::report(EDFSeverity::WARNING, EDFDiagnosticCode::FILE_LENGTH,
+                               "Data segement extends past the declared records. Reading only the declared records...");
     }
     
     return true;
@@ -591,7 +1690,7 @@ bool validOnset(string& s) {
     // can contain at most one '.'
     // and only numerals after first dot character
     int dotIndex = -1;
-    range_loop(i, 1, s.length(), 1) {
+    range_loop(i, static_cast<size_t>(1), s.length(), 1) {
         if (s[i] == '.' && dotIndex < 0) {// is it a dot
             dotIndex = (int)i;
             if (dotIndex == (int)s.length() - 1)
@@ -607,7 +1706,7 @@ bool validDuration(string& s) {
     // can contain at most one '.'
     // and only numerals after first dot character
     int dotIndex = -1;
-    range_loop(i, 0, s.length(), 1) {
+    range_loop(i, static_cast<size_t>(0), s.length(), 1) {
         if (s[i] == '.' && dotIndex < 0) // is it a dot
             dotIndex = (int)i;
         else if (s[i] < '0' || s[i] > '9') // not a numeral
@@ -16,11 +16,49 @@
 
 #include <string>
 #include <fstream>
+#include <functional>
+#include <memory>
 #include <vector>
 #include "EDFHeader.h"
 #include "EDFAnnotation.h"
+#include "EDFArena.h"
+#include "EDFDecode.h"
+#include "EDFEpochTable.h"
+#include "EDFFilter.h"
+#include "EDFHistogram.h"
+#include "EDFInstrument.h"
+#include "EDFMatrix.h"
+#include "EDFMontage.h"
+#include "EDFQuantileSketch.h"
+#include "EDFResampler.h"
 #include "EDFSignalData.h"
+#include "EDFSignalSamples.h"
+#include "EDFWelch.h"
 
+class EDFPrefetchReader;
+class EDFBatchReader;
+class EDFContainerReader;
+class SignalWindow;
+
+/**
+ A window of signal time to extract.
+ */
+struct EDFWindow {
+    double start;  // in fractional seconds
+    double length; // in fractional seconds
+};
+
+/**
+ Receives the records a growing file gained: the first new record and how
+ many were added.
+ */
+typedef std::function<void(int, int)> EDFRecordsHandler;
+
+/**
+ Receives data records as stored in an EDF file: the record bytes and the
+ record number.
+ */
+typedef std::function<void(const char*, int)> EDFRecordVisitor;
 
 class EDFFile {
 public:
@@ -28,9 +66,12 @@ public:
      Contructor to build new EDF file object. Access
      to the data of an EDF file should start by instantiating
      this class.
-     @param path Path to the EDF file on disk.
+     @param path Path to the EDF file on disk, or to a compressed container
+     written by compressFile.
+     @param tracer Receives trace spans from the start, including header and
+     annotation parsing. Only used when instrumentation is compiled in.
      */
-    EDFFile(const char*);
+    EDFFile(const char*, EDFTracer* = nullptr);
     
     /**
      Destructor.
@@ -49,6 +90,13 @@ public:
      */
     std::vector<EDFAnnotation>* annotations() const;
     
+    /**
+     Take the parsed annotations out of the file without copying them.
+     annotations() is left pointing to an empty list.
+     @return Annotations in file order, empty if the file has none.
+     */
+    std::vector<EDFAnnotation> takeAnnotations();
+    
     /**
      Get a portion of a channel's signal information.
      @param channel The channel to extract information from.
@@ -63,12 +111,334 @@ public:
      Attempting to extract data from an nonexistent channel.
      */
     EDFSignalData* extractSignalData(int, double, double);
+    
+    /**
+     Get a portion of a channel's signal information in a compact sample type.
+     Only int16_t, float and double are provided. int16_t keeps the raw digital
+     samples; float and double hold samples converted to physical units while
+     decoding.
+     @param channel The channel to extract information from.
+     @param start The starting time in fractional seconds to
+     begin signal data extraction.
+     @param length The length of time in fractional seconds of
+     signal information to extract. If the length is greater than the
+     signal data, the time will be truncated to the max data length.
+     @return An EDFSignalSamples object or nullptr under the same conditions
+     as extractSignalData.
+     */
+    template <typename T>
+    EDFSignalSamples<T>* extractSamples(int, double, double);
+    
+    /**
+     Same as extractSignalData, with the result owned by the caller.
+     @return The extracted data, or an empty pointer under the same
+     conditions extractSignalData returns nullptr.
+     */
+    std::unique_ptr<EDFSignalData> signalData(int, double, double);
+    
+    /**
+     Same as extractSamples, with the result owned by the caller.
+     @return The extracted samples, or an empty pointer under the same
+     conditions extractSamples returns nullptr.
+     */
+    template <typename T>
+    std::unique_ptr<EDFSignalSamples<T> > signalSamples(int, double, double);
+    
+    /**
+     Extract many windows of a channel in one batch. The record ranges of all
+     windows are coalesced where they overlap or touch and read as one batch of
+     asynchronous reads. Each window is decoded as soon as its read completes.
+     @param channel The channel to extract information from.
+     @param windows The start and length in fractional seconds of each window.
+     @return One EDFSignalData object per window, in the order given. Entries are
+     nullptr under the same conditions extractSignalData returns nullptr, or when
+     the read covering the window failed.
+     */
+    std::vector<EDFSignalData*> extractSignalWindows(int, const std::vector<EDFWindow>&);
+    
+    /**
+     Compute mean, RMS, variance, extremes and line length of fixed length
+     epochs for several channels. All channels are decoded together in one
+     pass over the data records, so the file is read once however many
+     epochs and channels there are.
+     @param length Epoch length in fractional seconds.
+     @param overlap Seconds shared by consecutive epochs. Must be less than length.
+     @param channels Signals to include. Empty includes every signal except
+     the annotation channel.
+     @return A [channel x epoch] table or nullptr if the epoch layout is invalid,
+     a channel is the annotation channel or does not exist, or reading failed.
+     */
+    EDFEpochTable* epochStatistics(double, double = 0, const std::vector<int>& = std::vector<int>());
+    
+    /**
+     Feed a portion of a channel into streaming sketches while it is decoded,
+     without keeping the samples. Sketches are added to, so one sketch can
+     collect several windows or files, and sketches filled on different
+     threads can be merged afterwards.
+     @param channel The channel to extract information from.
+     @param start The starting time in fractional seconds to
+     begin signal data extraction.
+     @param length The length of time in fractional seconds of
+     signal information to extract. If the length is greater than the
+     signal data, the time will be truncated to the max data length.
+     @param histogram Receives the digital samples, or nullptr. Usually built
+     over the channel's digital range with the header's gain and offset.
+     @param quantiles Receives the samples in physical units, or nullptr.
+     @return false under the same conditions extractSignalData returns nullptr,
+     or when reading failed.
+     */
+    bool sketchSignal(int, double, double, EDFHistogram*, EDFQuantileSketch*);
+    
+    /**
+     Feed a portion of a channel into a Welch spectral estimator while it is
+     decoded, without keeping the samples. The estimator is added to, so
+     reset it between epochs; its FFT plan and buffers are reused.
+     @param channel The channel to extract information from.
+     @param start The starting time in fractional seconds to
+     begin signal data extraction.
+     @param length The length of time in fractional seconds of
+     signal information to extract. If the length is greater than the
+     signal data, the time will be truncated to the max data length.
+     @param welch Estimator built for the channel's sample rate. Receives the
+     samples in physical units.
+     @return false under the same conditions extractSignalData returns nullptr,
+     or when reading failed.
+     */
+    bool spectrum(int, double, double, EDFWelch*);
+    
+    /**
+     Extract several channels resampled to one rate, aligned sample for
+     sample. All channels are decoded together in one pass over the data
+     records and each is fed record by record through its own polyphase
+     resampler, so no channel is held at its original rate.
+     @param channels Signals to include. Empty includes every signal except
+     the annotation channel.
+     @param start The starting time in fractional seconds to
+     begin signal data extraction.
+     @param length The length of time in fractional seconds of
+     signal information to extract. If the length is greater than the
+     signal data, the time will be truncated to the max data length.
+     @param rate Samples per second of the result.
+     @param quality Resampling filter zero crossings on each side of the centre.
+     @return A matrix of floor(length * rate) samples per channel in physical
+     units, or nullptr if the rate is not positive, a channel is the
+     annotation channel or does not exist, the start is out of range or
+     reading failed.
+     */
+    EDFMatrix* extractResampled(const std::vector<int>&, double, double, double, int = 16);
+    
+    /**
+     Evaluate the derivations of a montage in one pass over the records.
+     Each source channel is decoded once per record and folded into every
+     derivation that uses it; only the derived channels are kept. Filters
+     attached with setFilter() are not applied.
+     @param montage Derivations to evaluate. Every channel they use must have
+     the same sample rate.
+     @param start The starting time in fractional seconds to
+     begin signal data extraction.
+     @param length The length of time in fractional seconds of
+     signal information to extract. If the length is greater than the
+     signal data, the time will be truncated to the max data length.
+     @return A matrix with one row per derivation in physical units, labelled
+     with the derivation names, or nullptr if a label matches no signal, the
+     channels differ in sample rate, the start is out of range or reading
+     failed.
+     */
+    EDFMatrix* extractMontage(const EDFMontage&, double, double);
+    
+    /**
+     Get the number of samples an extraction of a channel yields.
+     @param channel The channel to extract information from.
+     @param start The starting time in fractional seconds.
+     @param length The length of time in fractional seconds, truncated to the
+     recording as for extraction.
+     @return Sample count, or 0 under the same conditions extractSignalData
+     returns nullptr.
+     */
+    size_t sampleCount(int, double, double);
+    
+    /**
+     Extract several channels straight into a caller's buffer in physical
+     units. All channels are decoded together in one pass over the data
+     records and written in place, so no per-channel objects are built.
+     Only float and double are provided. Filters attached with setFilter()
+     are applied.
+     @param channels Signals to include, in buffer order. Empty includes
+     every signal except the annotation channel. All must have the same
+     sample rate.
+     @param start The starting time in fractional seconds to
+     begin signal data extraction.
+     @param length The length of time in fractional seconds of
+     signal information to extract. If the length is greater than the
+     signal data, the time will be truncated to the max data length.
+     @param buffer Destination of sampleCount() samples of every channel.
+     @param layout Whether channels or instants are consecutive.
+     @param stride Elements from the start of one row to the next: from one
+     channel to the next for CHANNEL_MAJOR, from one instant to the next for
+     TIME_MAJOR. 0 packs the rows. Padding between rows is left untouched.
+     @return false if a channel is the annotation channel or does not exist,
+     the channels differ in sample rate, the stride is shorter than a row,
+     the start is out of range or reading failed.
+     */
+    template <typename T>
+    bool extractMatrix(const std::vector<int>&, double, double, T*, EDFLayout = EDFLayout::CHANNEL_MAJOR, size_t = 0);
+    
+    /**
+     Extract a portion of a channel straight into a caller's buffer in
+     physical units. Together with setArena() no heap memory is touched once
+     the arena has grown to fit. Only float and double are provided. Filters
+     attached with setFilter() are applied.
+     @param channel The channel to extract information from.
+     @param start The starting time in fractional seconds to
+     begin signal data extraction.
+     @param length The length of time in fractional seconds of
+     signal information to extract. If the length is greater than the
+     signal data, the time will be truncated to the max data length.
+     @param buffer Destination of the samples.
+     @param capacity Number of samples buffer holds, at least sampleCount().
+     @return Number of samples written, or 0 under the same conditions
+     extractSignalData returns nullptr, when the buffer is too short or
+     reading failed.
+     */
+    template <typename T>
+    size_t extractInto(int, double, double, T*, size_t);
+    
+    /**
+     Pass a range of data records to a visitor in order, undecoded, for
+     processing every signal in one pass over the file. Records come out of
+     the same slabs or read-ahead buffers as extraction, and compressed
+     containers rebuild them in full.
+     @param startRecord First record.
+     @param endRecord One past the last record.
+     @param visitor Called once per record with dataRecordSize() bytes, valid
+     only during the call.
+     @return false if the range is outside the recording or reading failed.
+     */
+    bool visitRecords(int, int, const EDFRecordVisitor&);
+    
+    /**
+     Set how many bytes of consecutive records a blocking extraction reads per
+     call. Records are decoded out of the slab in place, so small records no
+     longer cost one read each. Defaults to 4 MiB; spans smaller than a record
+     read one record at a time.
+     @param span Size in bytes of each read, rounded down to whole records.
+     */
+    void setReadSpan(size_t);
+    
+    /**
+     Take the scratch buffers of every extraction from an arena, such as one
+     reset per request. Each extraction releases what it took before
+     returning, so the arena only grows to the largest single extraction.
+     The file keeps an arena of its own when none is set.
+     @param arena Scratch memory, or nullptr to use the file's own. Must
+     outlive its use by this file.
+     */
+    void setArena(EDFArena*);
+    
+    /**
+     Enable or disable background read-ahead for signal extraction.
+     When enabled, extraction reads large multi-record chunks on a background
+     thread into a ring of buffers while the previous chunk is decoded.
+     @param depth Number of chunk buffers in flight. Zero disables read-ahead.
+     @param chunkSize Size in bytes of each background read, rounded down to whole records.
+     Compressed containers ignore read-ahead and decompress blocks as they are read.
+     */
+    void setReadAhead(int, size_t = 4 << 20);
+    
+    /**
+     Attach a filter chain to a channel. extractSignalData and extractSamples
+     then run each record's samples through the chain as they are decoded,
+     and the chain's state carries on from one record and one extraction to
+     the next, so consecutive windows filter as one continuous signal. Call
+     reset on the chain to start afresh. Both filter physical values;
+     extractSignalData stores the filtered values back in digital units,
+     so a chain gives the same signal through either. Batched windows,
+     epoch statistics and the sketch and spectrum streams are not filtered.
+     @param channel The channel to filter.
+     @param chain Chain designed for the channel's sample rate, or nullptr to
+     stop filtering. Not owned.
+     */
+    void setFilter(int, EDFFilterChain*);
+    
+    /**
+     Pick up records appended since the file was opened or last refreshed,
+     for files still being written. Only whole records are counted, so a
+     record caught half written is left for a later refresh. The header's
+     record count and the annotation list are extended in place and every
+     subscriber is told of the new range.
+     @return Number of records added, or -1 if their annotations could not
+     be read.
+     */
+    int refresh();
+    
+    /**
+     Wait for the file to grow and pick up the new records as refresh does.
+     Where inotify is available the wait wakes as soon as the file is
+     written; elsewhere the file size is polled.
+     @param timeout Longest wait in milliseconds.
+     @return Number of records added, 0 if none arrived in time, or -1 as for
+     refresh.
+     */
+    int follow(int);
+    
+    /**
+     Set how often follow checks the file size when it cannot be watched.
+     @param milliseconds Delay between checks, at least 1.
+     */
+    void setPollInterval(int);
+    
+    /**
+     Register a handler called with each range of records refresh or follow
+     adds.
+     @param handler Called on the thread that refreshes.
+     @return Id for unsubscribe.
+     */
+    int subscribe(const EDFRecordsHandler&);
+    
+    /**
+     Stop calling a handler.
+     @param id Value returned by subscribe.
+     */
+    void unsubscribe(int);
+    
+    /**
+     Get a snapshot of the reads and decoding done for this file. All values
+     are zero unless the library is built with EDFLIB_INSTRUMENTATION.
+     @return Counters accumulated since opening or the last resetStats.
+     */
+    EDFStats stats() const;
+    
+    /**
+     Zero all counters.
+     */
+    void resetStats();
+    
+    /**
+     Set the receiver of trace spans. Only used when instrumentation is compiled in.
+     @param tracer Tracer to call, or nullptr to stop tracing. Not owned.
+     */
+    void setTracer(EDFTracer*);
 
 private:
     std::string filePath;
     std::fstream fileStream;
     EDFHeader* fileHeader;
     std::vector<EDFAnnotation>* annotation;
+    EDFPrefetchReader* prefetcher;
+    EDFBatchReader* batchReader;
+    EDFContainerReader* container;  // set when the file is a compressed container
+    size_t readSpan;
+    EDFArena ownArena;
+    EDFArena* arena;                // scratch for records and decode buffers
+    std::vector<int> dataSignals;   // every signal except annotations
+    std::vector<EDFFilterChain*> filters;
+    std::vector<EDFRecordsHandler> subscribers;
+    int watchDescriptor;            // inotify instance following the file, -1 until follow
+    int pollInterval;               // milliseconds between size checks without inotify
+    EDFInstrument instrument;
+    
+    template <typename T>
+    bool decodeInto(const int*, size_t, SignalWindow&, T*, size_t, size_t);
 };
 
 #endif	/* _EDFFILE_H */
@@ -0,0 +1,234 @@
+/**
+ @file EDFFilter.cpp
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#include "EDFFilter.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using std::vector;
+
+const double PI = 3.14159265358979323846;
+// residual of a start up transient that counts as faded
+const double TRANSIENT_LEVEL = 1e-4;
+
+/* EDFBiquad */
+
+EDFBiquad::EDFBiquad(double b0, double b1, double b2, double a1, double a2)
+    : b0(b0), b1(b1), b2(b2), a1(a1), a2(a2), z1(0), z2(0)
+{}
+
+EDFBiquad EDFBiquad::lowPass(double sampleRate, double cutoff, double q) {
+    double w = 2 * PI * cutoff / sampleRate, c = cos(w), alpha = sin(w) / (2 * q), a0 = 1 + alpha;
+    return EDFBiquad((1 - c) / 2 / a0, (1 - c) / a0, (1 - c) / 2 / a0, -2 * c / a0, (1 - alpha) / a0);
+}
+
+EDFBiquad EDFBiquad::highPass(double sampleRate, double cutoff, double q) {
+    double w = 2 * PI * cutoff / sampleRate, c = cos(w), alpha = sin(w) / (2 * q), a0 = 1 + alpha;
+    return EDFBiquad((1 + c) / 2 / a0, -(1 + c) / a0, (1 + c) / 2 / a0, -2 * c / a0, (1 - alpha) / a0);
+}
+
+EDFBiquad EDFBiquad::bandPass(double sampleRate, double centre, double q) {
+    double w = 2 * PI * centre / sampleRate, c = cos(w), alpha = sin(w) / (2 * q), a0 = 1 + alpha;
+    return EDFBiquad(alpha / a0, 0, -alpha / a0, -2 * c / a0, (1 - alpha) / a0);
+}
+
+EDFBiquad EDFBiquad::notch(double sampleRate, double centre, double q) {
+    double w = 2 * PI * centre / sampleRate, c = cos(w), alpha = sin(w) / (2 * q), a0 = 1 + alpha;
+    return EDFBiquad(1 / a0, -2 * c / a0, 1 / a0, -2 * c / a0, (1 - alpha) / a0);
+}
+
+void EDFBiquad::process(double* x, size_t length) {
+    // state in locals so the loop keeps it in registers
+    double s1 = z1, s2 = z2;
+    for (size_t i = 0; i < length; i++) {
+        double in = x[i];
+        double out = b0 * in + s1;
+        s1 = b1 * in - a1 * out + s2;
+        s2 = b2 * in - a2 * out;
+        x[i] = out;
+    }
+    z1 = s1;
+    z2 = s2;
+}
+
+void EDFBiquad::reset() {
+    z1 = z2 = 0;
+}
+
+double EDFBiquad::settle(double val) {
+    double den = 1 + a1 + a2;
+    double out = den != 0 ? val * (b0 + b1 + b2) / den : 0;
+    z2 = b2 * val - a2 * out;
+    z1 = b1 * val - a1 * out + z2;
+    return out;
+}
+
+size_t EDFBiquad::transient() const {
+    // decay of the slowest pole
+    double disc = a1 * a1 - 4 * a2;
+    double radius = disc < 0 ? sqrt(a2) : std::max(fabs(-a1 + sqrt(disc)), fabs(-a1 - sqrt(disc))) / 2;
+    if (radius <= 0)
+        return 2;
+    if (radius >= 1)
+        return 1 << 20;
+    return static_cast<size_t>(ceil(log(TRANSIENT_LEVEL) / log(radius))) + 2;
+}
+
+/* EDFFIRFilter */
+
+EDFFIRFilter::EDFFIRFilter(const vector<double>& taps)
+    : reversed(taps.rbegin(), taps.rend())
+{
+    if (reversed.empty())
+        reversed.push_back(1);
+    work.assign(reversed.size() - 1, 0);
+}
+
+vector<double> EDFFIRFilter::lowPassTaps(double sampleRate, double cutoff, int count) {
+    count = std::max(count, 1);
+    vector<double> taps(count);
+    double fc = cutoff / sampleRate, centre = (count - 1) / 2.0, sum = 0;
+    for (int i = 0; i < count; i++) {
+        double t = i - centre;
+        double sinc = t == 0 ? 2 * fc : sin(2 * PI * fc * t) / (PI * t);
+        double window = count > 1 ? 0.54 - 0.46 * cos(2 * PI * i / (count - 1)) : 1;
+        taps[i] = sinc * window;
+        sum += taps[i];
+    }
+    for (double& tap : taps)
+        tap /= sum;
+    return taps;
+}
+
+void EDFFIRFilter::process(double* x, size_t length) {
+    size_t history = reversed.size() - 1;
+    work.resize(history + length);
+    memcpy(work.data() + history, x, length * sizeof(double));
+
+    // y[i] is the dot product of the reversed taps with the window ending at x[i]
+    const double* h = reversed.data();
+    size_t taps = reversed.size();
+    for (size_t i = 0; i < length; i++) {
+        const double* w = work.data() + i;
+        double sum = 0;
+        for (size_t j = 0; j < taps; j++)
+            sum += h[j] * w[j];
+        x[i] = sum;
+    }
+
+    // keep the newest inputs as history for the next block
+    memmove(work.data(), work.data() + length, history * sizeof(double));
+    work.resize(history);
+}
+
+void EDFFIRFilter::reset() {
+    std::fill(work.begin(), work.end(), 0);
+}
+
+double EDFFIRFilter::settle(double val) {
+    std::fill(work.begin(), work.end(), val);
+    double gain = 0;
+    for (double tap : reversed)
+        gain += tap;
+    return gain * val;
+}
+
+size_t EDFFIRFilter::transient() const {
+    return reversed.size();
+}
+
+/* EDFFilterChain */
+
+EDFFilterChain::EDFFilterChain(double sampleRate)
+    : c_sampleRate(sampleRate)
+{}
+
+EDFFilterChain::~EDFFilterChain() {
+    for (auto stage : c_stages)
+        delete stage;
+}
+
+EDFFilterChain& EDFFilterChain::add(EDFFilterStage* stage) {
+    if (stage != nullptr)
+        c_stages.push_back(stage);
+    return *this;
+}
+
+EDFFilterChain& EDFFilterChain::addLowPass(double cutoff, int order) {
+    // Butterworth poles split into second order sections
+    int sections = std::max(1, (order + 1) / 2);
+    for (int k = 0; k < sections; k++) {
+        double q = 1 / (2 * cos(PI * (2 * k + 1) / (4 * sections)));
+        add(new EDFBiquad(EDFBiquad::lowPass(c_sampleRate, cutoff, q)));
+    }
+    return *this;
+}
+
+EDFFilterChain& EDFFilterChain::addHighPass(double cutoff, int order) {
+    int sections = std::max(1, (order + 1) / 2);
+    for (int k = 0; k < sections; k++) {
+        double q = 1 / (2 * cos(PI * (2 * k + 1) / (4 * sections)));
+        add(new EDFBiquad(EDFBiquad::highPass(c_sampleRate, cutoff, q)));
+    }
+    return *this;
+}
+
+EDFFilterChain& EDFFilterChain::addNotch(double centre, double q) {
+    return add(new EDFBiquad(EDFBiquad::notch(c_sampleRate, centre, q)));
+}
+
+EDFFilterChain& EDFFilterChain::addFIRLowPass(double cutoff, int taps) {
+    return add(new EDFFIRFilter(EDFFIRFilter::lowPassTaps(c_sampleRate, cutoff, taps)));
+}
+
+double EDFFilterChain::sampleRate() const { return c_sampleRate; }
+
+size_t EDFFilterChain::stages() const { return c_stages.size(); }
+
+void EDFFilterChain::process(double* x, size_t length) {
+    for (auto stage : c_stages)
+        stage->process(x, length);
+}
+
+void EDFFilterChain::reset() {
+    for (auto stage : c_stages)
+        stage->reset();
+}
+
+void EDFFilterChain::settle(double val) {
+    for (auto stage : c_stages)
+        val = stage->settle(val);
+}
+
+void EDFFilterChain::processZeroPhase(double* x, size_t length) {
+    if (length == 0)
+        return;
+
+    size_t pad = 0;
+    for (auto stage : c_stages)
+        pad += stage->transient();
+    pad = std::min(pad, length - 1);
+
+    // odd reflection about each end keeps the signal and its slope continuous
+    c_padded.resize(length + 2 * pad);
+    double* p = c_padded.data();
+    for (size_t i = 0; i < pad; i++) {
+        p[i] = 2 * x[0] - x[pad - i];
+        p[pad + length + i] = 2 * x[length - 1] - x[length - 2 - i];
+    }
+    memcpy(p + pad, x, length * sizeof(double));
+
+    settle(p[0]);
+    process(p, c_padded.size());
+    std::reverse(c_padded.begin(), c_padded.end());
+    settle(p[0]);
+    process(p, c_padded.size());
+    std::reverse(c_padded.begin(), c_padded.end());
+
+    memcpy(x, p + pad, length * sizeof(double));
+    reset();
+}
@@ -0,0 +1,218 @@
+/**
+ @file EDFFilter.h
+ @brief Streaming IIR and FIR filters and chains of them.
+ Filters work on blocks of any size and keep their state between calls, so
+ a signal filtered one data record at a time comes out the same as if it
+ were filtered in one piece. A chain can also filter a whole buffer forwards
+ and backwards for zero phase shift, which needs the whole signal at once.
+
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#ifndef _EDFFILTER_H
+#define	_EDFFILTER_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ One linear time invariant stage of a filter chain.
+ */
+class EDFFilterStage {
+public:
+    virtual ~EDFFilterStage() = default;
+
+    /**
+     Filter a block in place, continuing from the previous block.
+     @param vals Samples to filter.
+     @param length Length of vals array.
+     */
+    virtual void process(double*, size_t) = 0;
+
+    /**
+     Forget all past input.
+     */
+    virtual void reset() = 0;
+
+    /**
+     Set the state to the one reached after a long constant input.
+     @param val The constant input.
+     @return The stage's steady output for that input.
+     */
+    virtual double settle(double) = 0;
+
+    /**
+     Get a number of samples long enough for the stage's start up transient to fade.
+     @return Transient length in samples.
+     */
+    virtual size_t transient() const = 0;
+};
+
+/**
+ Second order IIR section, transposed direct form II.
+ Designs follow the audio EQ cookbook formulas.
+ */
+class EDFBiquad : public EDFFilterStage {
+public:
+    /**
+     Build a section from coefficients normalised to a0 = 1.
+     @param b0 Feed forward coefficient of x[n].
+     @param b1 Feed forward coefficient of x[n - 1].
+     @param b2 Feed forward coefficient of x[n - 2].
+     @param a1 Feedback coefficient of y[n - 1].
+     @param a2 Feedback coefficient of y[n - 2].
+     */
+    EDFBiquad(double, double, double, double, double);
+
+    /**
+     Design a section. The remaining designs take the same arguments.
+     @param sampleRate Samples per second.
+     @param frequency Cutoff or centre frequency in hertz.
+     @param q Quality factor, 1 / sqrt(2) for a Butterworth response.
+     @return Section with its state reset.
+     */
+    static EDFBiquad lowPass(double, double, double = 0.7071067811865476);
+    static EDFBiquad highPass(double, double, double = 0.7071067811865476);
+    static EDFBiquad bandPass(double, double, double);
+    static EDFBiquad notch(double, double, double = 30);
+
+    void process(double*, size_t);
+    void reset();
+    double settle(double);
+    size_t transient() const;
+
+private:
+    double b0, b1, b2, a1, a2;
+    double z1, z2;
+};
+
+/**
+ Finite impulse response filter. Blocks are convolved out of one contiguous
+ buffer of history followed by input, as a dot product per output that the
+ compiler can vectorise.
+ */
+class EDFFIRFilter : public EDFFilterStage {
+public:
+    /**
+     Constructor.
+     @param taps Impulse response, at least one tap.
+     */
+    EDFFIRFilter(const std::vector<double>&);
+
+    /**
+     Design a linear phase low-pass filter by the Hamming windowed sinc method.
+     @param sampleRate Samples per second.
+     @param cutoff Half amplitude frequency in hertz.
+     @param count Number of taps, odd counts have a whole sample delay.
+     @return Taps with unit gain at zero frequency.
+     */
+    static std::vector<double> lowPassTaps(double, double, int);
+
+    void process(double*, size_t);
+    void reset();
+    double settle(double);
+    size_t transient() const;
+
+private:
+    std::vector<double> reversed; // taps, last first
+    std::vector<double> work;     // history then the block being filtered
+};
+
+/**
+ An ordered list of stages applied one after another.
+ */
+class EDFFilterChain {
+public:
+    /**
+     Constructor.
+     @param sampleRate Samples per second of the signals the chain will filter.
+     */
+    EDFFilterChain(double);
+    ~EDFFilterChain();
+
+    /**
+     Append a stage.
+     @param stage Stage to apply after the others. The chain takes ownership.
+     @return This chain.
+     */
+    EDFFilterChain& add(EDFFilterStage*);
+
+    /**
+     Append a Butterworth low-pass as a cascade of biquads.
+     @param cutoff -3 dB frequency in hertz.
+     @param order Filter order, rounded up to even.
+     @return This chain.
+     */
+    EDFFilterChain& addLowPass(double, int = 2);
+
+    /**
+     Append a Butterworth high-pass as a cascade of biquads.
+     @param cutoff -3 dB frequency in hertz.
+     @param order Filter order, rounded up to even.
+     @return This chain.
+     */
+    EDFFilterChain& addHighPass(double, int = 2);
+
+    /**
+     Append a notch, e.g. at the mains frequency.
+     @param centre Frequency to remove in hertz.
+     @param q Centre frequency over the notch width.
+     @return This chain.
+     */
+    EDFFilterChain& addNotch(double, double = 30);
+
+    /**
+     Append a windowed sinc low-pass FIR.
+     @param cutoff Half amplitude frequency in hertz.
+     @param taps Number of taps.
+     @return This chain.
+     */
+    EDFFilterChain& addFIRLowPass(double, int);
+
+    /**
+     Get the sample rate the chain was designed for.
+     @return Samples per second.
+     */
+    double sampleRate() const;
+
+    /**
+     Get the number of stages.
+     @return Stage count.
+     */
+    size_t stages() const;
+
+    /**
+     Filter a block in place, continuing from the previous block.
+     @param vals Samples to filter.
+     @param length Length of vals array.
+     */
+    void process(double*, size_t);
+
+    /**
+     Forget all past input.
+     */
+    void reset();
+
+    /**
+     Filter a whole signal forwards then backwards, cancelling the phase
+     shift and squaring the magnitude response. The ends are extended by odd
+     reflection and the state is settled on them, as filtfilt does. Any
+     streaming state is lost; the chain is reset afterwards.
+     @param vals Samples to filter.
+     @param length Length of vals array.
+     */
+    void processZeroPhase(double*, size_t);
+
+private:
+    double c_sampleRate;
+    std::vector<EDFFilterStage*> c_stages;
+    std::vector<double> c_padded; // reused by processZeroPhase
+
+    EDFFilterChain(const EDFFilterChain&);
+    EDFFilterChain& operator=(const EDFFilterChain&);
+
+    void settle(double);
+};
+
+#endif	/* _EDFFILTER_H */
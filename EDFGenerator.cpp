@@ -0,0 +1,238 @@
+/**
+ @file EDFGenerator.cpp
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#include "EDFGenerator.h"
+#include "EDFDiagnostics.h"
+#include "EDFEncode.h"
+#include "EDFUtil.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+using std::string;
+using std::vector;
+
+const double PHYSICAL_MAX = 3200;
+const double PHYSICAL_MIN = -3200;
+const int DIGITAL_MAX = 32767;
+const int DIGITAL_MIN = -32768;
+
+uint64_t mixSeed(uint64_t);
+double roundMillis(double);
+
+EDFGenerator::EDFGenerator(uint64_t seed)
+    : g_seed(seed)
+    , g_filetype(FileType::EDF)
+    , g_continuity(Continuity::CONTINUOUS)
+    , g_recordCount(60)
+    , g_recordDuration(1)
+    , g_annotationsPerRecord(0)
+    , g_gapProbability(0)
+    , g_maxGap(0)
+    , g_writeSpan(4 << 20)
+{}
+
+void EDFGenerator::setFiletype(FileType filetype, Continuity continuity) {
+    g_filetype = filetype;
+    g_continuity = filetype == FileType::EDFPLUS ? continuity : Continuity::CONTINUOUS;
+}
+
+void EDFGenerator::setRecordCount(int count) { g_recordCount = std::max(count, 0); }
+
+void EDFGenerator::setRecordDuration(double duration) { g_recordDuration = duration; }
+
+void EDFGenerator::addChannel(const string& label, int samplesPerRecord, double frequency, double amplitude, double noise) {
+    EDFGeneratorChannel channel = { label, std::max(samplesPerRecord, 1), frequency, amplitude, noise };
+    g_channels.push_back(channel);
+}
+
+void EDFGenerator::addChannels(int count, int samplesPerRecord, const string& prefix) {
+    range_loop(c, 0, count, 1)
+        addChannel(prefix + " " + std::to_string(g_channels.size()), samplesPerRecord, 1 + (c * 7) % 40);
+}
+
+void EDFGenerator::setAnnotations(int perRecord) { g_annotationsPerRecord = std::max(perRecord, 0); }
+
+void EDFGenerator::setGaps(double probability, double maxLength) {
+    g_gapProbability = probability;
+    g_maxGap = maxLength;
+}
+
+void EDFGenerator::setWriteSpan(size_t span) { g_writeSpan = span; }
+
+EDFHeader EDFGenerator::header() const {
+    EDFHeader header;
+    int signals = static_cast<int>(g_channels.size()) + (plus() ? 1 : 0);
+    header.setFiletype(g_filetype);
+    header.setContinuity(g_continuity);
+    header.setDate(EDFDate(1, 1, 20));
+    header.setStartTime(EDFTime(0, 0, 0));
+    header.setPatient(EDFPatient("synthetic", "X", "", Gender::UNKNOWN, "X"));
+    header.setRecording("synthetic");
+    header.setEquipment("EDFGenerator");
+    header.setDataRecordCount(g_recordCount);
+    header.setDataRecordDuration(g_recordDuration);
+    header.setSignalCount(signals);
+
+    int offset = 0;
+    range_loop(sig, 0, signals, 1) {
+        bool annotation = sig == static_cast<int>(g_channels.size());
+        int samples = annotation ? annotationSamples() : g_channels[sig].samplesPerRecord;
+        header.setLabel(sig, annotation ? "EDF Annotations" : g_channels[sig].label);
+        header.setTransducer(sig, "");
+        header.setPhysicalDimension(sig, annotation ? "" : "uV");
+        header.setPhysicalMax(sig, annotation ? 1 : PHYSICAL_MAX);
+        header.setPhysicalMin(sig, annotation ? -1 : PHYSICAL_MIN);
+        header.setDigitalMax(sig, DIGITAL_MAX);
+        header.setDigitalMin(sig, DIGITAL_MIN);
+        header.setPrefilter(sig, "");
+        header.setSignalSampleCount(sig, samples);
+        header.setReserved(sig, "");
+        header.setBufferOffset(sig, offset);
+        offset += samples * 2;
+    }
+    header.setDataRecordSize(offset);
+    if (plus())
+        header.setAnnotationIndex(signals - 1);
+
+    return header;
+}
+
+long long EDFGenerator::fileSize() const {
+    int signals = static_cast<int>(g_channels.size()) + (plus() ? 1 : 0);
+    return 256 + signals * 256LL + static_cast<long long>(recordSize()) * g_recordCount;
+}
+
+void EDFGenerator::generateRecord(int record, double onset, char* out) const {
+    const double gain = (PHYSICAL_MAX - PHYSICAL_MIN) / (DIGITAL_MAX - DIGITAL_MIN);
+    const double offset = PHYSICAL_MIN - gain * DIGITAL_MIN;
+    const double scale = 1 / gain;
+    vector<int16_t> digital;
+
+    range_loop(c, static_cast<size_t>(0), g_channels.size(), 1) {
+        const EDFGeneratorChannel& ch = g_channels[c];
+        int n = ch.samplesPerRecord;
+        digital.resize(n);
+
+        // the sine is advanced by rotation from a phase computed once per record
+        double cycles = ch.frequency * g_recordDuration * record;
+        double phase = 2 * M_PI * (cycles - std::floor(cycles));
+        double step = 2 * M_PI * ch.frequency * g_recordDuration / n;
+        double re = std::cos(phase), im = std::sin(phase);
+        const double stepRe = std::cos(step), stepIm = std::sin(step);
+
+        // noise comes from a generator seeded by the channel and record alone
+        uint64_t state = mixSeed(g_seed ^ mixSeed((static_cast<uint64_t>(c) << 32) ^ static_cast<uint32_t>(record)));
+        range_loop(i, 0, n, 1) {
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            double uniform = static_cast<double>((state * 2685821657736338717ULL) >> 11) / 9007199254740992.0;
+            double physical = ch.amplitude * im + ch.noise * (2 * uniform - 1);
+            double value = std::min<double>(DIGITAL_MAX, std::max<double>(DIGITAL_MIN, (physical - offset) * scale));
+            // rounds to nearest by truncating a value shifted to be positive
+            digital[i] = static_cast<int16_t>(static_cast<int>(value - DIGITAL_MIN + 0.5) + DIGITAL_MIN);
+
+            double r = re * stepRe - im * stepIm;
+            im = re * stepIm + im * stepRe;
+            re = r;
+        }
+        encodeSamples(digital.data(), out, n);
+        out += 2 * n;
+    }
+
+    if (plus()) {
+        // timekeeping annotation then events spread evenly through the record
+        int length = annotationSamples() * 2;
+        string tal = encodeTAL(onset, "");
+        range_loop(e, 0, g_annotationsPerRecord, 1)
+            tal += encodeTAL(roundMillis(onset + g_recordDuration * (e + 1) / (g_annotationsPerRecord + 1)), "Event " + std::to_string(e));
+        memset(out, 0, length);
+        memcpy(out, tal.data(), std::min<size_t>(tal.size(), length));
+    }
+}
+
+bool EDFGenerator::write(const char* path) const {
+    std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::FILE_ACCESS,
+                               string("EDFGenerator: File '") + path + "' cannot be written.");
+        return false;
+    }
+    return write(out);
+}
+
+bool EDFGenerator::write(std::ostream& out) const {
+    string head = encodeHeader(header());
+    out.write(head.data(), head.size());
+
+    // records are generated into a slab and written with one call per slab
+    int size = recordSize();
+    int spanRecords = std::max(1, static_cast<int>(std::min<size_t>(g_writeSpan / std::max(size, 1), g_recordCount)));
+    vector<char> slab(static_cast<size_t>(spanRecords) * size);
+
+    uint64_t gapState = mixSeed(g_seed ^ 0x9e3779b97f4a7c15ULL);
+    bool gaps = g_continuity == Continuity::DISCONTINUOUS && g_gapProbability > 0 && g_maxGap > 0;
+    double onset = 0;
+    for (int first = 0; first < g_recordCount && out; first += spanRecords) {
+        int count = std::min(spanRecords, g_recordCount - first);
+        range_loop(r, 0, count, 1) {
+            int record = first + r;
+            if (gaps && record > 0) {
+                gapState = mixSeed(gapState);
+                double draw = static_cast<double>(gapState >> 11) / 9007199254740992.0;
+                if (draw < g_gapProbability)
+                    onset = roundMillis(onset + g_maxGap * (1 - draw / g_gapProbability));
+            }
+            generateRecord(record, onset, slab.data() + static_cast<size_t>(r) * size);
+            onset = roundMillis(onset + g_recordDuration);
+        }
+        out.write(slab.data(), static_cast<std::streamsize>(count) * size);
+    }
+
+    if (!out) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::FILE_ACCESS,
+                               "EDFGenerator: Error writing records. Giving up...");
+        return false;
+    }
+    return true;
+}
+
+bool EDFGenerator::plus() const { return g_filetype == FileType::EDFPLUS; }
+
+int EDFGenerator::annotationSamples() const {
+    if (!plus())
+        return 0;
+
+    // size for the latest possible onset, with a millisecond fraction on every TAL
+    double last = (g_recordCount + 1) * g_recordDuration;
+    if (g_continuity == Continuity::DISCONTINUOUS && g_gapProbability > 0)
+        last += g_recordCount * g_maxGap;
+    size_t bytes = encodeTAL(std::floor(last) + 0.125, "").size();
+    if (g_annotationsPerRecord > 0)
+        bytes += g_annotationsPerRecord * encodeTAL(std::floor(last) + 0.125, "Event " + std::to_string(g_annotationsPerRecord)).size();
+    return static_cast<int>(bytes / 2 + 1);
+}
+
+int EDFGenerator::recordSize() const {
+    int samples = annotationSamples();
+    for (const EDFGeneratorChannel& ch : g_channels)
+        samples += ch.samplesPerRecord;
+    return samples * 2;
+}
+
+// splitmix64 finaliser, spreads neighbouring seeds over the whole state space
+uint64_t mixSeed(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+double roundMillis(double seconds) {
+    return std::floor(seconds * 1000 + 0.5) / 1000;
+}
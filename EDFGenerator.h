@@ -0,0 +1,152 @@
+/**
+ @file EDFGenerator.h
+ @brief Deterministic synthetic EDF and EDF+ files for load and soak testing.
+ Every channel carries a sine wave plus uniform noise. Channels may use
+ different sample rates, EDF+D files may contain gaps between records and the
+ annotation signal can hold any number of events per record. The same seed
+ and settings always produce the same bytes, and every record is computed from
+ the seed and its index alone, so files of any size are streamed to disk
+ without being held in memory.
+
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#ifndef _EDFGENERATOR_H
+#define	_EDFGENERATOR_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "EDFHeader.h"
+
+struct EDFGeneratorChannel {
+    std::string label;
+    int samplesPerRecord;
+    double frequency; // of the sine wave in hertz
+    double amplitude; // of the sine wave in physical units
+    double noise;     // peak noise in physical units
+};
+
+class EDFGenerator {
+public:
+    /**
+     Constructor for a generator with no channels, writing 60 one second
+     records of a plain EDF file.
+     @param seed Seed for every random choice made while generating.
+     */
+    EDFGenerator(uint64_t = 1);
+
+    virtual ~EDFGenerator() = default;
+
+    /**
+     Set the file type. Annotations and gaps are only written to EDF+ files.
+     @param filetype EDF or EDF+.
+     @param continuity EDF+C or EDF+D, ignored for EDF.
+     */
+    void setFiletype(FileType, Continuity = Continuity::CONTINUOUS);
+
+    /**
+     Set the number of data records to write.
+     @param count Number of records.
+     */
+    void setRecordCount(int);
+
+    /**
+     Set the duration of each data record.
+     @param duration Seconds per record.
+     */
+    void setRecordDuration(double);
+
+    /**
+     Add a channel. Channels use a physical range of +/-3200 uV over the full
+     16 bit digital range.
+     @param label Channel label.
+     @param samplesPerRecord Samples the channel stores in each record.
+     @param frequency Sine frequency in hertz.
+     @param amplitude Sine amplitude in uV.
+     @param noise Peak noise in uV.
+     */
+    void addChannel(const std::string&, int, double = 10, double = 100, double = 10);
+
+    /**
+     Add several channels labelled "<prefix> <n>" with the same layout and
+     frequencies spread between 1 and 40 Hz.
+     @param count Number of channels.
+     @param samplesPerRecord Samples each channel stores in each record.
+     @param prefix Label prefix.
+     */
+    void addChannels(int, int, const std::string& = "EEG");
+
+    /**
+     Set how many events are annotated in each record in addition to the
+     timekeeping annotation. The annotation signal is sized to fit them.
+     @param perRecord Number of events per record.
+     */
+    void setAnnotations(int);
+
+    /**
+     Insert gaps between records of EDF+D files.
+     @param probability Chance of a gap before each record after the first.
+     @param maxLength Longest gap in seconds.
+     */
+    void setGaps(double, double);
+
+    /**
+     Set the size of each write to the output.
+     @param span Bytes of records written at once, at least one record is always written.
+     */
+    void setWriteSpan(size_t);
+
+    /**
+     Build the header of the file that would be written.
+     @return Header with every signal described.
+     */
+    EDFHeader header() const;
+
+    /**
+     Get the size of the file that would be written.
+     @return Size in bytes.
+     */
+    long long fileSize() const;
+
+    /**
+     Generate one data record.
+     @param record Record index.
+     @param onset Start of the record in seconds, written to its timekeeping annotation.
+     @param out Destination for header().dataRecordSize() bytes.
+     */
+    void generateRecord(int, double, char*) const;
+
+    /**
+     Write the file.
+     @param path Output path, overwritten if it exists.
+     @return true if every byte was written.
+     */
+    bool write(const char*) const;
+
+    /**
+     Write the file to a stream.
+     @param out Binary output stream.
+     @return true if every byte was written.
+     */
+    bool write(std::ostream&) const;
+
+private:
+    uint64_t g_seed;
+    FileType g_filetype;
+    Continuity g_continuity;
+    int g_recordCount;
+    double g_recordDuration;
+    std::vector<EDFGeneratorChannel> g_channels;
+    int g_annotationsPerRecord;
+    double g_gapProbability, g_maxGap;
+    size_t g_writeSpan;
+
+    bool plus() const;
+    int annotationSamples() const;
+    int recordSize() const;
+};
+
+#endif	/* _EDFGENERATOR_H */
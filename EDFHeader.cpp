@@ -6,12 +6,16 @@
 
 #include "EDFHeader.h"
 #include "EDFUtil.h"
+#include "EDFDiagnostics.h"
 #include <algorithm>
-#include <iostream>
+#include <utility>
 
 using std::string;
-using std::cerr;
-using std::endl;
+
+void reportMissingChannel(int sigNum) {
+    EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::CHANNEL_INDEX,
+                           "Channel " + std::to_string(sigNum) + " does not exist.");
+}
 
 EDFHeader::EDFHeader()
     : h_filetype(FileType::EDF)
@@ -95,6 +99,12 @@ EDFHeader::EDFHeader(const EDFHeader& orig) {
     for (sig = 0; sig < h_signalCount; sig++) h_bufferOffset[sig] = orig.h_bufferOffset[sig];
 }
 
+EDFHeader::EDFHeader(EDFHeader&& orig) noexcept
+    : EDFHeader()
+{
+    *this = std::move(orig);
+}
+
 EDFHeader::~EDFHeader() {
     delete [] h_label;
     delete [] h_physicalMax;
@@ -175,6 +185,73 @@ EDFHeader& EDFHeader::operator=(const EDFHeader& rhs) {
     return *this;
 }
 
+EDFHeader& EDFHeader::operator=(EDFHeader&& rhs) noexcept {
+    if (this != &rhs) {
+        h_filetype = rhs.h_filetype;
+        h_continuity = rhs.h_continuity;
+        h_signalCount = rhs.h_signalCount;
+        h_date = rhs.h_date;
+        h_startTime = rhs.h_startTime;
+        h_patient = std::move(rhs.h_patient);
+        h_recording = std::move(rhs.h_recording);
+        h_recordingAdditional = std::move(rhs.h_recordingAdditional);
+        h_adminCode = std::move(rhs.h_adminCode);
+        h_technician = std::move(rhs.h_technician);
+        h_equipment = std::move(rhs.h_equipment);
+        h_dataRecordDuration = rhs.h_dataRecordDuration;
+        h_dataRecordCount = rhs.h_dataRecordCount;
+        h_dataRecordSize = rhs.h_dataRecordSize;
+        h_annotationIndex = rhs.h_annotationIndex;
+        rhs.h_signalCount = 0;
+        rhs.h_annotationIndex = -1;
+
+        delete [] h_label;
+        h_label = rhs.h_label;
+        rhs.h_label = nullptr;
+
+        delete [] h_physicalMax;
+        h_physicalMax = rhs.h_physicalMax;
+        rhs.h_physicalMax = nullptr;
+
+        delete [] h_physicalMin;
+        h_physicalMin = rhs.h_physicalMin;
+        rhs.h_physicalMin = nullptr;
+
+        delete [] h_digitalMax;
+        h_digitalMax = rhs.h_digitalMax;
+        rhs.h_digitalMax = nullptr;
+
+        delete [] h_digitalMin;
+        h_digitalMin = rhs.h_digitalMin;
+        rhs.h_digitalMin = nullptr;
+
+        delete [] h_signalSampleCount;
+        h_signalSampleCount = rhs.h_signalSampleCount;
+        rhs.h_signalSampleCount = nullptr;
+
+        delete [] h_physicalDimension;
+        h_physicalDimension = rhs.h_physicalDimension;
+        rhs.h_physicalDimension = nullptr;
+
+        delete [] h_prefilter;
+        h_prefilter = rhs.h_prefilter;
+        rhs.h_prefilter = nullptr;
+
+        delete [] h_transducer;
+        h_transducer = rhs.h_transducer;
+        rhs.h_transducer = nullptr;
+
+        delete [] h_reserved;
+        h_reserved = rhs.h_reserved;
+        rhs.h_reserved = nullptr;
+
+        delete [] h_bufferOffset;
+        h_bufferOffset = rhs.h_bufferOffset;
+        rhs.h_bufferOffset = nullptr;
+    }
+    return *this;
+}
+
 void EDFHeader::setFiletype(FileType filetype) {
     this->h_filetype = filetype;
 }
@@ -266,84 +343,84 @@ void EDFHeader::setDataRecordSize(int dataRecordSize) {
 
 void EDFHeader::setAnnotationIndex(int annotationIndex) {
     if (!signalAvailable(annotationIndex))
-        cerr << "Channel " << annotationIndex << " does not exist." << endl;
+        reportMissingChannel(annotationIndex);
 
     this->h_annotationIndex = annotationIndex;
 }
 
 void EDFHeader::setLabel(int sigNum, string label) {
     if (!signalAvailable(sigNum))
-        cerr << "Channel " << sigNum << " does not exist." << endl;
+        reportMissingChannel(sigNum);
 
     this->h_label[sigNum] = label;
 }
 
 void EDFHeader::setPhysicalMax(int sigNum, double physicalMax) {
     if (!signalAvailable(sigNum))
-        cerr << "Channel " << sigNum << " does not exist." << endl;
+        reportMissingChannel(sigNum);
 
     this->h_physicalMax[sigNum] = physicalMax;
 }
 
 void EDFHeader::setPhysicalMin(int sigNum, double physicalMin) {
     if (!signalAvailable(sigNum))
-        cerr << "Channel " << sigNum << " does not exist." << endl;
+        reportMissingChannel(sigNum);
 
     this->h_physicalMin[sigNum] = physicalMin;
 }
 
 void EDFHeader::setDigitalMax(int sigNum, int digitalMax) {
     if (!signalAvailable(sigNum))
-        cerr << "Channel " << sigNum << " does not exist." << endl;
+        reportMissingChannel(sigNum);
 
     this->h_digitalMax[sigNum] = digitalMax;
 }
 
 void EDFHeader::setDigitalMin(int sigNum, int digitalMin) {
     if (!signalAvailable(sigNum))
-        cerr << "Channel " << sigNum << " does not exist." << endl;
+        reportMissingChannel(sigNum);
 
     this->h_digitalMin[sigNum] = digitalMin;
 }
 
 void EDFHeader::setSignalSampleCount(int sigNum, int signalSampleCount) {
     if (!signalAvailable(sigNum))
-        cerr << "Channel " << sigNum << " does not exist." << endl;
+        reportMissingChannel(sigNum);
 
     this->h_signalSampleCount[sigNum] = signalSampleCount;
 }
 
 void EDFHeader::setPhysicalDimension(int sigNum, string physicalDimension) {
     if (!signalAvailable(sigNum))
-        cerr << "Channel " << sigNum << " does not exist." << endl;
+        reportMissingChannel(sigNum);
 
     this->h_physicalDimension[sigNum] = physicalDimension;
 }
 
 void EDFHeader::setPrefilter(int sigNum, string prefilter) {
     if (!signalAvailable(sigNum))
-        cerr << "Channel " << sigNum << " does not exist." << endl;
+        reportMissingChannel(sigNum);
 
     this->h_prefilter[sigNum] = prefilter;
 }
 
 void EDFHeader::setTransducer(int sigNum, string transducer) {
     if (!signalAvailable(sigNum))
-        cerr << "Channel " << sigNum << " does not exist." << endl;
+        reportMissingChannel(sigNum);
 
     this->h_transducer[sigNum] = transducer;
 }
 
 void EDFHeader::setReserved(int sigNum, string reserved) {
     if (!signalAvailable(sigNum))
-        cerr << "Channel " << sigNum << " does not exist." << endl;
+        reportMissingChannel(sigNum);
 
     this->h_reserved[sigNum] = reserved;
 }
 
 void EDFHeader::setBufferOffset(int sigNum, int bufferOffset) {
     if (!signalAvailable(sigNum))
-        cerr << "Channel " << sigNum << " does not exist." << endl;
+        reportMissingChannel(sigNum);
 
     this->h_bufferOffset[sigNum] = bufferOffset;
 }
@@ -459,6 +536,17 @@ bool EDFHeader::hasAnnotations() const {
     return h_annotationIndex > -1;
 }
 
+double EDFHeader::gain(int sigNum) const {
+    // guard against a degenerate digital range
+    if (digitalMax(sigNum) == digitalMin(sigNum))
+        return 1;
+    return (physicalMax(sigNum) - physicalMin(sigNum)) / (digitalMax(sigNum) - digitalMin(sigNum));
+}
+
+double EDFHeader::offset(int sigNum) const {
+    return physicalMin(sigNum) - gain(sigNum) * digitalMin(sigNum);
+}
+
 double EDFHeader::recordingTime() const {
     return h_dataRecordCount * h_dataRecordDuration;
 }
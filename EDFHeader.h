@@ -24,8 +24,10 @@ class EDFHeader {
 public:
     EDFHeader();
     EDFHeader(const EDFHeader&);
+    EDFHeader(EDFHeader&&) noexcept;    // takes the signal arrays, leaving no signals behind
     virtual ~EDFHeader();
     EDFHeader& operator=(const EDFHeader&);
+    EDFHeader& operator=(EDFHeader&&) noexcept;
 
     void setFiletype(FileType);
     void setContinuity(Continuity);
@@ -83,6 +85,8 @@ public:
     std::string transducer(int) const;
     std::string reserved(int) const;
     int    bufferOffset(int) const;
+    double gain(int) const;   // physical = gain * digital + offset
+    double offset(int) const;
 
     bool   hasAnnotations() const;
     double recordingTime() const;
@@ -0,0 +1,104 @@
+/**
+ @file EDFHistogram.cpp
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#include "EDFHistogram.h"
+#include <algorithm>
+#include <limits>
+
+EDFHistogram::EDFHistogram(int bins, int digitalMin, int digitalMax, double gain, double offset)
+    : h_digitalMin(std::min(digitalMin, digitalMax))
+    , h_digitalMax(std::max(digitalMin, digitalMax))
+    , h_gain(gain)
+    , h_offset(offset)
+    , h_below(0)
+    , h_above(0)
+{
+    // a bin is never narrower than one digital value
+    long long values = static_cast<long long>(h_digitalMax) - h_digitalMin + 1;
+    bins = static_cast<int>(std::max(1LL, std::min(static_cast<long long>(bins), values)));
+    h_counts.assign(bins, 0);
+    h_scale = static_cast<double>(bins) / values;
+}
+
+void EDFHistogram::add(const int16_t* vals, size_t length) {
+    int last = bins() - 1;
+    unsigned long long* counts = h_counts.data();
+    for (size_t i = 0; i < length; i++) {
+        int v = vals[i];
+        if (v < h_digitalMin) {
+            h_below++;
+        } else if (v > h_digitalMax) {
+            h_above++;
+        } else {
+            int bin = static_cast<int>((v - h_digitalMin) * h_scale);
+            counts[bin < last ? bin : last]++;
+        }
+    }
+}
+
+bool EDFHistogram::merge(const EDFHistogram& other) {
+    if (other.h_counts.size() != h_counts.size() || other.h_digitalMin != h_digitalMin ||
+        other.h_digitalMax != h_digitalMax || other.h_gain != h_gain || other.h_offset != h_offset)
+        return false;
+
+    for (size_t b = 0; b < h_counts.size(); b++)
+        h_counts[b] += other.h_counts[b];
+    h_below += other.h_below;
+    h_above += other.h_above;
+    return true;
+}
+
+int EDFHistogram::bins() const { return static_cast<int>(h_counts.size()); }
+
+unsigned long long EDFHistogram::count(int bin) const { return h_counts[bin]; }
+
+unsigned long long EDFHistogram::total() const {
+    unsigned long long sum = h_below + h_above;
+    for (unsigned long long c : h_counts)
+        sum += c;
+    return sum;
+}
+
+unsigned long long EDFHistogram::below() const { return h_below; }
+
+unsigned long long EDFHistogram::above() const { return h_above; }
+
+double EDFHistogram::digitalEdge(int bin) const {
+    return h_digitalMin + bin / h_scale;
+}
+
+double EDFHistogram::edge(int bin) const {
+    return h_gain * digitalEdge(bin) + h_offset;
+}
+
+double EDFHistogram::quantile(double q) const {
+    unsigned long long n = total();
+    if (n == 0)
+        return std::numeric_limits<double>::quiet_NaN();
+
+    // a negative gain runs the physical values backwards through the bins
+    q = std::min(1.0, std::max(0.0, q));
+    if (h_gain < 0)
+        q = 1 - q;
+    double target = q * n;
+
+    double digital = h_digitalMax + 1;
+    double cumulative = static_cast<double>(h_below);
+    if (target <= cumulative) {
+        digital = h_digitalMin;
+    } else {
+        for (int b = 0; b < bins(); b++) {
+            double next = cumulative + h_counts[b];
+            if (target <= next && h_counts[b] > 0) {
+                double fraction = (target - cumulative) / h_counts[b];
+                digital = digitalEdge(b) + fraction * (digitalEdge(b + 1) - digitalEdge(b));
+                break;
+            }
+            cumulative = next;
+        }
+    }
+    return h_gain * digital + h_offset;
+}
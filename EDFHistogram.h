@@ -0,0 +1,103 @@
+/**
+ @file EDFHistogram.h
+ @brief Fixed-bin amplitude histogram over a channel's digital range.
+ Digital samples are binned with integer arithmetic and bin edges are
+ reported in physical units through the channel's gain and offset.
+ Samples outside the declared digital range are counted separately.
+ Histograms with the same layout merge by adding counts, so partial
+ histograms from threads, windows or files combine exactly.
+
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#ifndef _EDFHISTOGRAM_H
+#define	_EDFHISTOGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class EDFHistogram {
+public:
+    /**
+     Constructor. Bins are equal slices of the digital range.
+     @param bins Number of bins, at most the number of digital values.
+     @param digitalMin Lowest digital value, the low edge of the first bin.
+     @param digitalMax Highest digital value, inside the last bin.
+     @param gain Physical units per digital step.
+     @param offset Physical value of digital zero.
+     */
+    EDFHistogram(int, int, int, double = 1, double = 0);
+
+    /**
+     Count digital samples.
+     @param vals Samples to count.
+     @param length Length of vals array.
+     */
+    void add(const int16_t*, size_t);
+
+    /**
+     Add the counts of another histogram.
+     @param other Histogram with the same bins, digital range, gain and offset.
+     @return false, leaving this histogram unchanged, if the layouts differ.
+     */
+    bool merge(const EDFHistogram&);
+
+    /**
+     Get the number of bins.
+     @return Bin count.
+     */
+    int bins() const;
+
+    /**
+     Get the number of samples in a bin.
+     @param bin Bin index.
+     @return Samples counted in the bin.
+     */
+    unsigned long long count(int) const;
+
+    /**
+     Get the number of samples counted, including those out of range.
+     @return Total samples.
+     */
+    unsigned long long total() const;
+
+    /**
+     Get the number of samples below the digital minimum.
+     @return Samples not in any bin.
+     */
+    unsigned long long below() const;
+
+    /**
+     Get the number of samples above the digital maximum.
+     @return Samples not in any bin.
+     */
+    unsigned long long above() const;
+
+    /**
+     Get the physical value of the low edge of a bin.
+     @param bin Bin index, or bins() for the high edge of the last bin.
+     @return Edge in physical units.
+     */
+    double edge(int) const;
+
+    /**
+     Estimate a quantile by interpolating inside the bin that holds it.
+     Out of range samples count as the range limits.
+     @param q Fraction of the samples, 0 to 1.
+     @return Physical value, NaN if nothing was counted.
+     */
+    double quantile(double) const;
+
+private:
+    int h_digitalMin, h_digitalMax;
+    double h_gain, h_offset;
+    double h_scale; // bins per digital step
+    unsigned long long h_below, h_above;
+    std::vector<unsigned long long> h_counts;
+
+    double digitalEdge(int) const;
+};
+
+#endif	/* _EDFHISTOGRAM_H */
@@ -0,0 +1,109 @@
+/**
+ @file EDFInstrument.h
+ @brief Opt-in counters and trace hooks for the read paths of EDFFile.
+ Instrumentation is compiled in only when EDFLIB_INSTRUMENTATION is defined
+ (cmake -DEDFLIB_INSTRUMENTATION=ON). Otherwise the EDF_COUNT, EDF_SPAN and
+ EDF_TIMER macros expand to nothing, stats stay zero and tracers are never
+ called, so a normal build pays nothing for them.
+
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#ifndef _EDFINSTRUMENT_H
+#define	_EDFINSTRUMENT_H
+
+#include <chrono>
+
+/**
+ A snapshot of the work an EDFFile has done since it was opened or its
+ stats were last reset.
+ */
+struct EDFStats {
+    unsigned long long bytesRead;    // record bytes read from the file
+    unsigned long long recordsRead;  // data records read from the file
+    unsigned long long readCalls;    // read requests issued, one per slab, chunk or batched span
+    unsigned long long allocations;  // buffers and result objects allocated
+    unsigned long long cacheHits;    // read-ahead chunks ready when needed and windows served by a shared read
+    double decodeSeconds;            // spent converting record bytes to samples
+    double annotationSeconds;        // spent parsing the annotation signal
+};
+
+/**
+ Receives the begin and end of each traced operation. Spans nest and are
+ reported on the thread that runs the operation.
+ */
+class EDFTracer {
+public:
+    virtual ~EDFTracer() = default;
+
+    /**
+     Called when an operation starts.
+     @param name Static name of the operation, e.g. "extract".
+     */
+    virtual void begin(const char*) = 0;
+
+    /**
+     Called when an operation ends.
+     @param name The name passed to the matching begin.
+     */
+    virtual void end(const char*) = 0;
+};
+
+/**
+ The stats and tracer of one file, handed down to the functions that read it.
+ */
+struct EDFInstrument {
+    EDFStats stats;
+    EDFTracer* tracer;
+};
+
+/**
+ Scope guard that reports a span to the tracer and optionally adds its
+ duration to a stats field. A null name times without tracing.
+ */
+class EDFTraceSpan {
+public:
+    EDFTraceSpan(EDFInstrument* instrument, const char* name, double* seconds = nullptr)
+        : instrument(instrument)
+        , name(name)
+        , seconds(seconds)
+    {
+        if (instrument != nullptr && instrument->tracer != nullptr && name != nullptr)
+            instrument->tracer->begin(name);
+        if (seconds != nullptr)
+            started = std::chrono::steady_clock::now();
+    }
+
+    ~EDFTraceSpan() {
+        if (seconds != nullptr)
+            *seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        if (instrument != nullptr && instrument->tracer != nullptr && name != nullptr)
+            instrument->tracer->end(name);
+    }
+
+private:
+    EDFInstrument* instrument;
+    const char* name;
+    double* seconds;
+    std::chrono::steady_clock::time_point started;
+};
+
+#define EDF_CONCAT_(a, b) a##b
+#define EDF_CONCAT(a, b) EDF_CONCAT_(a, b)
+
+#ifdef EDFLIB_INSTRUMENTATION
+// i instrument pointer, may be null; f EDFStats field; n amount; s span name
+#define EDF_COUNT(i, f, n) do { if ((i) != nullptr) (i)->stats.f += (n); } while (0)
+#define EDF_SPAN(i, s) EDFTraceSpan EDF_CONCAT(edfSpan, __LINE__)((i), (s))
+#define EDF_TIMED_SPAN(i, s, f) EDFTraceSpan EDF_CONCAT(edfSpan, __LINE__)((i), (s), (i) != nullptr ? &(i)->stats.f : nullptr)
+#define EDF_TIMER(i, f) EDF_TIMED_SPAN(i, nullptr, f)
+#else
+// the instrument and amount are still named, unevaluated, so values kept for them are not unused
+#define EDF_COUNT(i, f, n) do { (void)sizeof(i); (void)sizeof(n); } while (0)
+#define EDF_SPAN(i, s) (void)sizeof(i)
+#define EDF_TIMED_SPAN(i, s, f) (void)sizeof(i)
+#define EDF_TIMER(i, f) (void)sizeof(i)
+#endif
+
+#endif	/* _EDFINSTRUMENT_H */
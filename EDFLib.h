@@ -3,8 +3,26 @@
 
 #include "EDFFile.h"
 #include "EDFUtil.h"
+#include "EDFDiagnostics.h"
 #include "EDFHeader.h"
 #include "EDFAnnotation.h"
 #include "EDFSignalData.h"
+#include "EDFSignalSamples.h"
+#include "EDFArena.h"
+#include "EDFMoments.h"
+#include "EDFEpochTable.h"
+#include "EDFHistogram.h"
+#include "EDFQuantileSketch.h"
+#include "EDFFFT.h"
+#include "EDFWelch.h"
+#include "EDFFilter.h"
+#include "EDFResampler.h"
+#include "EDFMatrix.h"
+#include "EDFMontage.h"
+#include "EDFGenerator.h"
+#include "EDFWriter.h"
+#include "EDFContainer.h"
+#include "EDFColumns.h"
+#include "EDFRewrite.h"
 
 #endif
@@ -0,0 +1,37 @@
+/**
+ @file EDFMatrix.cpp
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#include "EDFMatrix.h"
+
+using std::string;
+using std::vector;
+
+EDFMatrix::EDFMatrix(const vector<int>& channels, size_t samples, double rate, double start, const vector<string>& labels)
+    : m_channels(channels)
+    , m_labels(labels)
+    , m_samples(samples)
+    , m_rate(rate)
+    , m_start(start)
+    , m_data(channels.size() * samples, 0)
+{}
+
+int EDFMatrix::channelCount() const { return static_cast<int>(m_channels.size()); }
+
+size_t EDFMatrix::sampleCount() const { return m_samples; }
+
+int EDFMatrix::channel(int r) const { return m_channels[r]; }
+
+string EDFMatrix::label(int r) const { return static_cast<size_t>(r) < m_labels.size() ? m_labels[r] : string(); }
+
+double EDFMatrix::rate() const { return m_rate; }
+
+double EDFMatrix::start() const { return m_start; }
+
+const double* EDFMatrix::row(int r) const { return m_data.data() + static_cast<size_t>(r) * m_samples; }
+
+double* EDFMatrix::row(int r) { return m_data.data() + static_cast<size_t>(r) * m_samples; }
+
+double EDFMatrix::at(int r, size_t sample) const { return m_data[static_cast<size_t>(r) * m_samples + sample]; }
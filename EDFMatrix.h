@@ -0,0 +1,102 @@
+/**
+ @file EDFMatrix.h
+ @brief Samples of several channels on one common time base.
+ Each channel's samples are stored contiguously, one row per channel, and
+ sample i of every row lies at start() + i / rate().
+
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#ifndef _EDFMATRIX_H
+#define	_EDFMATRIX_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ Order of the samples of several channels in one buffer.
+ */
+enum class EDFLayout {
+    CHANNEL_MAJOR, // [channel x time], each channel's samples consecutive
+    TIME_MAJOR     // [time x channel], the channels of each instant consecutive
+};
+
+class EDFMatrix {
+public:
+    /**
+     Constructor.
+     @param channels Signal index of each row, -1 for a derived row.
+     @param samples Samples per row.
+     @param rate Samples per second of every row.
+     @param start Time of the first sample in fractional seconds.
+     @param labels Name of each row, or empty to leave rows unnamed.
+     */
+    EDFMatrix(const std::vector<int>&, size_t, double, double,
+              const std::vector<std::string>& = std::vector<std::string>());
+
+    /**
+     Get the number of channels.
+     @return Number of rows.
+     */
+    int channelCount() const;
+
+    /**
+     Get the number of samples in each channel.
+     @return Number of columns.
+     */
+    size_t sampleCount() const;
+
+    /**
+     Get the signal index of a row.
+     @param row Matrix row.
+     @return Signal index in the file, or -1 if the row is derived from
+     several signals.
+     */
+    int channel(int) const;
+
+    /**
+     Get the name of a row.
+     @param row Matrix row.
+     @return Channel label or derivation name, empty if rows are unnamed.
+     */
+    std::string label(int) const;
+
+    /**
+     Get the common sample rate.
+     @return Samples per second.
+     */
+    double rate() const;
+
+    /**
+     Get the time of the first sample.
+     @return Fractional seconds from the start of the recording.
+     */
+    double start() const;
+
+    /**
+     Get the samples of one channel.
+     @param row Matrix row.
+     @return sampleCount() consecutive samples.
+     */
+    const double* row(int) const;
+    double* row(int);
+
+    /**
+     Get one sample.
+     @param row Matrix row.
+     @param sample Sample index.
+     @return Sample in physical units.
+     */
+    double at(int, size_t) const;
+
+private:
+    std::vector<int> m_channels;
+    std::vector<std::string> m_labels;
+    size_t m_samples;
+    double m_rate, m_start;
+    std::vector<double> m_data; // row major
+};
+
+#endif	/* _EDFMATRIX_H */
@@ -0,0 +1,153 @@
+/**
+ @file EDFMoments.cpp
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#include "EDFMoments.h"
+#include <algorithm>
+#include <cmath>
+
+// values per block, small enough that a block's two passes stay in L1
+const size_t MOMENT_BLOCK = 256;
+// independent accumulators per pass, lets the compiler keep them in vector lanes
+const int LANES = 8;
+
+double blockSum(const double*, size_t);
+double blockSum(const int16_t*, size_t);
+template <typename T>
+void centralSums(const T*, size_t, double, double&, double&, double&);
+
+EDFMoments::EDFMoments()
+    : n(0), m1(0), M2(0), M3(0), M4(0)
+{}
+
+void EDFMoments::add(const double* vals, size_t length) {
+    addBlocks(vals, length);
+}
+
+void EDFMoments::add(const int16_t* vals, size_t length) {
+    addBlocks(vals, length);
+}
+
+template <typename T>
+void EDFMoments::addBlocks(const T* vals, size_t length) {
+    for (size_t first = 0; first < length; first += MOMENT_BLOCK) {
+        size_t count = std::min(MOMENT_BLOCK, length - first);
+        EDFMoments block;
+        block.n = static_cast<double>(count);
+        block.m1 = blockSum(vals + first, count) / count;
+        centralSums(vals + first, count, block.m1, block.M2, block.M3, block.M4);
+        merge(block);
+    }
+}
+
+void EDFMoments::merge(const EDFMoments& other) {
+    if (other.n == 0)
+        return;
+    if (n == 0) {
+        *this = other;
+        return;
+    }
+
+    // pairwise combination of two moment sets
+    double na = n, nb = other.n, nn = na + nb;
+    double delta = other.m1 - m1;
+    double delta_n = delta / nn;
+    double delta_n2 = delta_n * delta_n;
+    double term1 = delta * delta_n * na * nb;
+
+    M4 += other.M4 + term1 * delta_n2 * (na * na - na * nb + nb * nb)
+        + 6 * delta_n2 * (na * na * other.M2 + nb * nb * M2)
+        + 4 * delta_n * (na * other.M3 - nb * M3);
+    M3 += other.M3 + term1 * delta_n * (na - nb) + 3 * delta_n * (na * other.M2 - nb * M2);
+    M2 += other.M2 + term1;
+    m1 += delta_n * nb;
+    n = nn;
+}
+
+EDFMoments EDFMoments::scaled(double gain, double offset) const {
+    EDFMoments result(*this);
+    result.m1 = gain * m1 + offset;
+    result.M2 = gain * gain * M2;
+    result.M3 = gain * gain * gain * M3;
+    result.M4 = gain * gain * gain * gain * M4;
+    return result;
+}
+
+double EDFMoments::count() const { return n; }
+
+double EDFMoments::mean() const { return m1; }
+
+double EDFMoments::centralSum(int order) const {
+    switch (order) {
+        case 2: return M2;
+        case 3: return M3;
+        case 4: return M4;
+        default: return 0;
+    }
+}
+
+double EDFMoments::variance() const {
+    return M2 / (n - 1);
+}
+
+double EDFMoments::skewness() const {
+    return sqrt(n) * M3 / pow(M2, 1.5);
+}
+
+double EDFMoments::kurtosis() const {
+    return n * M4 / (M2 * M2); // for coefficient of excess subtract three (3) from the kurtosis
+}
+
+double blockSum(const double* x, size_t count) {
+    double sum[LANES] = {0};
+    size_t i = 0;
+    for (; i + LANES <= count; i += LANES)
+        for (int l = 0; l < LANES; l++)
+            sum[l] += x[i + l];
+    for (; i < count; i++)
+        sum[0] += x[i];
+
+    double total = 0;
+    for (int l = 0; l < LANES; l++)
+        total += sum[l];
+    return total;
+}
+
+double blockSum(const int16_t* x, size_t count) {
+    // a block of 16 bit values cannot overflow a 32 bit sum, so this one is exact
+    int32_t total = 0;
+    for (size_t i = 0; i < count; i++)
+        total += x[i];
+    return total;
+}
+
+template <typename T>
+void centralSums(const T* x, size_t count, double mean, double& M2, double& M3, double& M4) {
+    double s2[LANES] = {0}, s3[LANES] = {0}, s4[LANES] = {0};
+    size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        for (int l = 0; l < LANES; l++) {
+            double d = x[i + l] - mean;
+            double d2 = d * d;
+            s2[l] += d2;
+            s3[l] += d2 * d;
+            s4[l] += d2 * d2;
+        }
+    }
+    for (; i < count; i++) {
+        double d = x[i] - mean;
+        double d2 = d * d;
+        s2[0] += d2;
+        s3[0] += d2 * d;
+        s4[0] += d2 * d2;
+    }
+
+    M2 = M3 = M4 = 0;
+    for (int l = 0; l < LANES; l++) {
+        M2 += s2[l];
+        M3 += s3[l];
+        M4 += s4[l];
+    }
+}
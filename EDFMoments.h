@@ -0,0 +1,102 @@
+/**
+ @file EDFMoments.h
+ @brief Count, mean and second to fourth central moment sums of a sequence.
+ Values are taken in blocks. Each block's moments are computed with two
+ branch-free passes (block mean, then centred power sums) that the compiler
+ can vectorise, and blocks are combined with the pairwise update formulas of
+ Chan et al. and Pebay. This keeps the numerical stability of a per-sample
+ Welford update without its division per sample or its serial dependency.
+
+ Two moment sets can be merged, so partial results from different threads,
+ windows or files combine exactly as if the values had been added together.
+
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#ifndef _EDFMOMENTS_H
+#define	_EDFMOMENTS_H
+
+#include <cstddef>
+#include <cstdint>
+
+class EDFMoments {
+public:
+    EDFMoments();
+
+    /**
+     Add values, a block at a time.
+     @param vals Values to add.
+     @param length Length of vals array.
+     */
+    void add(const double*, size_t);
+
+    /**
+     Add digital samples, a block at a time. Block sums are exact integers.
+     @param vals Samples to add.
+     @param length Length of vals array.
+     */
+    void add(const int16_t*, size_t);
+
+    /**
+     Combine with the moments of another sequence.
+     @param other Moments to fold into this object.
+     */
+    void merge(const EDFMoments&);
+
+    /**
+     Get the moments of the sequence after a linear change of units, such as
+     digital to physical values.
+     @param gain Multiplier applied to every value.
+     @param offset Constant added to every value.
+     @return Moments of gain * value + offset.
+     */
+    EDFMoments scaled(double, double) const;
+
+    /**
+     Get the number of values added.
+     @return Count of values.
+     */
+    double count() const;
+
+    /**
+     Get the arithmetic mean.
+     @return Mean of the values, 0 if there are none.
+     */
+    double mean() const;
+
+    /**
+     Get the sum of the n-th power of the deviations from the mean.
+     @param order 2, 3 or 4.
+     @return Central moment sum.
+     */
+    double centralSum(int) const;
+
+    /**
+     Get the sample variance.
+     @return Second central moment sum over n - 1.
+     */
+    double variance() const;
+
+    /**
+     Get the sample skewness.
+     @return sqrt(n) * M3 / M2^1.5.
+     */
+    double skewness() const;
+
+    /**
+     Get the sample kurtosis. Subtract three for the excess kurtosis.
+     @return n * M4 / M2^2.
+     */
+    double kurtosis() const;
+
+private:
+    double n;
+    double m1;         // mean
+    double M2, M3, M4; // central moment sums
+
+    template <typename T>
+    void addBlocks(const T*, size_t);
+};
+
+#endif	/* _EDFMOMENTS_H */
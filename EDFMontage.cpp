@@ -0,0 +1,75 @@
+/**
+ @file EDFMontage.cpp
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#include "EDFMontage.h"
+#include "EDFUtil.h"
+#include <algorithm>
+#include <cctype>
+
+using std::string;
+using std::vector;
+
+string foldLabel(const string&);
+
+EDFMontage& EDFMontage::add(const string& name, const vector<EDFMontageTerm>& terms) {
+    vector<EDFMontageTerm> combined;
+    for (const EDFMontageTerm& term : terms) {
+        string key = foldLabel(term.label);
+        auto same = std::find_if(combined.begin(), combined.end(),
+                                 [&](const EDFMontageTerm& t) { return foldLabel(t.label) == key; });
+        if (same != combined.end())
+            same->weight += term.weight;
+        else
+            combined.push_back(term);
+    }
+
+    names.push_back(name);
+    derivations.push_back(combined);
+    return *this;
+}
+
+EDFMontage& EDFMontage::addBipolar(const string& active, const string& reference) {
+    vector<EDFMontageTerm> terms;
+    terms.push_back(EDFMontageTerm{active, 1});
+    terms.push_back(EDFMontageTerm{reference, -1});
+    return add(active + "-" + reference, terms);
+}
+
+EDFMontage& EDFMontage::addBipolarChain(const vector<string>& labels) {
+    range_loop(i, static_cast<size_t>(1), labels.size(), 1)
+        addBipolar(labels[i - 1], labels[i]);
+    return *this;
+}
+
+EDFMontage& EDFMontage::addAverageReference(const string& active, const vector<string>& references) {
+    vector<EDFMontageTerm> terms;
+    terms.push_back(EDFMontageTerm{active, 1});
+    for (const string& reference : references)
+        terms.push_back(EDFMontageTerm{reference, -1.0 / references.size()});
+    return add(active + "-avg", terms);
+}
+
+int EDFMontage::size() const { return static_cast<int>(derivations.size()); }
+
+const string& EDFMontage::name(int derivation) const { return names[derivation]; }
+
+const vector<EDFMontageTerm>& EDFMontage::terms(int derivation) const { return derivations[derivation]; }
+
+int EDFMontage::findSignal(const EDFHeader* header, const string& label) {
+    string key = foldLabel(label);
+    range_loop(s, 0, header->signalCount(), 1) {
+        if (s != header->annotationIndex() && foldLabel(header->label(s)) == key)
+            return s;
+    }
+    return -1;
+}
+
+string foldLabel(const string& label) {
+    string folded = trim(label);
+    for (char& c : folded)
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return folded;
+}
@@ -0,0 +1,94 @@
+/**
+ @file EDFMontage.h
+ @brief Derived channels defined as weighted sums of recorded channels.
+ Each derivation names the channels it uses by label, so one montage applies
+ to any recording with those labels. Bipolar pairs such as Fp1-F3 and
+ average references such as Cz-avg are built by helpers; any other linear
+ combination can be added term by term.
+
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#ifndef _EDFMONTAGE_H
+#define	_EDFMONTAGE_H
+
+#include <string>
+#include <vector>
+#include "EDFHeader.h"
+
+struct EDFMontageTerm {
+    std::string label; // of the recorded channel
+    double weight;
+};
+
+class EDFMontage {
+public:
+    /**
+     Add a derivation. Terms naming the same label are combined.
+     @param name Name of the derived channel.
+     @param terms Recorded channels and their weights.
+     @return This montage.
+     */
+    EDFMontage& add(const std::string&, const std::vector<EDFMontageTerm>&);
+
+    /**
+     Add the difference of two channels, named "active-reference".
+     @param active Label of the channel taken positive.
+     @param reference Label of the channel taken negative.
+     @return This montage.
+     */
+    EDFMontage& addBipolar(const std::string&, const std::string&);
+
+    /**
+     Add a bipolar derivation between each neighbouring pair of a chain, as in
+     the longitudinal Fp1-F3, F3-C3, C3-P3, P3-O1.
+     @param labels Channel labels in chain order.
+     @return This montage.
+     */
+    EDFMontage& addBipolarChain(const std::vector<std::string>&);
+
+    /**
+     Add a channel less the mean of several channels, named "active-avg".
+     The active channel may be one of the references.
+     @param active Label of the channel taken positive.
+     @param references Labels of the channels averaged.
+     @return This montage.
+     */
+    EDFMontage& addAverageReference(const std::string&, const std::vector<std::string>&);
+
+    /**
+     Get the number of derivations.
+     @return Derivation count.
+     */
+    int size() const;
+
+    /**
+     Get the name of a derivation.
+     @param derivation Derivation index.
+     @return Derived channel name.
+     */
+    const std::string& name(int) const;
+
+    /**
+     Get the terms of a derivation.
+     @param derivation Derivation index.
+     @return Labels and weights, one per distinct label.
+     */
+    const std::vector<EDFMontageTerm>& terms(int) const;
+
+    /**
+     Find the signal a label refers to. Labels match without regard to case
+     or surrounding spaces and the annotation signal never matches.
+     @param header Header of the recording.
+     @param label Channel label.
+     @return Signal index, or -1 if no signal carries the label.
+     */
+    static int findSignal(const EDFHeader*, const std::string&);
+
+private:
+    std::vector<std::string> names;
+    std::vector<std::vector<EDFMontageTerm> > derivations;
+};
+
+#endif	/* _EDFMONTAGE_H */
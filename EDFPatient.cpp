@@ -6,6 +6,7 @@
 
 #include "EDFPatient.h"
 #include "EDFUtil.h"
+#include <utility>
 
 using std::string;
 
@@ -34,6 +35,14 @@ EDFPatient::EDFPatient(const EDFPatient& orig) {
     p_birthdate  = orig.p_birthdate;
 }
 
+EDFPatient::EDFPatient(EDFPatient&& orig) noexcept {
+    p_code       = std::move(orig.p_code);
+    p_name       = std::move(orig.p_name);
+    p_additional = std::move(orig.p_additional);
+    p_gender     = orig.p_gender;
+    p_birthdate  = std::move(orig.p_birthdate);
+}
+
 EDFPatient& EDFPatient::operator=(const EDFPatient& rhs) {
     if (this != &rhs) {
         p_code       = rhs.p_code;
@@ -46,6 +55,18 @@ EDFPatient& EDFPatient::operator=(const EDFPatient& rhs) {
     return *this;
 }
 
+EDFPatient& EDFPatient::operator=(EDFPatient&& rhs) noexcept {
+    if (this != &rhs) {
+        p_code       = std::move(rhs.p_code);
+        p_name       = std::move(rhs.p_name);
+        p_additional = std::move(rhs.p_additional);
+        p_gender     = rhs.p_gender;
+        p_birthdate  = std::move(rhs.p_birthdate);
+    }
+
+    return *this;
+}
+
 std::ostream& operator<<(std::ostream& s, EDFPatient p) {
     s << "Code           | " << p.p_code << std::endl;
     s << "Name           | " << p.p_name << std::endl;
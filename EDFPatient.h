@@ -20,9 +20,11 @@ public:
     EDFPatient();
     EDFPatient(std::string, std::string, std::string, Gender, std::string);
     EDFPatient(const EDFPatient&);
+    EDFPatient(EDFPatient&&) noexcept;
     virtual ~EDFPatient() {};
 
     EDFPatient& operator=(const EDFPatient&);
+    EDFPatient& operator=(EDFPatient&&) noexcept;
     friend std::ostream& operator<<(std::ostream&, EDFPatient);
 
     std::string code() const;
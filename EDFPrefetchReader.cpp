@@ -0,0 +1,143 @@
+/**
+ @file EDFPrefetchReader.cpp
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#include "EDFPrefetchReader.h"
+#include "EDFDiagnostics.h"
+#include "EDFUtil.h"
+#include <algorithm>
+
+using std::string;
+using std::vector;
+
+EDFPrefetchReader::EDFPrefetchReader(const string& path, long long dataOffset, int recordSize, int depth, size_t chunkSize)
+    : r_path(path)
+    , r_dataOffset(dataOffset)
+    , r_recordSize(recordSize)
+    , r_recordsPerChunk(1)
+    , r_head(0), r_filled(0)
+    , r_holding(false)
+    , r_ready(false)
+    , r_done(true), r_failed(false), r_cancel(false)
+{
+    if (depth < 2)
+        depth = 2;
+    if (recordSize > 0 && chunkSize / recordSize > 1)
+        r_recordsPerChunk = static_cast<int>(chunkSize / recordSize);
+
+    r_buffers.resize(depth);
+    r_counts.resize(depth, 0);
+    for (auto& buffer : r_buffers)
+        buffer.resize(static_cast<size_t>(r_recordsPerChunk) * r_recordSize);
+}
+
+EDFPrefetchReader::~EDFPrefetchReader() {
+    stop();
+}
+
+bool EDFPrefetchReader::start(int firstRecord, int endRecord) {
+    stop();
+
+    if (!r_stream.is_open())
+        r_stream.open(r_path.c_str(), std::ios::in | std::ios::binary);
+    if (!r_stream.is_open()) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::FILE_ACCESS,
+                               "EDFPrefetchReader: File '" + r_path + "' cannot be read.");
+        return false;
+    }
+    r_stream.clear();
+
+    r_head = r_filled = 0;
+    r_holding = false;
+    r_done = r_failed = r_cancel = false;
+    r_worker = std::thread(&EDFPrefetchReader::fill, this, firstRecord, endRecord);
+    return true;
+}
+
+void EDFPrefetchReader::fill(int firstRecord, int endRecord) {
+    int slot = 0;
+    r_stream.seekg(r_dataOffset + static_cast<long long>(r_recordSize) * firstRecord, std::ios::beg);
+
+    range_loop(record, firstRecord, endRecord, r_recordsPerChunk) {
+        {
+            std::unique_lock<std::mutex> lock(r_mutex);
+            // the slot at the consumer's head is off limits while it is being decoded
+            r_spaceReady.wait(lock, [this] {
+                return r_cancel || r_filled + (r_holding ? 1 : 0) < (int)r_buffers.size();
+            });
+            if (r_cancel)
+                break;
+        }
+
+        // read outside of the lock so the consumer can keep decoding
+        int count = std::min(r_recordsPerChunk, endRecord - record);
+        bool ok = static_cast<bool>(r_stream.read(r_buffers[slot].data(), static_cast<std::streamsize>(count) * r_recordSize));
+
+        std::lock_guard<std::mutex> lock(r_mutex);
+        if (!ok) {
+            r_failed = true;
+            break;
+        }
+        r_counts[slot] = count;
+        r_filled++;
+        slot = (slot + 1) % (int)r_buffers.size();
+        r_dataReady.notify_one();
+    }
+
+    std::lock_guard<std::mutex> lock(r_mutex);
+    r_done = true;
+    r_dataReady.notify_one();
+}
+
+const char* EDFPrefetchReader::next(int& recordCount) {
+    std::unique_lock<std::mutex> lock(r_mutex);
+    // hand the previous chunk back to the background thread
+    if (r_holding) {
+        r_holding = false;
+        r_head = (r_head + 1) % (int)r_buffers.size();
+        r_spaceReady.notify_one();
+    }
+
+    r_ready = r_filled > 0;
+    r_dataReady.wait(lock, [this] { return r_filled > 0 || r_done; });
+    if (r_filled == 0) {
+        recordCount = 0;
+        if (r_failed)
+            EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::RECORD_READ,
+                                   "EDFPrefetchReader: Error reading records from file. Giving up...");
+        return nullptr;
+    }
+
+    r_filled--;
+    r_holding = true;
+    recordCount = r_counts[r_head];
+    return r_buffers[r_head].data();
+}
+
+void EDFPrefetchReader::stop() {
+    {
+        std::lock_guard<std::mutex> lock(r_mutex);
+        r_cancel = true;
+        r_spaceReady.notify_one();
+    }
+    if (r_worker.joinable())
+        r_worker.join();
+}
+
+bool EDFPrefetchReader::failed() const {
+    std::lock_guard<std::mutex> lock(r_mutex);
+    return r_failed;
+}
+
+bool EDFPrefetchReader::wasReady() const {
+    std::lock_guard<std::mutex> lock(r_mutex);
+    return r_ready;
+}
+
+int EDFPrefetchReader::depth() const { return (int)r_buffers.size(); }
+
+size_t EDFPrefetchReader::chunkSize() const { return static_cast<size_t>(r_recordsPerChunk) * r_recordSize; }
+
+int EDFPrefetchReader::recordsPerChunk() const { return r_recordsPerChunk; }
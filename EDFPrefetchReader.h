@@ -0,0 +1,102 @@
+/**
+ @file EDFPrefetchReader.h
+ @brief A read-ahead pipeline for the data record section of an EDF file.
+ A background thread reads large multi-record chunks into a ring of buffers
+ while the consumer decodes the previously filled chunk.
+
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#ifndef _EDFPREFETCHREADER_H
+#define	_EDFPREFETCHREADER_H
+
+#include <string>
+#include <fstream>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class EDFPrefetchReader {
+public:
+    EDFPrefetchReader() = delete;
+
+    /**
+     Constructor to build a new read-ahead pipeline. The reader opens its own
+     stream to the file so it never disturbs the position of other readers.
+     @param path Path to the EDF file on disk.
+     @param dataOffset Byte offset of the first data record.
+     @param recordSize Size in bytes of one data record.
+     @param depth Number of chunk buffers in the ring. Values below 2 are raised to 2.
+     @param chunkSize Size in bytes of each read. Rounded down to whole records, minimum one record.
+     */
+    EDFPrefetchReader(const std::string&, long long, int, int, size_t);
+    EDFPrefetchReader(const EDFPrefetchReader&) = delete;
+    EDFPrefetchReader& operator=(const EDFPrefetchReader&) = delete;
+
+    /**
+     Destructor. Stops the background thread if it is running.
+     */
+    virtual ~EDFPrefetchReader();
+
+    /**
+     Begin streaming a range of records. Any range in progress is abandoned.
+     @param firstRecord Index of the first record to read.
+     @param endRecord One past the index of the last record to read.
+     @return false if the file could not be opened.
+     */
+    bool start(int, int);
+
+    /**
+     Get the next filled chunk, blocking until the background thread has read it.
+     The returned buffer stays valid until the next call to next() or stop().
+     @param recordCount Set to the number of whole records in the chunk.
+     @return Pointer to the chunk or nullptr when the range is exhausted or a read failed.
+     */
+    const char* next(int&);
+
+    /**
+     Abandon the current range and join the background thread.
+     */
+    void stop();
+
+    /**
+     Check whether the last range ended because of a read error.
+     @return true if a read failed.
+     */
+    bool failed() const;
+
+    /**
+     Check whether the chunk returned by the last call to next was already
+     filled, so the caller did not wait on the read.
+     @return true if next returned without waiting.
+     */
+    bool wasReady() const;
+
+    int depth() const;
+    size_t chunkSize() const;
+    int recordsPerChunk() const;
+
+private:
+    std::string r_path;
+    std::ifstream r_stream;
+    long long r_dataOffset;
+    int r_recordSize;
+    int r_recordsPerChunk;
+
+    std::vector<std::vector<char> > r_buffers;
+    std::vector<int> r_counts; // records held by each buffer
+    int r_head, r_filled;      // consumer slot and number of filled slots
+    bool r_holding;            // consumer still owns the head slot
+    bool r_ready;              // last chunk was filled before next asked for it
+    bool r_done, r_failed, r_cancel;
+
+    std::thread r_worker;
+    mutable std::mutex r_mutex;
+    std::condition_variable r_spaceReady, r_dataReady;
+
+    void fill(int, int);
+};
+
+#endif	/* _EDFPREFETCHREADER_H */
@@ -0,0 +1,144 @@
+/**
+ @file EDFQuantileSketch.cpp
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#include "EDFQuantileSketch.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+using std::vector;
+
+// capacity ratio between neighbouring compactors
+const double SHRINK = 2.0 / 3.0;
+
+EDFQuantileSketch::EDFQuantileSketch(int k)
+    : q_k(std::max(k, 8))
+    , q_count(0)
+    , q_min(std::numeric_limits<double>::infinity())
+    , q_max(-std::numeric_limits<double>::infinity())
+    , q_coin(0x9e3779b97f4a7c15ULL)
+    , q_retained(0)
+    , q_limit(0)
+{
+    grow();
+}
+
+void EDFQuantileSketch::add(double val) {
+    q_levels[0].push_back(val);
+    q_count++;
+    q_retained++;
+    q_min = std::min(q_min, val);
+    q_max = std::max(q_max, val);
+    if (q_retained > q_limit)
+        compress();
+}
+
+void EDFQuantileSketch::add(const double* vals, size_t length) {
+    for (size_t i = 0; i < length; i++)
+        add(vals[i]);
+}
+
+void EDFQuantileSketch::merge(const EDFQuantileSketch& other) {
+    if (other.q_count == 0)
+        return;
+
+    while (q_levels.size() < other.q_levels.size())
+        grow();
+    for (size_t h = 0; h < other.q_levels.size(); h++)
+        q_levels[h].insert(q_levels[h].end(), other.q_levels[h].begin(), other.q_levels[h].end());
+
+    q_count += other.q_count;
+    q_retained += other.q_retained;
+    q_min = std::min(q_min, other.q_min);
+    q_max = std::max(q_max, other.q_max);
+    while (q_retained > q_limit)
+        compress();
+}
+
+unsigned long long EDFQuantileSketch::count() const { return q_count; }
+
+size_t EDFQuantileSketch::retained() const { return q_retained; }
+
+double EDFQuantileSketch::min() const { return q_min; }
+
+double EDFQuantileSketch::max() const { return q_max; }
+
+double EDFQuantileSketch::quantile(double q) const {
+    if (q_count == 0)
+        return std::numeric_limits<double>::quiet_NaN();
+    if (q <= 0)
+        return q_min;
+    if (q >= 1)
+        return q_max;
+
+    // every value kept at level h stands for 2^h values
+    vector<std::pair<double, unsigned long long> > weighted;
+    weighted.reserve(q_retained);
+    for (size_t h = 0; h < q_levels.size(); h++)
+        for (double v : q_levels[h])
+            weighted.push_back(std::make_pair(v, 1ULL << h));
+    std::sort(weighted.begin(), weighted.end());
+
+    double target = q * q_count;
+    unsigned long long cumulative = 0;
+    for (auto& item : weighted) {
+        cumulative += item.second;
+        if (cumulative >= target)
+            return item.first;
+    }
+    return q_max;
+}
+
+double EDFQuantileSketch::rank(double val) const {
+    if (q_count == 0)
+        return 0;
+
+    unsigned long long below = 0;
+    for (size_t h = 0; h < q_levels.size(); h++)
+        for (double v : q_levels[h])
+            if (v <= val)
+                below += 1ULL << h;
+    return static_cast<double>(below) / q_count;
+}
+
+size_t EDFQuantileSketch::capacity(size_t level) const {
+    // the top compactor holds k, each one below two thirds of the one above
+    double depth = static_cast<double>(q_levels.size() - 1 - level);
+    return std::max<size_t>(2, static_cast<size_t>(ceil(q_k * pow(SHRINK, depth))));
+}
+
+void EDFQuantileSketch::grow() {
+    q_levels.push_back(vector<double>());
+    q_limit = 0;
+    for (size_t h = 0; h < q_levels.size(); h++)
+        q_limit += capacity(h);
+}
+
+void EDFQuantileSketch::compress() {
+    for (size_t h = 0; h < q_levels.size(); h++) {
+        if (q_levels[h].size() < capacity(h))
+            continue;
+        if (h + 1 == q_levels.size())
+            grow();
+
+        // an odd value out stays behind, the rest pair off and one of each pair moves up
+        vector<double>& level = q_levels[h];
+        std::sort(level.begin(), level.end());
+        size_t first = level.size() % 2;
+        q_coin ^= q_coin << 13;
+        q_coin ^= q_coin >> 7;
+        q_coin ^= q_coin << 17;
+        size_t pick = first + (q_coin & 1);
+
+        vector<double>& up = q_levels[h + 1];
+        for (size_t i = pick; i < level.size(); i += 2)
+            up.push_back(level[i]);
+        q_retained -= (level.size() - first) / 2;
+        level.resize(first);
+        return;
+    }
+}
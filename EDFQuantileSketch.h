@@ -0,0 +1,106 @@
+/**
+ @file EDFQuantileSketch.h
+ @brief Mergeable streaming quantile sketch (KLL).
+ Values enter a stack of compactors. When the sketch outgrows its budget the
+ lowest full compactor sorts its values and promotes every other one to the
+ next level, where each value stands for twice as many. Compactor capacities
+ shrink geometrically towards the bottom, so memory stays near 3k values
+ however many are added, and ranks are accurate to within about 1.7 / k of
+ the count.
+
+ The choice between odd and even values is made by a generator seeded at
+ construction, so a sketch built from the same values in the same order is
+ always the same. Sketches merge by stacking compactors level by level.
+
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#ifndef _EDFQUANTILESKETCH_H
+#define	_EDFQUANTILESKETCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class EDFQuantileSketch {
+public:
+    /**
+     Constructor.
+     @param k Capacity of the top compactor, trades memory for accuracy.
+     Values below 8 are raised to 8.
+     */
+    EDFQuantileSketch(int = 200);
+
+    /**
+     Add a value.
+     @param val Value to add.
+     */
+    void add(double);
+
+    /**
+     Add values.
+     @param vals Values to add.
+     @param length Length of vals array.
+     */
+    void add(const double*, size_t);
+
+    /**
+     Fold another sketch into this one. The sketches may have different k,
+     the result keeps this sketch's k.
+     @param other Sketch to merge.
+     */
+    void merge(const EDFQuantileSketch&);
+
+    /**
+     Get the number of values added.
+     @return Count of values.
+     */
+    unsigned long long count() const;
+
+    /**
+     Get the number of values the sketch holds.
+     @return Values kept across all compactors.
+     */
+    size_t retained() const;
+
+    /**
+     Get the smallest value added.
+     @return Exact minimum.
+     */
+    double min() const;
+
+    /**
+     Get the largest value added.
+     @return Exact maximum.
+     */
+    double max() const;
+
+    /**
+     Estimate a quantile.
+     @param q Fraction of the values, 0 to 1. 0 and 1 give the exact extremes.
+     @return Estimated value, NaN if the sketch is empty.
+     */
+    double quantile(double) const;
+
+    /**
+     Estimate the fraction of values less than or equal to a value.
+     @param val Value to rank.
+     @return Fraction from 0 to 1, 0 if the sketch is empty.
+     */
+    double rank(double) const;
+
+private:
+    int q_k;
+    unsigned long long q_count;
+    double q_min, q_max;
+    uint64_t q_coin;
+    size_t q_retained, q_limit;
+    std::vector<std::vector<double> > q_levels;
+
+    size_t capacity(size_t) const;
+    void grow();
+    void compress();
+};
+
+#endif	/* _EDFQUANTILESKETCH_H */
@@ -0,0 +1,135 @@
+/**
+ @file EDFResampler.cpp
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#include "EDFResampler.h"
+#include "EDFFilter.h"
+#include <algorithm>
+#include <cmath>
+
+using std::vector;
+
+long long greatestDivisor(long long, long long);
+
+EDFResampler::EDFResampler(double inputRate, double outputRate, double offset, int quality)
+    : r_first(0)
+    , r_received(0)
+    , r_produced(0)
+    , r_head(0)
+    , r_tail(0)
+{
+    // rates to the nearest millihertz, then the smallest whole ratio
+    long long in = std::max(1LL, static_cast<long long>(std::llround(inputRate * 1000)));
+    long long out = std::max(1LL, static_cast<long long>(std::llround(outputRate * 1000)));
+    long long divisor = greatestDivisor(in, out);
+    r_up = static_cast<int>(out / divisor);
+    r_down = static_cast<int>(in / divisor);
+
+    // a low-pass at the lower Nyquist rate, running at the upsampled rate
+    vector<double> taps(1, 1.0);
+    if (r_up != r_down) {
+        int widest = std::max(r_up, r_down);
+        taps = EDFFIRFilter::lowPassTaps(1.0, 0.5 / widest, 2 * std::max(quality, 1) * widest + 1);
+        for (double& tap : taps)
+            tap *= r_up;
+    }
+    long long centre = static_cast<long long>(taps.size() - 1) / 2;
+    r_offset = centre + std::llround(std::min(std::max(offset, 0.0), 1.0) * r_up);
+
+    // phase p takes taps p, p + up, p + 2 up, ... stored last first to run forwards over the inputs
+    r_phaseLength = static_cast<int>((taps.size() + r_up - 1) / r_up);
+    r_phases.assign(static_cast<size_t>(r_up) * r_phaseLength, 0);
+    for (int p = 0; p < r_up; p++) {
+        for (int k = 0; k < r_phaseLength; k++) {
+            size_t tap = static_cast<size_t>(p) + static_cast<size_t>(k) * r_up;
+            if (tap < taps.size())
+                r_phases[static_cast<size_t>(p) * r_phaseLength + (r_phaseLength - 1 - k)] = taps[tap];
+        }
+    }
+}
+
+void EDFResampler::process(const double* vals, size_t length, vector<double>& out) {
+    if (length == 0)
+        return;
+    if (r_received == 0)
+        r_head = vals[0];
+    r_history.insert(r_history.end(), vals, vals + length);
+    r_received += static_cast<long long>(length);
+    r_tail = vals[length - 1];
+
+    // every output whose newest input has arrived
+    for (;;) {
+        long long newest = (static_cast<long long>(r_produced) * r_down + r_offset) / r_up;
+        if (newest >= r_received)
+            break;
+        out.push_back(produce(static_cast<long long>(r_produced)));
+        r_produced++;
+    }
+    trim();
+}
+
+void EDFResampler::flush(size_t total, vector<double>& out) {
+    while (r_produced < total) {
+        out.push_back(produce(static_cast<long long>(r_produced)));
+        r_produced++;
+    }
+}
+
+void EDFResampler::reset() {
+    r_history.clear();
+    r_first = 0;
+    r_received = 0;
+    r_produced = 0;
+    r_head = r_tail = 0;
+}
+
+size_t EDFResampler::produced() const { return r_produced; }
+
+int EDFResampler::up() const { return r_up; }
+
+int EDFResampler::down() const { return r_down; }
+
+double EDFResampler::produce(long long m) {
+    long long position = m * r_down + r_offset;
+    long long newest = position / r_up;
+    long long oldest = newest - r_phaseLength + 1;
+    const double* h = r_phases.data() + static_cast<size_t>(position % r_up) * r_phaseLength;
+
+    double sum = 0;
+    if (oldest >= r_first && newest < r_received) {
+        const double* x = r_history.data() + (oldest - r_first);
+        for (int j = 0; j < r_phaseLength; j++)
+            sum += h[j] * x[j];
+        return sum;
+    }
+
+    // edges read as the first or, once flushing, the last input
+    for (int j = 0; j < r_phaseLength; j++) {
+        long long i = oldest + j;
+        double x = i < r_first ? r_head : (i >= r_received ? r_tail : r_history[i - r_first]);
+        sum += h[j] * x;
+    }
+    return sum;
+}
+
+void EDFResampler::trim() {
+    // drop inputs older than the next output needs, in large steps
+    long long next = (static_cast<long long>(r_produced) * r_down + r_offset) / r_up;
+    long long keep = next - r_phaseLength + 1;
+    long long drop = std::min(keep - r_first, static_cast<long long>(r_history.size()));
+    if (drop > 0 && drop * 2 >= static_cast<long long>(r_history.size())) {
+        r_history.erase(r_history.begin(), r_history.begin() + drop);
+        r_first += drop;
+    }
+}
+
+long long greatestDivisor(long long a, long long b) {
+    while (b != 0) {
+        long long t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
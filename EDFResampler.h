@@ -0,0 +1,91 @@
+/**
+ @file EDFResampler.h
+ @brief Streaming polyphase rational resampler.
+ The rate change is reduced to a ratio up / down. One windowed sinc
+ low-pass, designed for the lower of the two rates, is split into up
+ phases when the resampler is built; each output sample is then a short
+ dot product of one phase with the most recent inputs. The filter is
+ centred on each output, so output m lies at input time m * down / up
+ plus the initial offset, with no delay.
+
+ Samples before the first input read as the first input. flush() ends the
+ stream by reading samples after the last input as the last input.
+
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#ifndef _EDFRESAMPLER_H
+#define	_EDFRESAMPLER_H
+
+#include <cstddef>
+#include <vector>
+
+class EDFResampler {
+public:
+    /**
+     Constructor.
+     @param inputRate Samples per unit time in. Only the ratio of the two
+     rates matters, each rounded to the nearest thousandth.
+     @param outputRate Samples per unit time out.
+     @param offset Input samples between the first input and the first output,
+     from 0 up to 1. Rounded to the nearest 1 / up.
+     @param quality Filter zero crossings on each side of the centre. Longer
+     filters give a sharper cutoff.
+     */
+    EDFResampler(double, double, double = 0, int = 16);
+
+    /**
+     Add consecutive input samples and collect every output they complete.
+     @param vals Input samples.
+     @param length Length of vals array.
+     @param out Receives the completed outputs at its end.
+     */
+    void process(const double*, size_t, std::vector<double>&);
+
+    /**
+     End the input and produce outputs until a total count is reached.
+     @param total Number of outputs the stream should have in all.
+     @param out Receives the remaining outputs at its end.
+     */
+    void flush(size_t, std::vector<double>&);
+
+    /**
+     Forget all input, keeping the filter tables.
+     */
+    void reset();
+
+    /**
+     Get the number of outputs produced since construction or the last reset.
+     @return Output count.
+     */
+    size_t produced() const;
+
+    /**
+     Get the reduced ratio of the rate change.
+     @return Upsampling factor.
+     */
+    int up() const;
+
+    /**
+     Get the reduced ratio of the rate change.
+     @return Downsampling factor.
+     */
+    int down() const;
+
+private:
+    int r_up, r_down;
+    long long r_offset;            // in upsampled samples, includes the filter centre
+    int r_phaseLength;             // taps per phase
+    std::vector<double> r_phases;  // phase p at [p * r_phaseLength], taps last first
+    std::vector<double> r_history; // inputs from r_first on
+    long long r_first;             // input index of r_history[0]
+    long long r_received;          // inputs added
+    size_t r_produced;
+    double r_head, r_tail;         // first and last input
+
+    double produce(long long);
+    void trim();
+};
+
+#endif	/* _EDFRESAMPLER_H */
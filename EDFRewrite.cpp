@@ -0,0 +1,369 @@
+/**
+ @file EDFRewrite.cpp
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#include "EDFRewrite.h"
+#include "EDFDiagnostics.h"
+#include "EDFEncode.h"
+#include "EDFUtil.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+using std::string;
+using std::vector;
+
+EDFHeader layoutHeader(const EDFHeader&, const vector<int>&, int);
+bool sameLayout(const EDFHeader&, const EDFHeader&);
+long long startSeconds(const EDFHeader&);
+long long daysFromCivil(int, int, int);
+EDFDate civilFromDays(long long);
+void shiftStart(EDFHeader&, long long);
+bool shiftTALs(char*, int, long long);
+
+bool rewriteFile(EDFFile& source, const string& target, double start, double length, const vector<int>& channels) {
+    const EDFHeader* header = source.header();
+    if (header == nullptr) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::HEADER_FORMAT,
+                               "rewriteFile: File has no readable header. Giving up...");
+        return false;
+    }
+
+    // whole records covering the range
+    double duration = header->dataRecordDuration();
+    int startRecord = start >= 0 && duration > 0 ? static_cast<int>(floor(start / duration + 1e-9)) : -1;
+    int endRecord = header->dataRecordCount();
+    if (length >= 0 && duration > 0)
+        endRecord = std::min(endRecord, static_cast<int>(ceil((start + length) / duration - 1e-9)));
+    if (startRecord < 0 || startRecord >= header->dataRecordCount() || endRecord <= startRecord) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::WINDOW_RANGE,
+                               "rewriteFile: Range is outside the recording. Giving up...");
+        return false;
+    }
+
+    vector<int> signals(channels);
+    if (signals.empty()) {
+        range_loop(sig, 0, header->signalCount(), 1)
+            if (sig != header->annotationIndex())
+                signals.push_back(sig);
+    }
+    for (int sig : signals) {
+        if (sig == header->annotationIndex() || !header->signalAvailable(sig)) {
+            EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::CHANNEL_INDEX,
+                                   "rewriteFile: Channel is the annotation signal or does not exist. Giving up...");
+            return false;
+        }
+    }
+    if (header->annotationIndex() >= 0)
+        signals.push_back(header->annotationIndex());
+
+    // the new header keeps the selected signals in order and starts at the first record kept
+    EDFHeader out = layoutHeader(*header, signals, 0);
+    int recordSize = out.dataRecordSize();
+    out.setDataRecordCount(endRecord - startRecord);
+
+    double offset = startRecord * duration;
+    long long seconds = static_cast<long long>(floor(offset + 1e-9));
+    shiftStart(out, seconds);
+    if (header->annotationIndex() < 0 && offset - seconds > 1e-9)
+        EDFDiagnostics::report(EDFSeverity::WARNING, EDFDiagnosticCode::VALUE_RANGE,
+                               "rewriteFile: Start falls between seconds and is rounded down in the header.");
+
+    std::ofstream file;
+    file.rdbuf()->pubsetbuf(nullptr, 0);
+    file.open(target.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    string head = encodeHeader(out);
+    if (!file.is_open() || !file.write(head.data(), head.size())) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::FILE_ACCESS,
+                               "rewriteFile: File '" + target + "' cannot be written. Giving up...");
+        return false;
+    }
+
+    // sample bytes move from the source records into a slab of output records
+    int slabRecords = std::max(1, (4 << 20) / std::max(recordSize, 1));
+    vector<char> slab(static_cast<size_t>(slabRecords) * recordSize);
+    int talOffset = out.annotationIndex() >= 0 ? out.bufferOffset(out.annotationIndex()) : 0;
+    int talLength = out.annotationIndex() >= 0 ? 2 * out.signalSampleCount(out.annotationIndex()) : 0;
+    int filled = 0;
+    bool written = true;
+    bool read = source.visitRecords(startRecord, endRecord, [&](const char* record, int) {
+        char* to = slab.data() + static_cast<size_t>(filled) * recordSize;
+        range_loop(i, static_cast<size_t>(0), signals.size(), 1)
+            memcpy(to + out.bufferOffset(i), record + header->bufferOffset(signals[i]), 2 * out.signalSampleCount(i));
+        if (talLength > 0 && seconds > 0 && !shiftTALs(to + talOffset, talLength, seconds))
+            EDFDiagnostics::report(EDFSeverity::WARNING, EDFDiagnosticCode::ANNOTATION_SIGNAL,
+                                   "rewriteFile: Shifted annotations do not fit the annotation signal. Keeping the originals...");
+
+        if (++filled == slabRecords) {
+            written = written && file.write(slab.data(), static_cast<std::streamsize>(filled) * recordSize);
+            filled = 0;
+        }
+    });
+    written = written && file.write(slab.data(), static_cast<std::streamsize>(filled) * recordSize);
+    file.close();
+
+    if (!read || !written || file.fail()) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::FILE_ACCESS,
+                               "rewriteFile: Error copying records to '" + target + "'. Giving up...");
+        return false;
+    }
+    return true;
+}
+
+bool mergeFiles(const vector<string>& sources, const string& target) {
+    if (sources.empty()) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::FILE_ACCESS,
+                               "mergeFiles: No files to merge. Giving up...");
+        return false;
+    }
+
+    // recordings are joined in the order they started
+    vector<std::unique_ptr<EDFFile> > files;
+    for (const string& path : sources) {
+        files.push_back(std::unique_ptr<EDFFile>(new EDFFile(path.c_str())));
+        if (files.back()->header() == nullptr)
+            return false;
+    }
+    std::stable_sort(files.begin(), files.end(), [](const std::unique_ptr<EDFFile>& a, const std::unique_ptr<EDFFile>& b) {
+        return startSeconds(*a->header()) < startSeconds(*b->header());
+    });
+    const EDFHeader& first = *files[0]->header();
+    for (const auto& file : files) {
+        if (!sameLayout(first, *file->header())) {
+            EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::HEADER_FORMAT,
+                                   "mergeFiles: Files differ in signals or record duration. Giving up...");
+            return false;
+        }
+    }
+
+    // the annotation signal fits the widest input's and at least a timekeeping annotation
+    vector<int> signals;
+    int annotationSamples = 32;
+    range_loop(sig, 0, first.signalCount(), 1)
+        if (sig != first.annotationIndex())
+            signals.push_back(sig);
+    int records = 0;
+    for (const auto& file : files) {
+        const EDFHeader* header = file->header();
+        if (header->annotationIndex() >= 0)
+            annotationSamples = std::max(annotationSamples, header->signalSampleCount(header->annotationIndex()));
+        records += header->dataRecordCount();
+    }
+    EDFHeader out = layoutHeader(first, signals, annotationSamples);
+    out.setFiletype(FileType::EDFPLUS);
+    out.setContinuity(Continuity::DISCONTINUOUS);
+    out.setDataRecordCount(records);
+    int recordSize = out.dataRecordSize();
+    int talOffset = out.bufferOffset(out.annotationIndex());
+    int talLength = 2 * annotationSamples;
+
+    std::ofstream file;
+    file.rdbuf()->pubsetbuf(nullptr, 0);
+    file.open(target.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    string head = encodeHeader(out);
+    if (!file.is_open() || !file.write(head.data(), head.size())) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::FILE_ACCESS,
+                               "mergeFiles: File '" + target + "' cannot be written. Giving up...");
+        return false;
+    }
+
+    // each input's records are copied in start order, the gaps between inputs show in the onsets
+    int slabRecords = std::max(1, (4 << 20) / recordSize);
+    vector<char> slab(static_cast<size_t>(slabRecords) * recordSize);
+    int filled = 0;
+    bool read = true, written = true, ordered = true;
+    double end = 0; // of the records written so far, in seconds from the merged start
+    for (const auto& source : files) {
+        const EDFHeader* header = source->header();
+        long long shift = startSeconds(*header) - startSeconds(first);
+        int annotation = header->annotationIndex();
+        double duration = header->dataRecordDuration();
+
+        read = source->visitRecords(0, header->dataRecordCount(), [&](const char* record, int recordNum) {
+            char* to = slab.data() + static_cast<size_t>(filled) * recordSize;
+            range_loop(i, static_cast<size_t>(0), signals.size(), 1)
+                memcpy(to + out.bufferOffset(i), record + header->bufferOffset(signals[i]), 2 * out.signalSampleCount(i));
+
+            // EDF+ inputs keep their lists with onsets moved to the merged start, EDF inputs gain a timekeeping list
+            char* tal = to + talOffset;
+            double onset = shift + recordNum * duration;
+            memset(tal, 0, talLength);
+            if (annotation >= 0) {
+                memcpy(tal, record + header->bufferOffset(annotation), 2 * header->signalSampleCount(annotation));
+                onset = shift + atof(string(tal, strnlen(tal, talLength)).c_str());
+                if (shift != 0 && !shiftTALs(tal, talLength, -shift))
+                    EDFDiagnostics::report(EDFSeverity::WARNING, EDFDiagnosticCode::ANNOTATION_SIGNAL,
+                                           "mergeFiles: Shifted annotations do not fit the annotation signal. Keeping the originals...");
+            } else {
+                string list = encodeTAL(onset, "");
+                memcpy(tal, list.data(), std::min(list.size(), static_cast<size_t>(talLength)));
+            }
+            ordered = ordered && onset > end - 1e-6;
+            end = onset + duration;
+
+            if (++filled == slabRecords) {
+                written = written && file.write(slab.data(), static_cast<std::streamsize>(filled) * recordSize);
+                filled = 0;
+            }
+        });
+        if (!read || !ordered)
+            break;
+    }
+    written = written && file.write(slab.data(), static_cast<std::streamsize>(filled) * recordSize);
+    file.close();
+
+    if (!ordered) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::VALUE_RANGE,
+                               "mergeFiles: Recordings overlap in time. Giving up...");
+        remove(target.c_str());
+        return false;
+    }
+    if (!read || !written || file.fail()) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::FILE_ACCESS,
+                               "mergeFiles: Error copying records to '" + target + "'. Giving up...");
+        remove(target.c_str());
+        return false;
+    }
+    return true;
+}
+
+EDFHeader layoutHeader(const EDFHeader& source, const vector<int>& signals, int annotationSamples) {
+    // annotationSamples adds an annotation signal of that size when the list has none
+    EDFHeader out(source);
+    int count = static_cast<int>(signals.size()) + (annotationSamples > 0 ? 1 : 0);
+    out.setSignalCount(count);
+    int recordSize = 0;
+    range_loop(i, 0, count, 1) {
+        int sig = i < static_cast<int>(signals.size()) ? signals[i] : source.annotationIndex();
+        if (sig >= 0) {
+            out.setLabel(i, source.label(sig));
+            out.setTransducer(i, source.transducer(sig));
+            out.setPhysicalDimension(i, source.physicalDimension(sig));
+            out.setPhysicalMin(i, source.physicalMin(sig));
+            out.setPhysicalMax(i, source.physicalMax(sig));
+            out.setDigitalMin(i, source.digitalMin(sig));
+            out.setDigitalMax(i, source.digitalMax(sig));
+            out.setPrefilter(i, source.prefilter(sig));
+            out.setSignalSampleCount(i, source.signalSampleCount(sig));
+            out.setReserved(i, source.reserved(sig));
+        } else {
+            out.setLabel(i, "EDF Annotations");
+            out.setTransducer(i, "");
+            out.setPhysicalDimension(i, "");
+            out.setPhysicalMin(i, -1);
+            out.setPhysicalMax(i, 1);
+            out.setDigitalMin(i, -32768);
+            out.setDigitalMax(i, 32767);
+            out.setPrefilter(i, "");
+            out.setReserved(i, "");
+        }
+        if (i >= static_cast<int>(signals.size()))
+            out.setSignalSampleCount(i, annotationSamples);
+        if (sig == source.annotationIndex() || i >= static_cast<int>(signals.size()))
+            out.setAnnotationIndex(i);
+        out.setBufferOffset(i, recordSize);
+        recordSize += 2 * out.signalSampleCount(i);
+    }
+    out.setDataRecordSize(recordSize);
+    return out;
+}
+
+bool sameLayout(const EDFHeader& a, const EDFHeader& b) {
+    // signals other than annotations must match in order
+    vector<int> as, bs;
+    range_loop(sig, 0, a.signalCount(), 1)
+        if (sig != a.annotationIndex())
+            as.push_back(sig);
+    range_loop(sig, 0, b.signalCount(), 1)
+        if (sig != b.annotationIndex())
+            bs.push_back(sig);
+    if (as.size() != bs.size() || std::fabs(a.dataRecordDuration() - b.dataRecordDuration()) > 1e-9)
+        return false;
+
+    range_loop(i, static_cast<size_t>(0), as.size(), 1) {
+        int s = as[i], t = bs[i];
+        if (a.label(s) != b.label(t) || a.signalSampleCount(s) != b.signalSampleCount(t) ||
+            a.physicalDimension(s) != b.physicalDimension(t) ||
+            a.physicalMin(s) != b.physicalMin(t) || a.physicalMax(s) != b.physicalMax(t) ||
+            a.digitalMin(s) != b.digitalMin(t) || a.digitalMax(s) != b.digitalMax(t))
+            return false;
+    }
+    return true;
+}
+
+long long startSeconds(const EDFHeader& header) {
+    EDFDate date = header.date();
+    return daysFromCivil(date.fullYear(), date.month(), date.day()) * 86400 + header.startTime().asSeconds();
+}
+
+void shiftStart(EDFHeader& header, long long seconds) {
+    if (seconds == 0)
+        return;
+
+    long long total = header.startTime().asSeconds() + seconds;
+    EDFDate date = header.date();
+    long long days = daysFromCivil(date.fullYear(), date.month(), date.day()) + total / 86400;
+    header.setDate(civilFromDays(days));
+    header.setStartTime(EDFTime(static_cast<int>(total % 86400)));
+}
+
+// days since 1970-01-01 of a proleptic Gregorian date
+long long daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    long long era = (year >= 0 ? year : year - 399) / 400;
+    long long yearOfEra = year - era * 400;
+    long long dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    long long dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+EDFDate civilFromDays(long long days) {
+    days += 719468;
+    long long era = (days >= 0 ? days : days - 146096) / 146097;
+    long long dayOfEra = days - era * 146097;
+    long long yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    long long dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    long long shifted = (5 * dayOfYear + 2) / 153;
+    int day = static_cast<int>(dayOfYear - (153 * shifted + 2) / 5 + 1);
+    int month = static_cast<int>(shifted < 10 ? shifted + 3 : shifted - 9);
+    long long year = yearOfEra + era * 400 + (month <= 2);
+    return EDFDate(day, month, static_cast<int>(year % 100));
+}
+
+bool shiftTALs(char* tal, int length, long long seconds) {
+    // each list is onset, optional duration and texts, ending in a zero byte
+    string shifted;
+    int at = 0;
+    while (at < length && tal[at] != 0) {
+        int onsetEnd = at;
+        while (onsetEnd < length && tal[onsetEnd] != 20 && tal[onsetEnd] != 21)
+            onsetEnd++;
+        int listEnd = onsetEnd;
+        while (listEnd < length && tal[listEnd] != 0)
+            listEnd++;
+        if (onsetEnd >= length || listEnd >= length)
+            return false;
+
+        // the onset keeps the decimals it was written with
+        string onset(tal + at, onsetEnd - at);
+        size_t dot = onset.find('.');
+        int decimals = dot == string::npos ? 0 : static_cast<int>(onset.size() - dot - 1);
+        char moved[64];
+        snprintf(moved, sizeof(moved), "%+.*f", decimals, atof(onset.c_str()) - seconds);
+        shifted += moved;
+        shifted.append(tal + onsetEnd, listEnd - onsetEnd + 1);
+        at = listEnd + 1;
+    }
+    if (static_cast<int>(shifted.size()) > length)
+        return false;
+
+    memcpy(tal, shifted.data(), shifted.size());
+    memset(tal + shifted.size(), 0, length - shifted.size());
+    return true;
+}
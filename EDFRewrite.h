@@ -0,0 +1,62 @@
+/**
+ @file EDFRewrite.h
+ @brief Derived files cut from an EDF file without decoding samples.
+ A time range is kept as whole data records and signals are kept, dropped
+ or reordered by copying each record's sample bytes straight into the
+ output record; samples are never converted. A new header describes the
+ result and its start is moved to the first record kept.
+
+ The annotation signal of an EDF+ file is always kept, as the last
+ signal. When the start moves, the onsets of its time-stamped annotation
+ lists are moved by the same whole seconds and any fraction is left in
+ the onsets, as EDF+ intends for starts between seconds.
+
+ Recordings split across files with the same signals can be merged the same
+ way into one EDF+D file. Every record carries a time-keeping annotation
+ list whose onset counts from the earliest file's start, so gaps between
+ the files are kept.
+
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#ifndef _EDFREWRITE_H
+#define	_EDFREWRITE_H
+
+#include <string>
+#include <vector>
+#include "EDFFile.h"
+
+/**
+ Write part of a file as a new file.
+ @param source File to read.
+ @param target Path of the file to write, replaced if it exists.
+ @param start Seconds from the start of the recording, rounded down to the
+ start of a record.
+ @param length Seconds to keep, rounded up to whole records and truncated
+ to the recording. Negative keeps everything after start.
+ @param channels Signals to keep, in output order. Empty keeps every signal.
+ The annotation signal cannot be listed.
+ @return true if the file was written. Fails if the range is outside the
+ recording, a channel is the annotation signal or does not exist, or
+ reading or writing failed.
+ */
+bool rewriteFile(EDFFile&, const std::string&, double, double = -1, const std::vector<int>& = std::vector<int>());
+
+/**
+ Merge recordings into one discontinuous EDF+ file.
+ Sources are joined in order of their start date and time. Each must have
+ the same signals as the earliest, in the same order, with the same label,
+ samples per record, physical dimension and physical and digital ranges,
+ and the same record duration. The annotation signal is sized to the
+ largest of the sources' and at least fits a time-keeping annotation.
+ Annotations of EDF+ sources are kept with their onsets moved to the
+ earliest file's start.
+ @param sources Paths of the files to merge.
+ @param target Path of the file to write, replaced if it exists.
+ @return true if the file was written. Fails if a source cannot be read,
+ the sources differ in layout or overlap in time, or writing failed.
+ */
+bool mergeFiles(const std::vector<std::string>&, const std::string&);
+
+#endif	/* _EDFREWRITE_H */
@@ -5,18 +5,21 @@
  */
 
 #include "EDFSignalData.h"
+#include "EDFDiagnostics.h"
 #include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <cmath>
 #include <limits>
 #include <numeric>
+#include <utility>
 
+using std::string;
 using std::vector;
 
 EDFSignalData::EDFSignalData(double frequency, double channelMax, double channelMin)
     : sMax(std::numeric_limits<double>::infinity())
     , sMin(std::numeric_limits<double>::infinity())
-    , m_1(0), m_2(0), m_3(0), m_4(0)
 {
     this->cMax = channelMax;
     this->cMin = channelMin;
@@ -30,11 +33,7 @@ EDFSignalData::EDFSignalData(const EDFSignalData& orig) {
     sMin = orig.sMin;
     sFrequency = orig.sFrequency;
     dataPoints = orig.dataPoints;
-    
-    m_1 = orig.m_1;
-    m_2 = orig.m_2;
-    m_3 = orig.m_3;
-    m_4 = orig.m_4;
+    stats = orig.stats;
 }
 
 EDFSignalData& EDFSignalData::operator=(const EDFSignalData& rhs) {
@@ -45,17 +44,39 @@ EDFSignalData& EDFSignalData::operator=(const EDFSignalData& rhs) {
         sMin = rhs.sMin;
         sFrequency = rhs.sFrequency;
         dataPoints = rhs.dataPoints;
-        
-        m_1 = rhs.m_1;
-        m_2 = rhs.m_2;
-        m_3 = rhs.m_3;
-        m_4 = rhs.m_4;
+        stats = rhs.stats;
+    }
+    return *this;
+}
+
+EDFSignalData::EDFSignalData(EDFSignalData&& orig) noexcept
+    : dataPoints(std::move(orig.dataPoints))
+    , sFrequency(orig.sFrequency)
+    , cMax(orig.cMax)
+    , cMin(orig.cMin)
+    , sMax(orig.sMax)
+    , sMin(orig.sMin)
+    , stats(orig.stats)
+{
+    orig.clear();
+}
+
+EDFSignalData& EDFSignalData::operator=(EDFSignalData&& rhs) noexcept {
+    if (this != &rhs) {
+        cMax = rhs.cMax;
+        cMin = rhs.cMin;
+        sMax = rhs.sMax;
+        sMin = rhs.sMin;
+        sFrequency = rhs.sFrequency;
+        dataPoints = std::move(rhs.dataPoints);
+        stats = rhs.stats;
+        rhs.clear();
     }
     return *this;
 }
 
 std::ostream& operator<<(std::ostream& s, EDFSignalData& data) {
-    vector<double> raw = data.data();
+    const vector<double>& raw = data.data();
     s << std::endl << data.time() << " seconds  " << data.size() << " samples" << std::endl;
     
     int width = 0;
@@ -89,35 +110,61 @@ void EDFSignalData::updateSignalMaxMin(double val) {
 
 bool EDFSignalData::valueInRange(double val) const {
     if (val < cMin || val > cMax) {
-        std::cerr << "Value is out of range of signal definition: " << val << std::endl;
+        reportOutOfRange(val, 1);
         return false;
     }
     return true;
 }
 
+void EDFSignalData::reportOutOfRange(double val, size_t count) const {
+    // skip formatting when the report would only be counted
+    if (!EDFDiagnostics::accepts(EDFDiagnosticCode::VALUE_RANGE)) {
+        EDFDiagnostics::report(EDFSeverity::WARNING, EDFDiagnosticCode::VALUE_RANGE,
+                               "Value is out of range of signal definition.", count);
+        return;
+    }
+    std::ostringstream message;
+    message << "Value is out of range of signal definition: " << val;
+    if (count > 1)
+        message << " (and " << count - 1 << " more)";
+    EDFDiagnostics::report(EDFSeverity::WARNING, EDFDiagnosticCode::VALUE_RANGE, message.str(), count);
+}
+
 void EDFSignalData::addDataPoint(double val) {
     valueInRange(val);
+    accumulate(val);
+}
+
+void EDFSignalData::accumulate(double val) {
     updateSignalMaxMin(val);
     dataPoints.push_back(val);
-    
-    // update online stats
-    // based on John D. Cook's implementation of Knuth & Welford stable algorithm
-    // as presented in 'Formulas for Robust, One-Pass Parallel Computation of Covariances and Arbitrary-Order Statistical Moments'
-    size_t n = dataPoints.size();
-    double delta    = val - m_1;
-    double delta_n  = delta / n;
-    double delta_n2 = delta_n * delta_n;
-    double term1    = delta * delta_n * (n - 1);
-    
-    m_4 += term1 * delta_n2 * (n*n - 3*n + 3) + (6 * delta_n2 * m_2) - (4 * delta_n * m_3);
-    m_3 += term1 * delta_n * (n-2) - (3 * delta_n * m_2);
-    m_2 += term1;
-    m_1 += delta_n;
+    stats.add(&val, 1);
 }
 
 void EDFSignalData::addDataPoints(const double* vals, size_t length) {
-    for (size_t i = 0; i < length; i++)
-        addDataPoint(vals[i]);
+    if (length == 0)
+        return;
+    
+    // one pass for range checks and extremes, then the block moments
+    size_t outOfRange = 0;
+    double lo = vals[0], hi = vals[0];
+    for (size_t i = 0; i < length; i++) {
+        outOfRange += (vals[i] < cMin) | (vals[i] > cMax);
+        lo = vals[i] < lo ? vals[i] : lo;
+        hi = vals[i] > hi ? vals[i] : hi;
+    }
+    updateSignalMaxMin(lo);
+    updateSignalMaxMin(hi);
+    dataPoints.insert(dataPoints.end(), vals, vals + length);
+    stats.add(vals, length);
+    
+    // range problems are reported once per call rather than once per value
+    if (outOfRange > 0) {
+        size_t first = 0;
+        while (vals[first] >= cMin && vals[first] <= cMax)
+            first++;
+        reportOutOfRange(vals[first], outOfRange);
+    }
 }
 
 size_t EDFSignalData::size() const { return dataPoints.size(); }
@@ -126,7 +173,7 @@ double EDFSignalData::frequency() const { return sFrequency; }
 
 double EDFSignalData::time() const { return dataPoints.size() / sFrequency; }
 
-vector<double> EDFSignalData::data() const { return dataPoints; }
+const vector<double>& EDFSignalData::data() const { return dataPoints; }
 
 double EDFSignalData::channelMax() const { return cMax; }
 
@@ -147,8 +194,10 @@ vector<double> EDFSignalData::standardizedData() const {
     return newData;
 }
 
+EDFMoments EDFSignalData::moments() const { return stats; }
+
 double EDFSignalData::mean() const {
-    return m_1;
+    return stats.mean();
 }
 
 double EDFSignalData::stddev() const {
@@ -156,13 +205,20 @@ double EDFSignalData::stddev() const {
 }
 
 double EDFSignalData::variance() const {
-    return m_2/(dataPoints.size() - 1);
+    return stats.variance();
 }
 
 double EDFSignalData::skewness() const {
-    return sqrt(dataPoints.size()) * m_3 / pow(m_2, 1.5);
+    return stats.skewness();
 }
 
 double EDFSignalData::kurtosis() const {
-    return dataPoints.size() * m_4 / (m_2 * m_2); // for coefficient of excess subtract three (3) from the kurtosis
+    return stats.kurtosis(); // for coefficient of excess subtract three (3) from the kurtosis
+}
+
+void EDFSignalData::clear() {
+    // a moved from object reads as freshly constructed
+    dataPoints.clear();
+    sMax = sMin = std::numeric_limits<double>::infinity();
+    stats = EDFMoments();
 }
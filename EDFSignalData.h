@@ -15,6 +15,9 @@
 #define	_EDFSIGNALDATA_H
 
 #include <vector>
+#include <cstddef>
+#include <ostream>
+#include "EDFMoments.h"
 
 class EDFSignalData {
 public:
@@ -35,6 +38,12 @@ public:
      */
     EDFSignalData(const EDFSignalData&);
     
+    /**
+     Move constructor. The samples are taken without copying.
+     @param orig The object to move from, left empty.
+     */
+    EDFSignalData(EDFSignalData&&) noexcept;
+    
     virtual ~EDFSignalData() = default;
     
     /**
@@ -42,6 +51,12 @@ public:
      @param rhs The object to copy.
      */
     EDFSignalData& operator=(const EDFSignalData&);
+    
+    /**
+     Operator = overload to take the samples of another object.
+     @param rhs The object to move from, left empty.
+     */
+    EDFSignalData& operator=(EDFSignalData&&) noexcept;
     friend std::ostream& operator<<(std::ostream&, EDFSignalData&);
     
     /**
@@ -101,9 +116,9 @@ public:
     
     /**
      Get the raw data stored.
-     @return List of data stored for object.
+     @return List of data stored for object, valid while the object lives.
      */
-    std::vector<double> data() const;
+    const std::vector<double>& data() const;
     
     /**
      Get the statistically standardized version of the data stored. Mean should be 0 and stddev should be 1.
@@ -111,6 +126,13 @@ public:
      */
     std::vector<double> standardizedData() const;
     
+    /**
+     Get the running moments of the data, for merging with the moments of
+     other windows, channels or files.
+     @return Count, mean and central moment sums.
+     */
+    EDFMoments moments() const;
+    
     /* Statistics and lies */
     double mean() const;
     
@@ -145,11 +167,14 @@ private:
     double cMax, cMin;
     double sMax, sMin;
     
-    // running totals of these values make for better statistical accuracy in IEEE754
-    double m_1, m_2, m_3, m_4;
+    // block-wise running moments keep the accuracy of a per-sample update in IEEE754
+    EDFMoments stats;
     
     bool valueInRange(double) const;
+    void reportOutOfRange(double, size_t) const;
     void updateSignalMaxMin(double);
+    void clear();
+    void accumulate(double);
 };
 
 #endif	/* _EDFSignalData_H */
\ No newline at end of file
@@ -0,0 +1,134 @@
+/**
+ @file EDFSignalSamples.cpp
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#include "EDFSignalSamples.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+template <typename T>
+EDFSignalSamples<T>::EDFSignalSamples(double frequency, double physicalMax, double physicalMin, int digitalMax, int digitalMin)
+    : sFrequency(frequency)
+    , sGain(1)
+    , sOffset(0)
+    , sMax(std::numeric_limits<T>::lowest())
+    , sMin(std::numeric_limits<T>::max())
+{
+    // physical = gain * digital + offset, guarding against a degenerate digital range
+    if (digitalMax != digitalMin)
+        sGain = (physicalMax - physicalMin) / (digitalMax - digitalMin);
+    sOffset = physicalMin - sGain * digitalMin;
+}
+
+template <typename T>
+void EDFSignalSamples<T>::addDigitalSamples(const int16_t* vals, size_t length) {
+    size_t first = samples.size();
+    samples.resize(first + length);
+    T* out = samples.data() + first;
+
+    T hi = sMax, lo = sMin;
+    if (storesDigital()) {
+        for (size_t i = 0; i < length; i++)
+            out[i] = static_cast<T>(vals[i]);
+    } else {
+        const T gain = static_cast<T>(sGain), offset = static_cast<T>(sOffset);
+        for (size_t i = 0; i < length; i++)
+            out[i] = gain * vals[i] + offset;
+    }
+    for (size_t i = 0; i < length; i++) {
+        hi = out[i] > hi ? out[i] : hi;
+        lo = out[i] < lo ? out[i] : lo;
+    }
+    sMax = hi;
+    sMin = lo;
+    sMoments.add(vals, length);
+}
+
+template <typename T>
+void EDFSignalSamples<T>::addPhysicalSamples(const double* vals, size_t length) {
+    size_t first = samples.size();
+    samples.resize(first + length);
+    T* out = samples.data() + first;
+
+    T hi = sMax, lo = sMin;
+    if (storesDigital()) {
+        for (size_t i = 0; i < length; i++) {
+            double digital = std::round((vals[i] - sOffset) / sGain);
+            digital = std::min(std::max(digital, static_cast<double>(INT16_MIN)), static_cast<double>(INT16_MAX));
+            out[i] = static_cast<T>(digital);
+        }
+    } else {
+        for (size_t i = 0; i < length; i++)
+            out[i] = static_cast<T>(vals[i]);
+    }
+    for (size_t i = 0; i < length; i++) {
+        hi = out[i] > hi ? out[i] : hi;
+        lo = out[i] < lo ? out[i] : lo;
+    }
+    sMax = hi;
+    sMin = lo;
+
+    // moments are kept in digital units
+    EDFMoments physical;
+    physical.add(vals, length);
+    sMoments.merge(physical.scaled(1 / sGain, -sOffset / sGain));
+}
+
+template <typename T>
+void EDFSignalSamples<T>::reserve(size_t count) { samples.reserve(count); }
+
+template <typename T>
+size_t EDFSignalSamples<T>::size() const { return samples.size(); }
+
+template <typename T>
+double EDFSignalSamples<T>::frequency() const { return sFrequency; }
+
+template <typename T>
+double EDFSignalSamples<T>::time() const { return samples.size() / sFrequency; }
+
+template <typename T>
+bool EDFSignalSamples<T>::storesDigital() { return std::is_integral<T>::value; }
+
+template <typename T>
+double EDFSignalSamples<T>::gain() const { return sGain; }
+
+template <typename T>
+double EDFSignalSamples<T>::offset() const { return sOffset; }
+
+template <typename T>
+const std::vector<T>& EDFSignalSamples<T>::data() const { return samples; }
+
+template <typename T>
+double EDFSignalSamples<T>::physical(size_t index) const {
+    return storesDigital() ? sGain * samples[index] + sOffset : samples[index];
+}
+
+template <typename T>
+void EDFSignalSamples<T>::physicalData(float* out, size_t first, size_t count) const {
+    const T* in = samples.data() + first;
+    if (storesDigital()) {
+        const float gain = static_cast<float>(sGain), offset = static_cast<float>(sOffset);
+        for (size_t i = 0; i < count; i++)
+            out[i] = gain * in[i] + offset;
+    } else {
+        for (size_t i = 0; i < count; i++)
+            out[i] = static_cast<float>(in[i]);
+    }
+}
+
+template <typename T>
+EDFMoments EDFSignalSamples<T>::moments() const { return sMoments.scaled(sGain, sOffset); }
+
+template <typename T>
+T EDFSignalSamples<T>::max() const { return sMax; }
+
+template <typename T>
+T EDFSignalSamples<T>::min() const { return sMin; }
+
+template class EDFSignalSamples<int16_t>;
+template class EDFSignalSamples<float>;
+template class EDFSignalSamples<double>;
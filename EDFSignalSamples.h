@@ -0,0 +1,147 @@
+/**
+ @file EDFSignalSamples.h
+ @brief A compact model object for EDF signal data, parameterised on the stored sample type.
+ EDFSignalSamples<int16_t> keeps the raw digital samples exactly as they are stored in the
+ file and converts them to physical units on request. EDFSignalSamples<float> and
+ EDFSignalSamples<double> store samples already converted to physical units.
+ Only the int16_t, float and double instantiations are provided.
+
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#ifndef _EDFSIGNALSAMPLES_H
+#define	_EDFSIGNALSAMPLES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "EDFMoments.h"
+
+template <typename T>
+class EDFSignalSamples {
+public:
+    EDFSignalSamples() = delete;
+
+    /**
+     Constructor to build new signal samples object. The physical and digital
+     ranges define the linear conversion between stored and physical values.
+     @param frequency The channel frequency.
+     @param physicalMax Physical value of the digital maximum.
+     @param physicalMin Physical value of the digital minimum.
+     @param digitalMax Maximum digital value of the channel.
+     @param digitalMin Minimum digital value of the channel.
+     */
+    EDFSignalSamples(double, double, double, int, int);
+
+    virtual ~EDFSignalSamples() = default;
+
+    /**
+     Add digital samples to the end of the signal, converting them to the stored
+     representation.
+     @param vals Digital samples as stored in the file.
+     @param length Length of vals array.
+     */
+    void addDigitalSamples(const int16_t*, size_t);
+
+    /**
+     Add samples already in physical units to the end of the signal, such as
+     filtered samples. Digital storage rounds them to the nearest digital
+     value the int16_t range can hold.
+     @param vals Physical samples.
+     @param length Length of vals array.
+     */
+    void addPhysicalSamples(const double*, size_t);
+
+    /**
+     Reserve storage for a known number of samples.
+     @param count Number of samples.
+     */
+    void reserve(size_t);
+
+    /**
+     Get length of object's data.
+     @return Number of samples stored.
+     */
+    size_t size() const;
+
+    /**
+     Get the frequency of the data stored in hertz.
+     @return Frequency of the samples.
+     */
+    double frequency() const;
+
+    /**
+     Get the length of time the data represents in seconds.
+     @return Time length of data.
+     */
+    double time() const;
+
+    /**
+     Check whether the stored samples are digital values.
+     @return true for the int16_t instantiation.
+     */
+    static bool storesDigital();
+
+    /**
+     Get the multiplier that converts a digital value to physical units.
+     @return Physical units per digital step.
+     */
+    double gain() const;
+
+    /**
+     Get the physical value of digital zero.
+     @return Physical offset.
+     */
+    double offset() const;
+
+    /**
+     Get the stored samples.
+     @return Reference to the samples, valid while this object lives.
+     */
+    const std::vector<T>& data() const;
+
+    /**
+     Get one sample converted to physical units.
+     @param index Sample index, must be less than size().
+     @return Physical value.
+     */
+    double physical(size_t) const;
+
+    /**
+     Convert a range of samples to physical units.
+     @param out Destination for at least count values.
+     @param first Index of the first sample to convert.
+     @param count Number of samples to convert.
+     */
+    void physicalData(float*, size_t, size_t) const;
+
+    /**
+     Get the moments of the samples in physical units. They are accumulated
+     from the raw digital samples as they are added.
+     @return Count, mean and central moment sums.
+     */
+    EDFMoments moments() const;
+
+    /**
+     Get the maximum value present in the data, in stored units.
+     @return Maximum sample.
+     */
+    T max() const;
+
+    /**
+     Get the minimum value present in the data, in stored units.
+     @return Minimum sample.
+     */
+    T min() const;
+
+private:
+    std::vector<T> samples;
+
+    double sFrequency; // in hertz
+    double sGain, sOffset;
+    T sMax, sMin;
+    EDFMoments sMoments; // of the digital samples
+};
+
+#endif	/* _EDFSIGNALSAMPLES_H */
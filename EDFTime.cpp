@@ -127,7 +127,7 @@ std::ostream& operator<<(std::ostream& s, EDFTime time) {
     return s;
 }
 
-bool EDFTime::operator==(const EDFTime& rhs) {
+bool EDFTime::operator==(const EDFTime& rhs) const {
     return this->t_hour == rhs.t_hour &&
            this->t_min == rhs.t_min &&
            this->t_sec == rhs.t_sec;
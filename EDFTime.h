@@ -71,7 +71,7 @@ public:
      Test deep equality.
      @return true if all properties are equal, otherwise false.
      */
-    bool operator==(const EDFTime&);
+    bool operator==(const EDFTime&) const;
 
     /**
      Get the integer hour of this object.
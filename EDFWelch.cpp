@@ -0,0 +1,117 @@
+/**
+ @file EDFWelch.cpp
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#include "EDFWelch.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using std::vector;
+
+const double PI = 3.14159265358979323846;
+
+EDFWelch::EDFWelch(double sampleRate, int segmentLength, int overlap, EDFTaper taper)
+    : w_sampleRate(sampleRate)
+    , w_length(std::max(segmentLength, 2))
+    , w_overlap(std::min(std::max(overlap, 0), w_length - 1))
+    , w_plan(w_length)
+    , w_filled(0)
+    , w_segments(0)
+{
+    // periodic windows, as spectral estimators use them
+    w_window.resize(w_length);
+    double squares = 0;
+    for (int i = 0; i < w_length; i++) {
+        double phase = 2 * PI * i / w_length;
+        switch (taper) {
+            case EDFTaper::RECTANGULAR: w_window[i] = 1; break;
+            case EDFTaper::HANN:        w_window[i] = 0.5 - 0.5 * cos(phase); break;
+            case EDFTaper::HAMMING:     w_window[i] = 0.54 - 0.46 * cos(phase); break;
+        }
+        squares += w_window[i] * w_window[i];
+    }
+    w_scale = 1 / (w_sampleRate * squares);
+
+    w_buffer.resize(w_length);
+    w_segment.assign(w_plan.size(), 0);
+    w_power.resize(w_plan.bins());
+    w_sum.assign(w_plan.bins(), 0);
+}
+
+void EDFWelch::add(const double* vals, size_t length) {
+    while (length > 0) {
+        size_t take = std::min(length, static_cast<size_t>(w_length - w_filled));
+        memcpy(w_buffer.data() + w_filled, vals, take * sizeof(double));
+        w_filled += static_cast<int>(take);
+        vals += take;
+        length -= take;
+
+        if (w_filled == w_length) {
+            processSegment();
+            // the tail of this segment starts the next one
+            memmove(w_buffer.data(), w_buffer.data() + w_length - w_overlap, w_overlap * sizeof(double));
+            w_filled = w_overlap;
+        }
+    }
+}
+
+void EDFWelch::processSegment() {
+    double mean = 0;
+    for (int i = 0; i < w_length; i++)
+        mean += w_buffer[i];
+    mean /= w_length;
+
+    for (int i = 0; i < w_length; i++)
+        w_segment[i] = (w_buffer[i] - mean) * w_window[i];
+    w_plan.power(w_segment.data(), w_power.data());
+
+    // one-sided, every bin but DC and Nyquist stands for two
+    int last = w_plan.bins() - 1;
+    for (int k = 0; k <= last; k++)
+        w_sum[k] += (k == 0 || k == last ? 1 : 2) * w_scale * w_power[k];
+    w_segments++;
+}
+
+void EDFWelch::reset() {
+    std::fill(w_sum.begin(), w_sum.end(), 0);
+    w_filled = 0;
+    w_segments = 0;
+}
+
+int EDFWelch::segments() const { return w_segments; }
+
+int EDFWelch::bins() const { return w_plan.bins(); }
+
+double EDFWelch::frequency(int bin) const {
+    return bin * w_sampleRate / w_plan.size();
+}
+
+double EDFWelch::density(int bin) const {
+    return w_segments > 0 ? w_sum[bin] / w_segments : 0;
+}
+
+vector<double> EDFWelch::psd() const {
+    vector<double> result;
+    if (w_segments > 0)
+        for (int k = 0; k < bins(); k++)
+            result.push_back(density(k));
+    return result;
+}
+
+double EDFWelch::bandPower(const EDFBand& band) const {
+    double power = 0;
+    for (int k = 0; k < bins(); k++) {
+        double f = frequency(k);
+        if (f >= band.low && f < band.high)
+            power += density(k);
+    }
+    return power * w_sampleRate / w_plan.size();
+}
+
+void EDFWelch::bandPowers(const vector<EDFBand>& bands, double* out) const {
+    for (size_t b = 0; b < bands.size(); b++)
+        out[b] = bandPower(bands[b]);
+}
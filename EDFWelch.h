@@ -0,0 +1,122 @@
+/**
+ @file EDFWelch.h
+ @brief Welch power spectral density and band power of a stream of samples.
+ Samples are added in pieces of any size, such as one data record at a time.
+ Whenever a segment fills, its mean is removed, it is tapered, transformed
+ and its periodogram added to a running sum; the last overlap samples start
+ the next segment. The estimator keeps its FFT plan and buffers across
+ reset(), so one estimator can serve every epoch of every channel sampled at
+ the same rate.
+
+ Densities are one-sided in squared physical units per hertz, scaled as
+ scipy.signal.welch does by default, so summing a band's bins times the bin
+ width gives the band's power.
+
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#ifndef _EDFWELCH_H
+#define	_EDFWELCH_H
+
+#include <cstddef>
+#include <vector>
+#include "EDFFFT.h"
+
+enum class EDFTaper { RECTANGULAR, HANN, HAMMING };
+
+/**
+ A frequency band, low edge included and high edge excluded.
+ */
+struct EDFBand {
+    double low;  // in hertz
+    double high; // in hertz
+};
+
+class EDFWelch {
+public:
+    /**
+     Constructor.
+     @param sampleRate Samples per second of the stream.
+     @param segmentLength Samples per segment. Transforms are zero padded to
+     the next power of two.
+     @param overlap Samples shared by consecutive segments, less than segmentLength.
+     @param taper Window applied to each segment.
+     */
+    EDFWelch(double, int, int, EDFTaper = EDFTaper::HANN);
+
+    /**
+     Add consecutive samples.
+     @param vals Samples in physical units.
+     @param length Length of vals array.
+     */
+    void add(const double*, size_t);
+
+    /**
+     Drop all segments and buffered samples, keeping the plan and buffers.
+     */
+    void reset();
+
+    /**
+     Get the number of segments averaged so far.
+     @return Completed segments.
+     */
+    int segments() const;
+
+    /**
+     Get the number of frequency bins.
+     @return Transform size / 2 + 1.
+     */
+    int bins() const;
+
+    /**
+     Get the frequency of a bin.
+     @param bin Bin index.
+     @return Frequency in hertz.
+     */
+    double frequency(int) const;
+
+    /**
+     Get the averaged density of a bin.
+     @param bin Bin index.
+     @return Power per hertz, 0 before the first segment completes.
+     */
+    double density(int) const;
+
+    /**
+     Get the averaged densities of all bins.
+     @return bins() values, empty before the first segment completes.
+     */
+    std::vector<double> psd() const;
+
+    /**
+     Integrate the density over a band.
+     @param band Frequencies to include.
+     @return Power in the band, in squared physical units.
+     */
+    double bandPower(const EDFBand&) const;
+
+    /**
+     Integrate the density over several bands.
+     @param bands Frequencies to include.
+     @param out One power per band.
+     */
+    void bandPowers(const std::vector<EDFBand>&, double*) const;
+
+private:
+    double w_sampleRate;
+    int w_length, w_overlap;
+    EDFFFT w_plan;
+    std::vector<double> w_window;
+    double w_scale;                  // density of one periodogram bin per |X|^2
+    std::vector<double> w_buffer;    // samples of the segment being filled
+    int w_filled;
+    std::vector<double> w_segment;   // tapered and zero padded segment
+    std::vector<double> w_power;     // periodogram of the last segment
+    std::vector<double> w_sum;       // of all periodograms
+    int w_segments;
+
+    void processSegment();
+};
+
+#endif	/* _EDFWELCH_H */
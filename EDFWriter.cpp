@@ -0,0 +1,310 @@
+/**
+ @file EDFWriter.cpp
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#include "EDFWriter.h"
+#include "EDFDiagnostics.h"
+#include "EDFEncode.h"
+#include "EDFFile.h"
+#include "EDFUtil.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+using std::string;
+using std::vector;
+
+// byte offset of the data record count in the fixed header
+const long long RECORD_COUNT_FIELD = 236;
+
+bool writeAll(int, const char*, size_t, long long);
+bool readAll(int, char*, size_t, long long);
+
+EDFWriter::EDFWriter()
+    : w_fd(-1)
+    , w_headerSize(0)
+    , w_recordSize(0)
+    , w_written(0)
+    , w_committed(-1)
+    , w_onDisk(0)
+    , w_interval(1)
+    , w_nextOnset(0)
+{}
+
+EDFWriter::~EDFWriter() {
+    close();
+}
+
+bool EDFWriter::create(const char* path, const EDFHeader& header) {
+    close();
+
+    // the record layout follows from the sample counts
+    w_header = header;
+    int offset = 0;
+    range_loop(sig, 0, w_header.signalCount(), 1) {
+        w_header.setBufferOffset(sig, offset);
+        offset += 2 * w_header.signalSampleCount(sig);
+    }
+    w_header.setDataRecordSize(offset);
+    w_header.setDataRecordCount(-1);
+    if (offset <= 0) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::HEADER_FORMAT,
+                               "EDFWriter: Header describes no samples. Giving up...");
+        return false;
+    }
+
+    w_fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (w_fd < 0) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::FILE_ACCESS,
+                               string("EDFWriter: File '") + path + "' cannot be written.");
+        return false;
+    }
+
+    string head = encodeHeader(w_header);
+    if (!writeAll(w_fd, head.data(), head.size(), 0) || fsync(w_fd) != 0) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::FILE_ACCESS,
+                               "EDFWriter: Error writing header. Giving up...");
+        ::close(w_fd);
+        w_fd = -1;
+        return false;
+    }
+
+    w_headerSize = static_cast<long long>(head.size());
+    w_recordSize = offset;
+    w_written = w_onDisk = 0;
+    w_committed = -1;
+    w_nextOnset = 0;
+    return true;
+}
+
+bool EDFWriter::open(const char* path) {
+    close();
+    if (recover(path) < 0)
+        return false;
+
+    EDFFile file(path);
+    if (file.header() == nullptr)
+        return false;
+    w_header = *file.header();
+    w_headerSize = 256 + 256LL * w_header.signalCount();
+    w_recordSize = w_header.dataRecordSize();
+    w_written = w_onDisk = w_committed = w_header.dataRecordCount();
+
+    w_fd = ::open(path, O_RDWR);
+    if (w_fd < 0) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::FILE_ACCESS,
+                               string("EDFWriter: File '") + path + "' cannot be written.");
+        return false;
+    }
+
+    // continue from the timekeeping annotation of the last record
+    w_nextOnset = w_written * w_header.dataRecordDuration();
+    int annotation = w_header.annotationIndex();
+    if (annotation >= 0 && w_written > 0) {
+        vector<char> tal(2 * w_header.signalSampleCount(annotation) + 1, 0);
+        long long at = w_headerSize + static_cast<long long>(w_written - 1) * w_recordSize + w_header.bufferOffset(annotation);
+        if (readAll(w_fd, tal.data(), tal.size() - 1, at))
+            w_nextOnset = atof(tal.data()) + w_header.dataRecordDuration();
+    }
+    return true;
+}
+
+bool EDFWriter::writeRecord(const char* record) {
+    if (w_fd < 0) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::FILE_ACCESS,
+                               "EDFWriter: No file is open for writing. Giving up...");
+        return false;
+    }
+
+    w_pending.insert(w_pending.end(), record, record + w_recordSize);
+    w_written++;
+    if (w_written - w_onDisk >= w_interval)
+        return commit();
+    return true;
+}
+
+bool EDFWriter::writeRecord(const int16_t* const* signals, double onset) {
+    if (onset < 0)
+        onset = w_nextOnset;
+
+    w_record.assign(w_recordSize, 0);
+    int channel = 0;
+    range_loop(sig, 0, w_header.signalCount(), 1) {
+        char* out = w_record.data() + w_header.bufferOffset(sig);
+        size_t room = 2 * static_cast<size_t>(w_header.signalSampleCount(sig));
+        if (sig != w_header.annotationIndex()) {
+            encodeSamples(signals[channel++], out, w_header.signalSampleCount(sig));
+            continue;
+        }
+
+        // timekeeping first, then queued events while they fit
+        string tal = encodeTAL(onset, "");
+        while (!w_events.empty()) {
+            string event = encodeTAL(w_events.front().first, w_events.front().second);
+            if (tal.size() + event.size() > room) {
+                if (encodeTAL(onset, "").size() + event.size() > room) {
+                    EDFDiagnostics::report(EDFSeverity::WARNING, EDFDiagnosticCode::ANNOTATION_SIGNAL,
+                                           "EDFWriter: Annotation does not fit in a record. Dropping...");
+                    w_events.erase(w_events.begin());
+                    continue;
+                }
+                break;
+            }
+            tal += event;
+            w_events.erase(w_events.begin());
+        }
+        memcpy(out, tal.data(), std::min(tal.size(), room));
+    }
+
+    w_nextOnset = onset + w_header.dataRecordDuration();
+    return writeRecord(w_record.data());
+}
+
+void EDFWriter::addAnnotation(double onset, const string& text) {
+    if (w_header.annotationIndex() < 0) {
+        EDFDiagnostics::report(EDFSeverity::WARNING, EDFDiagnosticCode::ANNOTATION_SIGNAL,
+                               "EDFWriter: File has no annotation signal. Ignoring...");
+        return;
+    }
+    w_events.push_back(std::make_pair(onset, text));
+}
+
+void EDFWriter::setCommitInterval(int records) {
+    w_interval = std::max(records, 1);
+}
+
+bool EDFWriter::commit() {
+    if (w_fd < 0)
+        return false;
+
+    if (!w_pending.empty()) {
+        long long at = w_headerSize + static_cast<long long>(w_onDisk) * w_recordSize;
+        if (!writeAll(w_fd, w_pending.data(), w_pending.size(), at)) {
+            EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::FILE_ACCESS,
+                                   "EDFWriter: Error writing records. Giving up...");
+            return false;
+        }
+        w_onDisk = w_written;
+        w_pending.clear();
+    }
+    if (w_committed == w_onDisk)
+        return true;
+
+    // the records reach the disk before the count that declares them
+    if (fsync(w_fd) != 0 || !writeCount(w_onDisk) || fsync(w_fd) != 0) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::FILE_ACCESS,
+                               "EDFWriter: Error committing records. Giving up...");
+        return false;
+    }
+    w_committed = w_onDisk;
+    return true;
+}
+
+bool EDFWriter::close() {
+    if (w_fd < 0)
+        return true;
+
+    bool committed = commit();
+    ::close(w_fd);
+    w_fd = -1;
+    w_pending.clear();
+    w_events.clear();
+    return committed;
+}
+
+int EDFWriter::recordCount() const { return w_written; }
+
+int EDFWriter::committedCount() const { return w_committed; }
+
+const EDFHeader& EDFWriter::header() const { return w_header; }
+
+int EDFWriter::recover(const char* path) {
+    int fd = ::open(path, O_RDWR);
+    if (fd < 0) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::FILE_ACCESS,
+                               string("EDFWriter: File '") + path + "' cannot be opened for recovery.");
+        return -1;
+    }
+
+    // only the fields that fix the record layout are needed
+    char fixed[256];
+    int signals = 0, recordSize = 0, declared = 0;
+    vector<char> signalHeaders;
+    if (readAll(fd, fixed, sizeof(fixed), 0)) {
+        signals = atoi(string(fixed + 252, 4).c_str());
+        declared = atoi(string(fixed + RECORD_COUNT_FIELD, 8).c_str());
+        signalHeaders.resize(256 * static_cast<size_t>(std::max(signals, 0)));
+        if (signals > 0 && readAll(fd, signalHeaders.data(), signalHeaders.size(), 256)) {
+            range_loop(sig, 0, signals, 1)
+                recordSize += 2 * atoi(string(signalHeaders.data() + 216 * signals + 8 * sig, 8).c_str());
+        }
+    }
+    struct stat info;
+    long long headerSize = 256 + 256LL * signals;
+    if (recordSize <= 0 || fstat(fd, &info) != 0 || info.st_size < headerSize) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::HEADER_FORMAT,
+                               string("EDFWriter: File '") + path + "' has no readable record layout. Giving up...");
+        ::close(fd);
+        return -1;
+    }
+
+    // records past a committed count were never synced, so only a -1 count is taken from the length
+    long long whole = (info.st_size - headerSize) / recordSize;
+    if (declared >= 0)
+        whole = std::min(whole, static_cast<long long>(declared));
+    bool repaired = true;
+    if (info.st_size != headerSize + whole * recordSize)
+        repaired = ftruncate(fd, headerSize + whole * recordSize) == 0;
+    if (repaired && declared != whole) {
+        string field = encodeNumber(static_cast<double>(whole), 8);
+        repaired = writeAll(fd, field.data(), field.size(), RECORD_COUNT_FIELD);
+    }
+    repaired = repaired && fsync(fd) == 0;
+    ::close(fd);
+
+    if (!repaired) {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::FILE_ACCESS,
+                               string("EDFWriter: File '") + path + "' could not be repaired. Giving up...");
+        return -1;
+    }
+    return static_cast<int>(whole);
+}
+
+bool EDFWriter::writeCount(int count) {
+    string field = encodeNumber(count, 8);
+    return writeAll(w_fd, field.data(), field.size(), RECORD_COUNT_FIELD);
+}
+
+bool writeAll(int fd, const char* data, size_t length, long long offset) {
+    while (length > 0) {
+        ssize_t done = pwrite(fd, data, length, static_cast<off_t>(offset));
+        if (done < 0 && errno == EINTR)
+            continue;
+        if (done <= 0)
+            return false;
+        data += done;
+        length -= static_cast<size_t>(done);
+        offset += done;
+    }
+    return true;
+}
+
+bool readAll(int fd, char* data, size_t length, long long offset) {
+    while (length > 0) {
+        ssize_t done = pread(fd, data, length, static_cast<off_t>(offset));
+        if (done < 0 && errno == EINTR)
+            continue;
+        if (done <= 0)
+            return false;
+        data += done;
+        length -= static_cast<size_t>(done);
+        offset += done;
+    }
+    return true;
+}
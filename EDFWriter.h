@@ -0,0 +1,146 @@
+/**
+ @file EDFWriter.h
+ @brief Appends data records to an EDF or EDF+ file as they are acquired.
+ Records are gathered in memory and committed together: the record bytes
+ are written and synced first, then the data record count in the header is
+ rewritten in one 8 byte write and synced. A reader, or a crash, therefore
+ never sees a count larger than the records on disk. The count reads -1
+ until the first commit, as EDF prescribes while a recording is running.
+
+ A file left behind by a crash is repaired by recover(), which cuts the
+ file back to its committed records. A count still at -1 is set from the
+ whole records present and any torn record at the end is dropped.
+
+ @author Anthony Magee
+ @date 10/19/2026
+ */
+
+#ifndef _EDFWRITER_H
+#define	_EDFWRITER_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "EDFHeader.h"
+
+class EDFWriter {
+public:
+    EDFWriter();
+    virtual ~EDFWriter();
+
+    EDFWriter(const EDFWriter&) = delete;
+    EDFWriter& operator=(const EDFWriter&) = delete;
+
+    /**
+     Create a file, replacing any file at the path, and write its header.
+     Data record size and buffer offsets are derived from the signal sample
+     counts. EDF+ files need an annotation signal large enough for the
+     timekeeping annotation and any events added.
+     @param path Output path.
+     @param header Description of the recording. The record count is ignored.
+     @return true if the header was written.
+     */
+    bool create(const char*, const EDFHeader&);
+
+    /**
+     Open an existing file to add records after the ones it holds. The file
+     is recovered first, so one left by a crash can be continued.
+     @param path Path of the file.
+     @return true if the file could be recovered and opened.
+     */
+    bool open(const char*);
+
+    /**
+     Add one data record of encoded bytes, annotation signal included.
+     @param record dataRecordSize() bytes.
+     @return false if a commit it triggered failed.
+     */
+    bool writeRecord(const char*);
+
+    /**
+     Add one data record of digital samples. For EDF+ the annotation signal
+     is filled with the timekeeping annotation and as many added events as
+     fit.
+     @param signals One array per signal except the annotation signal, in
+     signal order, each holding that signal's samples per record.
+     @param onset Start of the record in seconds, or negative to follow on
+     from the previous record without a gap.
+     @return false if a commit it triggered failed.
+     */
+    bool writeRecord(const int16_t* const*, double = -1);
+
+    /**
+     Queue an event for the annotation signal of the next EDF+ records.
+     @param onset Seconds from the start of the recording.
+     @param text Annotation text.
+     */
+    void addAnnotation(double, const std::string&);
+
+    /**
+     Set how many records are gathered before they are committed. A shorter
+     interval makes records durable and visible to readers sooner at the
+     price of more syncs.
+     @param records Records per commit, at least 1.
+     */
+    void setCommitInterval(int);
+
+    /**
+     Write and sync the gathered records, then update the record count.
+     @return true if both reached the disk.
+     */
+    bool commit();
+
+    /**
+     Commit and close the file.
+     @return true if the final commit succeeded.
+     */
+    bool close();
+
+    /**
+     Get the number of records added, committed or not.
+     @return Record count.
+     */
+    int recordCount() const;
+
+    /**
+     Get the number of records the header on disk declares.
+     @return Committed record count, -1 before the first commit.
+     */
+    int committedCount() const;
+
+    /**
+     Get the header of the file being written.
+     @return Header with derived record layout.
+     */
+    const EDFHeader& header() const;
+
+    /**
+     Repair a file whose header count is -1 or does not match its length,
+     as left by a crash during a recording. Records beyond a committed
+     count are removed. A count of -1 is set from the whole records
+     present, after removing a torn record at the end.
+     @param path Path of the file.
+     @return Number of whole records the file now declares, or -1 if it
+     could not be read or rewritten.
+     */
+    static int recover(const char*);
+
+private:
+    int w_fd;
+    EDFHeader w_header;
+    long long w_headerSize;
+    int w_recordSize;
+    int w_written;               // records added
+    int w_committed;             // records declared on disk, -1 before the first commit
+    int w_onDisk;                // records written to disk
+    int w_interval;              // records per commit
+    double w_nextOnset;
+    std::vector<char> w_pending; // records waiting for the next commit
+    std::vector<char> w_record;
+    std::vector<std::pair<double, std::string> > w_events;
+
+    bool writeCount(int);
+};
+
+#endif	/* _EDFWRITER_H */
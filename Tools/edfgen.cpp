@@ -0,0 +1,121 @@
+//
+//  edfgen.cpp
+//  Tools
+//
+//  Writes a deterministic synthetic EDF or EDF+ file.
+//
+//  ./edfgen out.edf [--seed n] [--channels 32] [--samples 256[,512,...]]
+//                   [--records n | --size 50G] [--duration 1]
+//                   [--plus | --discontinuous] [--annotations n]
+//                   [--gaps probability] [--max-gap seconds]
+//
+//  --samples takes a comma separated list of samples per record that is
+//  cycled over the channels, giving mixed sample rates. --size picks the
+//  record count that brings the file closest to the requested size.
+//
+
+#include "EDFLib.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+using std::cout;
+using std::cerr;
+using std::endl;
+
+long long parseSize(const string& s) {
+    char* end = nullptr;
+    double value = strtod(s.c_str(), &end);
+    switch (*end) {
+        case 'k': case 'K': value *= 1LL << 10; break;
+        case 'm': case 'M': value *= 1LL << 20; break;
+        case 'g': case 'G': value *= 1LL << 30; break;
+        case 't': case 'T': value *= 1LL << 40; break;
+        default: break;
+    }
+    return static_cast<long long>(value);
+}
+
+vector<int> parseList(const string& s) {
+    vector<int> values;
+    std::istringstream in(s);
+    string item;
+    while (std::getline(in, item, ','))
+        if (atoi(item.c_str()) > 0)
+            values.push_back(atoi(item.c_str()));
+    return values;
+}
+
+int usage(const char* name) {
+    cerr << "usage: " << name << " out.edf [--seed n] [--channels n] [--samples n[,n...]]"
+         << " [--records n | --size bytes[K|M|G|T]] [--duration seconds] [--plus | --discontinuous]"
+         << " [--annotations n] [--gaps probability] [--max-gap seconds]" << endl;
+    return EXIT_FAILURE;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argv[1][0] == '-')
+        return usage(argv[0]);
+
+    string path = argv[1];
+    uint64_t seed = 1;
+    int channels = 32, records = 3600, annotations = 0;
+    vector<int> samples(1, 256);
+    long long size = 0;
+    double duration = 1, gaps = 0, maxGap = 10;
+    FileType filetype = FileType::EDF;
+    Continuity continuity = Continuity::CONTINUOUS;
+
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--seed" && hasValue) seed = strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--channels" && hasValue) channels = atoi(argv[++i]);
+        else if (arg == "--samples" && hasValue) samples = parseList(argv[++i]);
+        else if (arg == "--records" && hasValue) records = atoi(argv[++i]);
+        else if (arg == "--size" && hasValue) size = parseSize(argv[++i]);
+        else if (arg == "--duration" && hasValue) duration = atof(argv[++i]);
+        else if (arg == "--plus") filetype = FileType::EDFPLUS;
+        else if (arg == "--discontinuous") { filetype = FileType::EDFPLUS; continuity = Continuity::DISCONTINUOUS; }
+        else if (arg == "--annotations" && hasValue) annotations = atoi(argv[++i]);
+        else if (arg == "--gaps" && hasValue) gaps = atof(argv[++i]);
+        else if (arg == "--max-gap" && hasValue) maxGap = atof(argv[++i]);
+        else return usage(argv[0]);
+    }
+    if (channels < 1 || samples.empty() || records < 0 || duration <= 0)
+        return usage(argv[0]);
+
+    EDFGenerator generator(seed);
+    generator.setFiletype(filetype, continuity);
+    generator.setRecordDuration(duration);
+    generator.setAnnotations(annotations);
+    generator.setGaps(gaps, maxGap);
+    for (int c = 0; c < channels; c++)
+        generator.addChannel("EEG " + std::to_string(c), samples[c % samples.size()], 1 + (c * 7) % 40);
+
+    if (size > 0) {
+        // the annotation signal grows with the record count so settle on it iteratively
+        generator.setRecordCount(1);
+        long long perRecord = generator.fileSize() - generator.header().signalCount() * 256LL - 256;
+        for (int pass = 0; pass < 3; pass++) {
+            records = static_cast<int>(std::max(1LL, size / perRecord));
+            generator.setRecordCount(records);
+            perRecord = generator.header().dataRecordSize();
+        }
+    }
+    generator.setRecordCount(records);
+
+    if (!generator.write(path.c_str()))
+        return EXIT_FAILURE;
+
+    EDFHeader header = generator.header();
+    cout << path << ": " << header.signalCount() << " signals, " << records << " records of "
+         << header.dataRecordSize() << " bytes, " << generator.fileSize() << " bytes" << endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,43 @@
+//
+//  edfmerge.cpp
+//  Tools
+//
+//  Merges recordings split across EDF or EDF+ files with the same signals
+//  into one EDF+D file. Records are copied without decoding and the gaps
+//  between the files are kept in the time-keeping annotations.
+//
+//  ./edfmerge out.edf in1.edf in2.edf [...]
+//
+
+#include "EDFLib.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+using std::cout;
+using std::cerr;
+using std::endl;
+
+int usage(const char* name) {
+    cerr << "usage: " << name << " out.edf in.edf [in.edf ...]" << endl;
+    return EXIT_FAILURE;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3)
+        return usage(argv[0]);
+
+    vector<string> sources(argv + 2, argv + argc);
+    if (!mergeFiles(sources, argv[1]))
+        return EXIT_FAILURE;
+
+    EDFFile file(argv[1]);
+    if (file.header() == nullptr)
+        return EXIT_FAILURE;
+    cout << argv[1] << ": " << file.header()->dataRecordCount() << " records from " << sources.size() << " files" << endl;
+    return EXIT_SUCCESS;
+}
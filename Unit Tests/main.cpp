@@ -9,11 +9,19 @@
 #define CATCH_CONFIG_RUNNER
 
 #include "EDFLib.h"
+#include "EDFBatchReader.h"
 #include "catch.hpp"
 
 #include <string>
 #include <limits>
 #include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <fstream>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <type_traits>
 
 using std::string;
 using std::vector;
@@ -43,6 +51,26 @@ int main (int argc, char* const argv[]) {
 
 
 
+/***** HELPERS *****/
+
+/* A file in the working directory that is removed however the test ends */
+class TempFile {
+public:
+    explicit TempFile(const string& path) : t_path(path), t_written(false) {}
+    TempFile(const string& path, const EDFGenerator& generator) : t_path(path), t_written(generator.write(path.c_str())) {}
+    TempFile(const TempFile&) = delete;
+    TempFile& operator=(const TempFile&) = delete;
+    ~TempFile() { remove(t_path.c_str()); }
+    
+    bool written() const { return t_written; }
+    
+private:
+    string t_path;
+    bool t_written;
+};
+
+/***** HELPERS *****/
+
 /***** UTILS *****/
 
 TEST_CASE("Utils - Space Replacement") {
@@ -102,6 +130,65 @@ TEST_CASE("Utils - Trim String") {
 
 /***** UTILS *****/
 
+/***** DIAGNOSTICS *****/
+
+class CollectingSink : public EDFDiagnosticSink {
+public:
+    vector<EDFDiagnostic> reports;
+    void report(const EDFDiagnostic& diagnostic) { reports.push_back(diagnostic); }
+};
+
+TEST_CASE("Diagnostics - Sink and Counters") {
+    CollectingSink sink;
+    EDFDiagnostics::setSink(&sink);
+    EDFDiagnostics::resetCounters();
+    
+    SECTION("reports reach the sink and are counted") {
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::RECORD_READ, "read failed");
+        EDFDiagnostics::report(EDFSeverity::WARNING, EDFDiagnosticCode::ANNOTATION_FORMAT, "bad onset", 3);
+        REQUIRE(sink.reports.size() == 2);
+        REQUIRE(sink.reports[0].severity == EDFSeverity::ERROR);
+        REQUIRE(sink.reports[0].message == "read failed");
+        REQUIRE(sink.reports[1].occurrences == 3);
+        REQUIRE(EDFDiagnostics::count(EDFDiagnosticCode::RECORD_READ) == 1);
+        REQUIRE(EDFDiagnostics::count(EDFDiagnosticCode::ANNOTATION_FORMAT) == 3);
+        REQUIRE(EDFDiagnostics::count(EDFSeverity::WARNING) == 3);
+        REQUIRE(std::string(EDFDiagnostics::name(EDFDiagnosticCode::VALUE_RANGE)) == "VALUE_RANGE");
+    }
+    
+    SECTION("rate limit per kind") {
+        EDFDiagnostics::setRateLimit(5);
+        for (int i = 0; i < 20; i++)
+            EDFDiagnostics::report(EDFSeverity::WARNING, EDFDiagnosticCode::HEADER_FORMAT, "noisy");
+        EDFDiagnostics::report(EDFSeverity::ERROR, EDFDiagnosticCode::FILE_LENGTH, "other kind");
+        REQUIRE(sink.reports.size() == 7); // five, one suppression notice, the other kind
+        REQUIRE(sink.reports[5].severity == EDFSeverity::INFO);
+        REQUIRE(sink.reports[6].code == EDFDiagnosticCode::FILE_LENGTH);
+        REQUIRE(EDFDiagnostics::count(EDFDiagnosticCode::HEADER_FORMAT) == 20);
+        REQUIRE(EDFDiagnostics::suppressed(EDFDiagnosticCode::HEADER_FORMAT) == 15);
+        REQUIRE_FALSE(EDFDiagnostics::accepts(EDFDiagnosticCode::HEADER_FORMAT));
+        REQUIRE(EDFDiagnostics::accepts(EDFDiagnosticCode::FILE_LENGTH));
+        EDFDiagnostics::setRateLimit(10);
+    }
+    
+    SECTION("out of range samples are reported once per batch") {
+        vector<double> clipped(1000, 5000);
+        clipped[0] = 0;
+        EDFSignalData data(256, 3200, -3200);
+        data.addDataPoints(clipped.data(), clipped.size());
+        REQUIRE(sink.reports.size() == 1);
+        REQUIRE(sink.reports[0].code == EDFDiagnosticCode::VALUE_RANGE);
+        REQUIRE(sink.reports[0].occurrences == 999);
+        REQUIRE(EDFDiagnostics::count(EDFDiagnosticCode::VALUE_RANGE) == 999);
+        REQUIRE(data.size() == 1000);
+    }
+    
+    EDFDiagnostics::setSink(nullptr);
+    EDFDiagnostics::resetCounters();
+}
+
+/***** DIAGNOSTICS *****/
+
 /***** TIME *****/
 
 TEST_CASE("Time - String Constructor") {
@@ -489,6 +576,19 @@ TEST_CASE("Patient - Assignment") {
     }
 }
 
+TEST_CASE("Patient - Move") {
+    EDFPatient p1("12345", "Last_First", "extra", Gender::FEMALE, "01-JAN-2000");
+    EDFPatient p2(std::move(p1));
+    REQUIRE(p2.name() == "Last_First");
+    REQUIRE(p2.gender() == Gender::FEMALE);
+    
+    EDFPatient p3;
+    p3 = std::move(p2);
+    REQUIRE(p3.code() == "12345");
+    REQUIRE(p3.additional() == "extra");
+    REQUIRE(p3.birthdate() == "01-JAN-2000");
+}
+
 /***** PATIENT *****/
 
 /***** SIGNAL DATA *****/
@@ -604,6 +704,34 @@ TEST_CASE("SignalData - assignment") {
     }
 }
 
+TEST_CASE("SignalData - move") {
+    vector<double> sig = {94.0, 32.0, 0.0, -11.0, 90.0, 80.0, -47.0, -39.0, 1.0, 17.0};
+    EDFSignalData d1(10, 100, -100);
+    d1.addDataPoints(sig.data(), sig.size());
+    const double* samples = d1.data().data();
+    
+    // the samples change owner without being copied
+    EDFSignalData d2(std::move(d1));
+    REQUIRE(d2.data().data() == samples);
+    REQUIRE(d2.data() == sig);
+    REQUIRE(d2.max() == 94.0);
+    REQUIRE(Approx(d2.mean()) == 21.7);
+    REQUIRE(d1.size() == 0);
+    REQUIRE(d1.moments().count() == 0);
+    
+    EDFSignalData d3(5, 10, -10);
+    d3 = std::move(d2);
+    REQUIRE(d3.data().data() == samples);
+    REQUIRE(d3.frequency() == 10);
+    REQUIRE(d3.min() == -47.0);
+    REQUIRE(d2.size() == 0);
+    
+    // a moved from object can be filled again
+    d2.addDataPoint(3);
+    REQUIRE(d2.max() == 3);
+    REQUIRE(d2.mean() == 3);
+}
+
 TEST_CASE("SignalData - stats numerical stability") {
     int len = 10;
     double sig[] = {94.0, 32.0, 0.0, -11.0, 90.0, 80.0, -47.0, -39.0, 1.0, 17.0};
@@ -631,9 +759,478 @@ TEST_CASE("SignalData - stats numerical stability") {
         REQUIRE(Approx(d2.mean()) == 3.1415926E10);
         REQUIRE(Approx(d2.variance()) == 0.0);
         REQUIRE(Approx(d2.stddev()) == 0.0);
-        REQUIRE(isnan(d2.skewness()));
-        REQUIRE(isnan(d2.kurtosis()));
+        REQUIRE(std::isnan(d2.skewness()));
+        REQUIRE(std::isnan(d2.kurtosis()));
+    }
+}
+
+TEST_CASE("SignalSamples - conversions") {
+    int16_t sig[] = {-32768, -1, 0, 1, 32767};
+    EDFSignalSamples<int16_t> raw(10, 3200, -3200, 32767, -32768);
+    EDFSignalSamples<float> phys(10, 3200, -3200, 32767, -32768);
+    raw.addDigitalSamples(sig, 5);
+    phys.addDigitalSamples(sig, 5);
+    
+    SECTION("storage") {
+        REQUIRE(EDFSignalSamples<int16_t>::storesDigital());
+        REQUIRE_FALSE(EDFSignalSamples<float>::storesDigital());
+        REQUIRE(raw.size() == 5);
+        REQUIRE(Approx(raw.time()) == 0.5);
+        REQUIRE(raw.data()[1] == -1);
+        REQUIRE(raw.max() == 32767);
+        REQUIRE(raw.min() == -32768);
+    }
+    
+    SECTION("physical values agree") {
+        REQUIRE(Approx(raw.physical(0)) == -3200.0);
+        REQUIRE(Approx(raw.physical(4)) == 3200.0);
+        float converted[5];
+        raw.physicalData(converted, 0, 5);
+        for (size_t i = 0; i < 5; i++) {
+            REQUIRE(Approx(phys.physical(i)).epsilon(1e-5) == raw.physical(i));
+            REQUIRE(Approx(converted[i]).epsilon(1e-5) == raw.physical(i));
+        }
+        REQUIRE(Approx(phys.max()) == 3200.0);
+    }
+}
+
+TEST_CASE("Decode - kernels") {
+    // two records worth of little endian samples covering sign and byte boundaries
+    char bytes[2 * 2048];
+    for (int i = 0; i < 2048; i++) {
+        int16_t v = static_cast<int16_t>((i * 7919) ^ 0x5a5a);
+        bytes[2 * i] = static_cast<char>(v & 0xff);
+        bytes[2 * i + 1] = static_cast<char>((v >> 8) & 0xff);
+    }
+    
+    SECTION("bulk decoding matches sample by sample decoding") {
+        int counts[] = {1, 20, 37, 256, 513, 1024, 2048};
+        for (int n : counts) {
+            vector<double> widened(n);
+            vector<int16_t> digital(n);
+            decodeSamples(bytes, widened.data(), n);
+            decodeSamples(bytes, digital.data(), n);
+            range_loop(i, 0, n, 1) {
+                REQUIRE(digital[i] == decodeSample<int16_t>(bytes + 2 * i));
+                REQUIRE(widened[i] == decodeSample<double>(bytes + 2 * i));
+            }
+        }
+    }
+    
+    SECTION("digital samples are two's complement") {
+        char sample[] = {static_cast<char>(0xaa), static_cast<char>(0xff)};
+        REQUIRE(decodeSample<int16_t>(sample) == -86);
+    }
+    
+    SECTION("known values across sign and byte boundaries") {
+        const unsigned char known[] = {0x34, 0x12, 0x80, 0x00, 0xff, 0x00, 0xff, 0xff, 0x80, 0xff, 0x00, 0x80, 0xff, 0x7f, 0x01, 0xfe};
+        int16_t expected[] = {4660, 128, 255, -1, -128, -32768, 32767, -511};
+        vector<int16_t> digital(8);
+        vector<double> widened(8);
+        decodeSamples(reinterpret_cast<const char*>(known), digital.data(), 8);
+        decodeSamples(reinterpret_cast<const char*>(known), widened.data(), 8);
+        range_loop(i, 0, 8, 1) {
+            REQUIRE(digital[i] == expected[i]);
+            REQUIRE(widened[i] == expected[i]);
+        }
+    }
+}
+
+TEST_CASE("Moments - blocks and merging") {
+    // a skewed sequence long enough to span several blocks and a partial one
+    vector<double> vals(1000);
+    vector<int16_t> digital(1000);
+    for (size_t i = 0; i < vals.size(); i++) {
+        digital[i] = static_cast<int16_t>((i * i) % 2003 - 700);
+        vals[i] = digital[i];
+    }
+    
+    double mean = 0;
+    for (double v : vals)
+        mean += v;
+    mean /= vals.size();
+    double m2 = 0, m3 = 0, m4 = 0;
+    for (double v : vals) {
+        double d = v - mean;
+        m2 += d * d;
+        m3 += d * d * d;
+        m4 += d * d * d * d;
+    }
+    
+    EDFMoments all;
+    all.add(vals.data(), vals.size());
+    
+    SECTION("blocks agree with a direct computation") {
+        REQUIRE(all.count() == 1000);
+        REQUIRE(Approx(all.mean()) == mean);
+        REQUIRE(Approx(all.centralSum(2)) == m2);
+        REQUIRE(Approx(all.centralSum(3)) == m3);
+        REQUIRE(Approx(all.centralSum(4)) == m4);
+        REQUIRE(Approx(all.variance()) == m2 / 999);
+    }
+    
+    SECTION("merged parts equal the whole") {
+        EDFMoments first, second, single;
+        first.add(vals.data(), 333);
+        second.add(vals.data() + 333, 667);
+        first.merge(second);
+        for (double v : vals)
+            single.add(&v, 1);
+        REQUIRE(first.count() == all.count());
+        REQUIRE(Approx(first.mean()) == all.mean());
+        REQUIRE(Approx(first.skewness()) == all.skewness());
+        REQUIRE(Approx(first.kurtosis()) == all.kurtosis());
+        REQUIRE(Approx(single.skewness()) == all.skewness());
+        REQUIRE(Approx(single.kurtosis()) == all.kurtosis());
+    }
+    
+    SECTION("digital samples scale to physical moments") {
+        EDFMoments raw;
+        raw.add(digital.data(), digital.size());
+        REQUIRE(raw.mean() == all.mean());
+        EDFMoments phys = raw.scaled(0.5, 10);
+        REQUIRE(Approx(phys.mean()) == 0.5 * mean + 10);
+        REQUIRE(Approx(phys.variance()) == 0.25 * m2 / 999);
+        REQUIRE(Approx(phys.skewness()) == all.skewness());
+        
+        EDFSignalSamples<int16_t> samples(1, 3200, -3200, 32767, -32768);
+        samples.addDigitalSamples(digital.data(), 600);
+        samples.addDigitalSamples(digital.data() + 600, 400);
+        REQUIRE(samples.moments().count() == 1000);
+        REQUIRE(Approx(samples.moments().mean()) == samples.physical(0) + (mean - digital[0]) * 6400.0 / 65535);
+    }
+}
+
+TEST_CASE("Sketches - histogram and quantiles") {
+    // a deterministic shuffle of 0..19999
+    vector<int16_t> digital(20000);
+    for (size_t i = 0; i < digital.size(); i++)
+        digital[i] = static_cast<int16_t>((i * 7919) % 20000);
+    vector<double> vals(digital.begin(), digital.end());
+    
+    SECTION("histogram bins, limits and merging") {
+        EDFHistogram whole(100, 0, 9999, 0.5, -10);
+        whole.add(digital.data(), digital.size());
+        REQUIRE(whole.bins() == 100);
+        REQUIRE(whole.total() == 20000);
+        REQUIRE(whole.above() == 10000);
+        REQUIRE(whole.below() == 0);
+        REQUIRE(whole.count(0) == 100);
+        REQUIRE(Approx(whole.edge(0)) == -10);
+        REQUIRE(Approx(whole.edge(100)) == 0.5 * 10000 - 10);
+        REQUIRE(Approx(whole.quantile(0.25)).epsilon(0.01) == 0.5 * 5000 - 10);
+        
+        EDFHistogram first(100, 0, 9999, 0.5, -10), second(100, 0, 9999, 0.5, -10);
+        first.add(digital.data(), 7000);
+        second.add(digital.data() + 7000, 13000);
+        REQUIRE(first.merge(second));
+        for (int b = 0; b < 100; b++)
+            REQUIRE(first.count(b) == whole.count(b));
+        REQUIRE_FALSE(first.merge(EDFHistogram(50, 0, 9999, 0.5, -10)));
+        REQUIRE(EDFHistogram(1000, 0, 9, 1, 0).bins() == 10);
+    }
+    
+    SECTION("quantile sketch stays small and accurate") {
+        EDFQuantileSketch sketch;
+        sketch.add(vals.data(), vals.size());
+        REQUIRE(sketch.count() == 20000);
+        REQUIRE(sketch.retained() < 1000);
+        REQUIRE(sketch.min() == 0);
+        REQUIRE(sketch.max() == 19999);
+        REQUIRE(sketch.quantile(0) == 0);
+        REQUIRE(sketch.quantile(1) == 19999);
+        double qs[] = {0.01, 0.1, 0.5, 0.9, 0.99};
+        for (double q : qs) {
+            REQUIRE(std::fabs(sketch.quantile(q) - q * 20000) < 0.02 * 20000);
+            REQUIRE(std::fabs(sketch.rank(q * 20000) - q) < 0.02);
+        }
+        REQUIRE(std::isnan(EDFQuantileSketch().quantile(0.5)));
+    }
+    
+    SECTION("merged sketches agree with one sketch") {
+        EDFQuantileSketch whole, parts[4];
+        whole.add(vals.data(), vals.size());
+        for (int p = 0; p < 4; p++)
+            parts[p].add(vals.data() + p * 5000, 5000);
+        for (int p = 1; p < 4; p++)
+            parts[0].merge(parts[p]);
+        REQUIRE(parts[0].count() == 20000);
+        REQUIRE(parts[0].retained() < 1000);
+        REQUIRE(std::fabs(parts[0].quantile(0.5) - whole.quantile(0.5)) < 0.02 * 20000);
+        
+        EDFQuantileSketch again;
+        again.add(vals.data(), vals.size());
+        REQUIRE(again.quantile(0.3) == whole.quantile(0.3));
+    }
+}
+
+TEST_CASE("Spectral - FFT and Welch") {
+    SECTION("real FFT matches a direct transform") {
+        EDFFFT plan(12);
+        REQUIRE(plan.size() == 16);
+        REQUIRE(plan.bins() == 9);
+        double x[16];
+        for (int i = 0; i < 16; i++)
+            x[i] = std::sin(0.7 * i) + 0.25 * (i % 3) - 1;
+        std::complex<double> out[9];
+        plan.forward(x, out);
+        for (int k = 0; k < 9; k++) {
+            std::complex<double> direct = 0;
+            for (int i = 0; i < 16; i++)
+                direct += x[i] * std::polar(1.0, -2 * M_PI * k * i / 16);
+            REQUIRE(Approx(out[k].real()).margin(1e-9) == direct.real());
+            REQUIRE(Approx(out[k].imag()).margin(1e-9) == direct.imag());
+        }
+    }
+    
+    // 60 s at 128 Hz of a 10 Hz sine of amplitude 4 on a 6 Hz one of amplitude 1
+    double rate = 128;
+    vector<double> x(60 * 128);
+    for (size_t i = 0; i < x.size(); i++)
+        x[i] = 4 * std::sin(2 * M_PI * 10 * i / rate) + std::sin(2 * M_PI * 6 * i / rate) + 3;
+    
+    SECTION("band powers recover the sine powers") {
+        EDFWelch welch(rate, 256, 128);
+        for (size_t i = 0; i < x.size(); i += 100)
+            welch.add(x.data() + i, std::min<size_t>(100, x.size() - i));
+        REQUIRE(welch.segments() == 59);
+        REQUIRE(welch.bins() == 129);
+        REQUIRE(Approx(welch.frequency(20)) == 10);
+        
+        vector<EDFBand> bands;
+        bands.push_back(EDFBand{4, 8});
+        bands.push_back(EDFBand{8, 12});
+        bands.push_back(EDFBand{20, 64});
+        double power[3];
+        welch.bandPowers(bands, power);
+        REQUIRE(Approx(power[0]).epsilon(0.01) == 0.5);
+        REQUIRE(Approx(power[1]).epsilon(0.01) == 8);
+        REQUIRE(power[2] < 1e-6);
+        REQUIRE(welch.density(0) < 1e-6); // mean removed per segment
+    }
+    
+    SECTION("reset reuses the estimator") {
+        EDFWelch welch(rate, 200, 0, EDFTaper::RECTANGULAR);
+        welch.add(x.data(), 1000);
+        REQUIRE(welch.segments() == 5);
+        welch.reset();
+        REQUIRE(welch.segments() == 0);
+        REQUIRE(welch.psd().empty());
+        welch.add(x.data(), x.size());
+        REQUIRE(welch.segments() == 38);
+        REQUIRE(Approx(welch.bandPower(EDFBand{0, 64})).epsilon(0.02) == 8.5);
+    }
+}
+
+TEST_CASE("Filter - stages and chains") {
+    // 2 Hz wanted, 50 Hz mains and 90 Hz noise, at 256 Hz
+    double rate = 256;
+    vector<double> x(20 * 256);
+    for (size_t i = 0; i < x.size(); i++)
+        x[i] = std::sin(2 * M_PI * 2 * i / rate) + std::sin(2 * M_PI * 50 * i / rate) + std::sin(2 * M_PI * 90 * i / rate);
+    
+    // largest deviation from the 2 Hz component away from the first and last two seconds
+    auto residual = [&](const vector<double>& y, int lag) {
+        double worst = 0;
+        for (size_t i = 512; i < y.size() - 512; i++)
+            worst = std::max(worst, std::fabs(y[i] - std::sin(2 * M_PI * 2 * (double(i) - lag) / rate)));
+        return worst;
+    };
+    
+    SECTION("blocks filter the same as one piece") {
+        EDFFilterChain whole(rate), blocks(rate);
+        whole.addLowPass(30, 4).addNotch(50).addFIRLowPass(40, 31);
+        blocks.addLowPass(30, 4).addNotch(50).addFIRLowPass(40, 31);
+        REQUIRE(whole.stages() == 4);
+        
+        vector<double> a(x), b(x);
+        whole.process(a.data(), a.size());
+        for (size_t i = 0, n = 1; i < b.size(); i += n, n = n * 3 % 97 + 1)
+            blocks.process(b.data() + i, std::min(n, b.size() - i));
+        for (size_t i = 0; i < a.size(); i++)
+            REQUIRE(Approx(b[i]).margin(1e-12) == a[i]);
+    }
+    
+    SECTION("low-pass and notch leave the wanted band") {
+        EDFFilterChain chain(rate);
+        chain.addLowPass(20, 6).addNotch(50, 5);
+        vector<double> y(x);
+        chain.process(y.data(), y.size());
+        
+        // Butterworth delay at 2 Hz is a few samples, find it
+        int best = 0;
+        for (int lag = 0; lag < 20; lag++)
+            if (residual(y, lag) < residual(y, best))
+                best = lag;
+        REQUIRE(residual(y, best) < 0.15);
+        
+        chain.reset();
+        vector<double> dc(1000, 5.0);
+        chain.process(dc.data(), dc.size());
+        REQUIRE(Approx(dc.back()) == 5.0);
+    }
+    
+    SECTION("high-pass removes offsets") {
+        EDFFilterChain chain(rate);
+        chain.addHighPass(0.5);
+        vector<double> y(x.size(), 3.0);
+        chain.process(y.data(), y.size());
+        REQUIRE(std::fabs(y.back()) < 1e-3);
+    }
+    
+    SECTION("FIR design") {
+        vector<double> taps = EDFFIRFilter::lowPassTaps(rate, 30, 63);
+        double sum = 0;
+        for (double t : taps)
+            sum += t;
+        REQUIRE(Approx(sum) == 1);
+        REQUIRE(Approx(taps[10]) == taps[52]);
+        
+        EDFFIRFilter fir(taps);
+        vector<double> y(x);
+        fir.process(y.data(), y.size());
+        REQUIRE(residual(y, 31) < 0.05);
     }
+    
+    SECTION("zero phase output is not delayed") {
+        EDFFilterChain chain(rate);
+        chain.addLowPass(20, 4).addNotch(50, 5);
+        vector<double> y(x);
+        chain.processZeroPhase(y.data(), y.size());
+        REQUIRE(residual(y, 0) < 0.05);
+    }
+}
+
+TEST_CASE("Resampler - rates and alignment") {
+    auto sine = [](double hz, double t) { return std::sin(2 * M_PI * hz * t); };
+    
+    SECTION("ratios reduce") {
+        EDFResampler down(256, 100);
+        REQUIRE(down.up() == 25);
+        REQUIRE(down.down() == 64);
+        EDFResampler same(200, 200);
+        REQUIRE(same.up() == 1);
+        REQUIRE(same.down() == 1);
+    }
+    
+    SECTION("decimation and interpolation follow the signal") {
+        vector<double> fast(10 * 256), slow(10 * 32);
+        for (size_t i = 0; i < fast.size(); i++)
+            fast[i] = sine(3, i / 256.0);
+        for (size_t i = 0; i < slow.size(); i++)
+            slow[i] = sine(3, i / 32.0);
+        
+        EDFResampler decimate(256, 100), interpolate(32, 100);
+        vector<double> a, b;
+        decimate.process(fast.data(), fast.size(), a);
+        decimate.flush(1000, a);
+        interpolate.process(slow.data(), slow.size(), b);
+        interpolate.flush(1000, b);
+        REQUIRE(a.size() == 1000);
+        REQUIRE(b.size() == 1000);
+        for (size_t m = 100; m < 900; m++) {
+            REQUIRE(std::fabs(a[m] - sine(3, m / 100.0)) < 5e-3);
+            REQUIRE(std::fabs(b[m] - sine(3, m / 100.0)) < 5e-3);
+        }
+    }
+    
+    SECTION("streaming blocks, offsets and edges") {
+        vector<double> x(4000);
+        for (size_t i = 0; i < x.size(); i++)
+            x[i] = sine(7, i / 500.0) + 2;
+        
+        EDFResampler whole(500, 128, 0.25), blocks(500, 128, 0.25);
+        vector<double> a, b;
+        whole.process(x.data(), x.size(), a);
+        whole.flush(1024, a);
+        for (size_t i = 0; i < x.size(); i += 37)
+            blocks.process(x.data() + i, std::min<size_t>(37, x.size() - i), b);
+        blocks.flush(1024, b);
+        REQUIRE(a == b);
+        REQUIRE(std::fabs(a[300] - (sine(7, (300 / 128.0) + 0.25 / 500) + 2)) < 2e-3);
+        
+        vector<double> flat(1000, 5.0), out;
+        EDFResampler hold(250, 60);
+        hold.process(flat.data(), flat.size(), out);
+        hold.flush(240, out);
+        REQUIRE(Approx(out.front()).epsilon(1e-3) == 5.0);
+        REQUIRE(Approx(out.back()).epsilon(1e-3) == 5.0);
+        
+        EDFResampler same(64, 64);
+        out.clear();
+        same.process(x.data(), 100, out);
+        same.flush(100, out);
+        REQUIRE(vector<double>(x.begin(), x.begin() + 100) == out);
+    }
+}
+
+TEST_CASE("Montage - derivations") {
+    EDFMontage montage;
+    montage.addBipolar("Fp1", "F3");
+    montage.addBipolarChain({"F3", "C3", "P3"});
+    montage.addAverageReference("Cz", {"Cz", "C3", "C4", "Pz"});
+    montage.add("sum", {EDFMontageTerm{"C3", 0.5}, EDFMontageTerm{" c3 ", 0.5}, EDFMontageTerm{"C4", 2}});
+    
+    REQUIRE(montage.size() == 5);
+    REQUIRE(montage.name(0) == "Fp1-F3");
+    REQUIRE(montage.name(2) == "C3-P3");
+    REQUIRE(montage.name(3) == "Cz-avg");
+    REQUIRE(montage.terms(0)[1].label == "F3");
+    REQUIRE(montage.terms(0)[1].weight == -1);
+    
+    // repeated labels fold into one term
+    REQUIRE(montage.terms(3).size() == 4);
+    REQUIRE(montage.terms(3)[0].weight == 0.75);
+    REQUIRE(montage.terms(3)[3].weight == -0.25);
+    REQUIRE(montage.terms(4).size() == 2);
+    REQUIRE(montage.terms(4)[0].weight == 1);
+    
+    EDFGenerator generator;
+    generator.setFiletype(FileType::EDFPLUS);
+    generator.addChannel("EEG Fp1", 100);
+    generator.addChannel("Cz", 100);
+    EDFHeader header = generator.header();
+    REQUIRE(EDFMontage::findSignal(&header, "cz") == 1);
+    REQUIRE(EDFMontage::findSignal(&header, "eeg fp1 ") == 0);
+    REQUIRE(EDFMontage::findSignal(&header, "Fp1") == -1);
+    REQUIRE(EDFMontage::findSignal(&header, "EDF Annotations") == -1);
+}
+
+TEST_CASE("Arena - marks and growth") {
+    EDFArena arena(256);
+    REQUIRE(arena.capacity() == 0);
+    
+    char* a = arena.allocate<char>(3);
+    double* b = arena.allocate<double>(4);
+    REQUIRE(reinterpret_cast<uintptr_t>(b) % alignof(double) == 0);
+    REQUIRE(reinterpret_cast<char*>(b) >= a + 3);
+    REQUIRE(arena.heapAllocations() == 1);
+    
+    // memory after a mark is handed out again
+    size_t mark = arena.mark();
+    int16_t* c = arena.allocate<int16_t>(8);
+    arena.rewind(mark);
+    REQUIRE(arena.allocate<int16_t>(8) == c);
+    REQUIRE(arena.used() >= 3 + 4 * sizeof(double) + 8 * sizeof(int16_t));
+    
+    // growing adds blocks, a reset merges them into one
+    arena.allocate<char>(1000);
+    arena.allocate<char>(5000);
+    REQUIRE(arena.heapAllocations() == 3);
+    size_t capacity = arena.capacity();
+    arena.reset();
+    REQUIRE(arena.heapAllocations() == 4);
+    REQUIRE(arena.capacity() == capacity);
+    REQUIRE(arena.used() == 0);
+    for (int round = 0; round < 3; round++) {
+        EDFArenaScope scope(&arena);
+        arena.allocate<char>(3);
+        arena.allocate<double>(4);
+        arena.allocate<char>(1000);
+        arena.allocate<char>(5000);
+    }
+    REQUIRE(arena.heapAllocations() == 4);
+    REQUIRE(arena.used() == 0);
 }
 
 /***** SIGNAL DATA *****/
@@ -740,8 +1337,1322 @@ TEST_CASE("File - Constructor") {
     }
 }
 
+TEST_CASE("File - Sample Types") {
+    EDFFile newFile(sampleFilePath.c_str());
+    EDFHeader* header = newFile.header();
+    EDFSignalData *legacy = newFile.extractSignalData(6, 600, 0.5);
+    EDFSignalSamples<int16_t> *raw = newFile.extractSamples<int16_t>(6, 600, 0.5);
+    EDFSignalSamples<float> *phys = newFile.extractSamples<float>(6, 600, 0.5);
+    
+    SECTION("same window as extractSignalData") {
+        REQUIRE(raw != nullptr);
+        REQUIRE(phys != nullptr);
+        REQUIRE(raw->size() == legacy->size());
+        REQUIRE(phys->size() == legacy->size());
+        REQUIRE(Approx(raw->frequency()) == legacy->frequency());
+    }
+    
+    SECTION("physical conversion follows the header") {
+        double gain = (header->physicalMax(6) - header->physicalMin(6)) / (header->digitalMax(6) - header->digitalMin(6));
+        for (size_t i = 0; i < raw->size(); i++) {
+            double expected = header->physicalMin(6) + (raw->data()[i] - header->digitalMin(6)) * gain;
+            REQUIRE(Approx(raw->physical(i)) == expected);
+            REQUIRE(Approx(phys->data()[i]).epsilon(1e-4) == expected);
+        }
+    }
+    
+    SECTION("annotation channel is refused") {
+        REQUIRE(newFile.extractSamples<float>(header->annotationIndex(), 0, 1) == nullptr);
+    }
+    
+    delete legacy;
+    delete raw;
+    delete phys;
+}
+
+TEST_CASE("File - Signal Data Matches Samples") {
+    string path = "edf_signal_data_test.edf";
+    EDFGenerator generator(21);
+    generator.setRecordCount(6);
+    generator.addChannel("EEG", 256, 10, 2000, 500);
+    TempFile tempFile(path, generator);
+    REQUIRE(tempFile.written());
+    EDFFile file(path.c_str());
+    
+    // both paths decode the same digital values, whole records and partial ones alike
+    double windows[][2] = {{0, 6}, {1.3, 2.4}};
+    for (auto& window : windows) {
+        EDFSignalData* data = file.extractSignalData(0, window[0], window[1]);
+        EDFSignalSamples<double>* samples = file.extractSamples<double>(0, window[0], window[1]);
+        REQUIRE(data->size() == samples->size());
+        vector<double> digital;
+        for (double value : samples->data())
+            digital.push_back(std::round((value - samples->offset()) / samples->gain()));
+        REQUIRE(data->data() == digital);
+        delete data;
+        delete samples;
+    }
+}
+
+TEST_CASE("File - Read Ahead") {
+    EDFFile newFile(sampleFilePath.c_str());
+    EDFSignalData *direct = newFile.extractSignalData(6, 600, 30.5);
+    
+    newFile.setReadAhead(3, 64 * 1024);
+    EDFSignalData *prefetched = newFile.extractSignalData(6, 600, 30.5);
+    EDFSignalData *tail = newFile.extractSignalData(6, 1800, 60);
+    
+    SECTION("same data as blocking reads") {
+        REQUIRE(prefetched != nullptr);
+        REQUIRE(direct->size() == prefetched->size());
+        REQUIRE(direct->data() == prefetched->data());
+        REQUIRE(tail != nullptr);
+        REQUIRE(Approx(tail->time()) == 18.1);
+    }
+    
+    delete direct;
+    delete prefetched;
+    delete tail;
+}
+
+TEST_CASE("File - Read Span") {
+    EDFFile newFile(sampleFilePath.c_str());
+    EDFSignalData *slab = newFile.extractSignalData(6, 600, 30.5);
+    
+    newFile.setReadSpan(1); // one record per read
+    EDFSignalData *single = newFile.extractSignalData(6, 600, 30.5);
+    
+    SECTION("same data regardless of read size") {
+        REQUIRE(slab->size() == single->size());
+        REQUIRE(slab->data() == single->data());
+    }
+    
+    delete slab;
+    delete single;
+}
+
+TEST_CASE("File - Batched Windows") {
+    EDFFile newFile(sampleFilePath.c_str());
+    
+    vector<EDFWindow> windows;
+    windows.push_back(EDFWindow{600, 0.5});
+    windows.push_back(EDFWindow{1127 - 2, 4});
+    windows.push_back(EDFWindow{600.25, 1}); // overlaps the first window
+    windows.push_back(EDFWindow{-1, 1});
+    vector<EDFSignalData*> batch = newFile.extractSignalWindows(6, windows);
+    
+    SECTION("same data as single extractions") {
+        REQUIRE(batch.size() == windows.size());
+        for (size_t w = 0; w < 3; w++) {
+            EDFSignalData *single = newFile.extractSignalData(6, windows[w].start, windows[w].length);
+            REQUIRE(batch[w] != nullptr);
+            REQUIRE(batch[w]->data() == single->data());
+            delete single;
+        }
+        REQUIRE(batch[3] == nullptr);
+    }
+    
+    SECTION("annotation channel is refused") {
+        vector<EDFSignalData*> none = newFile.extractSignalWindows(newFile.header()->annotationIndex(), windows);
+        REQUIRE(none.size() == windows.size());
+        REQUIRE(none[0] == nullptr);
+    }
+    
+    for (auto data : batch)
+        delete data;
+}
+
+TEST_CASE("File - Windows off record boundaries") {
+    string path = "edf_window_test.edf";
+    EDFGenerator generator(13);
+    generator.setRecordCount(10);
+    generator.addChannel("A", 100);
+    TempFile tempFile(path, generator);
+    REQUIRE(tempFile.written());
+    EDFFile file(path.c_str());
+    EDFSignalSamples<int16_t>* whole = file.extractSamples<int16_t>(0, 0, 10);
+    REQUIRE(whole->size() == 1000);
+    
+    // windows once cut short by the record count taken from the length alone, or run on to the end of a record
+    double windows[][2] = {{0.5, 1.0}, {1.9, 0.2}, {3.5, 0.2}, {2.25, 3.5}};
+    for (auto& window : windows) {
+        size_t first = static_cast<size_t>(floor(window[0] * 100));
+        size_t last = static_cast<size_t>(floor((window[0] + window[1]) * 100));
+        EDFSignalData* data = file.extractSignalData(0, window[0], window[1]);
+        REQUIRE(data->size() == last - first);
+        delete data;
+        
+        EDFSignalSamples<int16_t>* samples = file.extractSamples<int16_t>(0, window[0], window[1]);
+        REQUIRE(samples->data() == vector<int16_t>(whole->data().begin() + first, whole->data().begin() + last));
+        delete samples;
+    }
+    delete whole;
+}
+
+/* Fails or shortens chosen submissions to the ring */
+class FlakyBatchReader : public EDFBatchReader {
+public:
+    FlakyBatchReader(const string& path, int failAt, int error, unsigned maxSubmit)
+        : EDFBatchReader(path, 2, 2), calls(0), failAt(failAt), error(error), maxSubmit(maxSubmit) {}
+    int calls;
+    
+protected:
+    int enter(unsigned toSubmit, unsigned minComplete) {
+        if (calls++ == failAt) {
+            errno = error;
+            return -1;
+        }
+        return EDFBatchReader::enter(std::min(toSubmit, maxSubmit), minComplete);
+    }
+    
+private:
+    int failAt;
+    int error;
+    unsigned maxSubmit;
+};
+
+TEST_CASE("Batch Reader - Failed Submissions") {
+    string path = "edf_batch_test.edf";
+    EDFGenerator generator(12);
+    generator.setRecordCount(8);
+    generator.addChannels(2, 64);
+    TempFile tempFile(path, generator);
+    REQUIRE(tempFile.written());
+    std::ifstream in(path.c_str(), std::ios::binary);
+    string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    
+    size_t length = contents.size() / 8;
+    vector<vector<char> > buffers(8, vector<char>(length));
+    vector<EDFReadRequest> requests(8);
+    range_loop(i, 0, 8, 1)
+        requests[i] = EDFReadRequest{static_cast<long long>(i * length), length, buffers[i].data()};
+    auto readAll = [&](EDFBatchReader& reader) {
+        size_t good = 0;
+        bool ok = reader.read(requests, [&](size_t idx, bool filled) {
+            if (filled && contents.compare(idx * length, length, buffers[idx].data(), length) == 0)
+                good++;
+        });
+        return ok && good == requests.size();
+    };
+    
+    SECTION("interrupted and partial submissions are retried") {
+        FlakyBatchReader reader(path, 0, EINTR, 1);
+        REQUIRE(readAll(reader));
+    }
+    
+    SECTION("a failed submission waits for reads in flight and leaves the ring usable") {
+        FlakyBatchReader reader(path, 1, EINVAL, 2);
+        if (reader.usingIoUring()) {
+            REQUIRE(!readAll(reader));
+            REQUIRE(readAll(reader));
+        } else {
+            REQUIRE(readAll(reader));
+        }
+    }
+}
+
+class RecordingTracer : public EDFTracer {
+public:
+    vector<string> events;
+    void begin(const char* name) { events.push_back(string("+") + name); }
+    void end(const char* name) { events.push_back(string("-") + name); }
+};
+
+TEST_CASE("File - Instrumentation") {
+    string path = "edf_instrument_test.edf";
+    EDFGenerator generator(11);
+    generator.setFiletype(FileType::EDFPLUS);
+    generator.setRecordCount(40);
+    generator.addChannels(3, 64);
+    generator.setAnnotations(1);
+    TempFile tempFile(path, generator);
+    REQUIRE(tempFile.written());
+    
+    RecordingTracer tracer;
+    EDFFile file(path.c_str(), &tracer);
+    int recordSize = file.header()->dataRecordSize();
+    file.setReadSpan(10 * recordSize);
+    EDFStats opened = file.stats();
+    
+    file.resetStats();
+    delete file.extractSignalData(1, 0, 40);
+    EDFStats extracted = file.stats();
+    
+#ifdef EDFLIB_INSTRUMENTATION
+    SECTION("annotation parsing is counted while opening") {
+        REQUIRE(opened.recordsRead == 40);
+        REQUIRE(opened.bytesRead == 40ULL * recordSize);
+        REQUIRE(opened.readCalls >= 1);
+        REQUIRE(opened.annotationSeconds > 0);
+        REQUIRE(tracer.events.size() >= 4);
+        REQUIRE(tracer.events[0] == "+open");
+        REQUIRE(tracer.events[1] == "+annotations");
+        REQUIRE(tracer.events[2] == "-annotations");
+        REQUIRE(tracer.events[3] == "-open");
+    }
+    
+    SECTION("extraction counts slab reads") {
+        REQUIRE(extracted.recordsRead == 40);
+        REQUIRE(extracted.bytesRead == 40ULL * recordSize);
+        REQUIRE(extracted.readCalls == 4);
+        REQUIRE(extracted.allocations == 2); // result and slab
+        REQUIRE(extracted.decodeSeconds > 0);
+        REQUIRE(extracted.annotationSeconds == 0);
+        REQUIRE(tracer.events.back() == "-extract");
+    }
+    
+    SECTION("windows sharing a read are cache hits") {
+        vector<EDFWindow> windows;
+        windows.push_back(EDFWindow{1, 2});
+        windows.push_back(EDFWindow{2, 2});
+        windows.push_back(EDFWindow{20, 1});
+        file.resetStats();
+        for (auto data : file.extractSignalWindows(0, windows))
+            delete data;
+        REQUIRE(file.stats().readCalls == 2);
+        REQUIRE(file.stats().cacheHits == 1);
+    }
+#else
+    SECTION("nothing is counted or traced when compiled out") {
+        REQUIRE(opened.bytesRead == 0);
+        REQUIRE(extracted.recordsRead == 0);
+        REQUIRE(extracted.decodeSeconds == 0);
+        REQUIRE(tracer.events.empty());
+    }
+#endif
+}
+
+TEST_CASE("File - Epoch Statistics") {
+    string path = "edf_epoch_test.edf";
+    EDFGenerator generator(5);
+    generator.setFiletype(FileType::EDFPLUS);
+    generator.setRecordCount(30);
+    generator.setRecordDuration(0.5);
+    generator.addChannel("EEG Fz", 100);
+    generator.addChannel("ECG", 25, 1.5, 800, 50);
+    generator.setAnnotations(1);
+    TempFile tempFile(path, generator);
+    REQUIRE(tempFile.written());
+    
+    EDFFile file(path.c_str());
+    file.setReadSpan(4 * file.header()->dataRecordSize());
+    
+    SECTION("epochs agree with extracting each window") {
+        EDFEpochTable* table = file.epochStatistics(2, 0.5);
+        REQUIRE(table != nullptr);
+        REQUIRE(table->channelCount() == 2);
+        REQUIRE(table->epochCount() == 9); // 15 s of data, a 2 s epoch every 1.5 s
+        REQUIRE(table->channel(1) == 1);
+        REQUIRE(Approx(table->epochStart(3)) == 4.5);
+        
+        for (int r = 0; r < table->channelCount(); r++) {
+            for (int e = 0; e < table->epochCount(); e++) {
+                EDFSignalSamples<double>* window = file.extractSamples<double>(r, table->epochStart(e), 2);
+                const vector<double>& x = window->data();
+                double lineLength = 0, squares = 0;
+                for (size_t i = 0; i < x.size(); i++) {
+                    squares += x[i] * x[i];
+                    if (i > 0)
+                        lineLength += std::fabs(x[i] - x[i - 1]);
+                }
+                const EDFEpochStats& stats = table->at(r, e);
+                REQUIRE(stats.count == x.size());
+                REQUIRE(Approx(stats.mean).margin(1e-9) == window->moments().mean());
+                REQUIRE(Approx(stats.variance) == window->moments().variance());
+                REQUIRE(Approx(stats.rms) == sqrt(squares / x.size()));
+                REQUIRE(Approx(stats.min) == window->min());
+                REQUIRE(Approx(stats.max) == window->max());
+                REQUIRE(Approx(stats.lineLength) == lineLength);
+                delete window;
+            }
+        }
+        REQUIRE(table->row(1) == &table->at(1, 0));
+        delete table;
+    }
+    
+    SECTION("channel subsets and invalid layouts") {
+        vector<int> ecg(1, 1);
+        EDFEpochTable* table = file.epochStatistics(5, 0, ecg);
+        REQUIRE(table->channelCount() == 1);
+        REQUIRE(table->epochCount() == 3);
+        REQUIRE(table->at(0, 2).count == 250);
+        delete table;
+        
+        EDFDiagnostics::setRateLimit(0);
+        EDFDiagnostics::resetCounters();
+        REQUIRE(file.epochStatistics(2, 2) == nullptr);
+        REQUIRE(file.epochStatistics(2, 0, vector<int>(1, file.header()->annotationIndex())) == nullptr);
+        REQUIRE(EDFDiagnostics::count(EDFSeverity::ERROR) == 2);
+        EDFDiagnostics::setRateLimit(10);
+    }
+}
+
+TEST_CASE("File - Sketches") {
+    string path = "edf_sketch_test.edf";
+    EDFGenerator generator(9);
+    generator.setRecordCount(20);
+    generator.addChannels(2, 200);
+    TempFile tempFile(path, generator);
+    REQUIRE(tempFile.written());
+    
+    EDFFile file(path.c_str());
+    EDFHeader* header = file.header();
+    EDFSignalSamples<int16_t>* samples = file.extractSamples<int16_t>(1, 2.5, 10);
+    vector<double> sorted;
+    for (size_t i = 0; i < samples->size(); i++)
+        sorted.push_back(samples->physical(i));
+    std::sort(sorted.begin(), sorted.end());
+    
+    EDFHistogram histogram(4096, header->digitalMin(1), header->digitalMax(1), header->gain(1), header->offset(1));
+    EDFQuantileSketch quantiles;
+    REQUIRE(file.sketchSignal(1, 2.5, 10, &histogram, &quantiles));
+    REQUIRE(histogram.total() == samples->size());
+    REQUIRE(quantiles.count() == samples->size());
+    REQUIRE(quantiles.min() == sorted.front());
+    REQUIRE(quantiles.max() == sorted.back());
+    
+    double median = sorted[sorted.size() / 2];
+    double spread = sorted.back() - sorted.front();
+    REQUIRE(std::fabs(quantiles.quantile(0.5) - median) < 0.05 * spread);
+    REQUIRE(std::fabs(histogram.quantile(0.5) - median) < 0.05 * spread);
+    
+    // windows of the same channel collect into one sketch
+    REQUIRE(file.sketchSignal(1, 12, 5, nullptr, &quantiles));
+    REQUIRE(quantiles.count() == samples->size() + 1000);
+    REQUIRE_FALSE(file.sketchSignal(7, 0, 1, &histogram, nullptr));
+    
+    delete samples;
+}
+
+TEST_CASE("File - Spectrum") {
+    string path = "edf_spectrum_test.edf";
+    EDFGenerator generator(3);
+    generator.setRecordCount(30);
+    generator.addChannel("EEG", 256, 10, 100, 0);
+    TempFile tempFile(path, generator);
+    REQUIRE(tempFile.written());
+    
+    EDFFile file(path.c_str());
+    EDFWelch welch(256, 512, 256);
+    REQUIRE(file.spectrum(0, 0, 30, &welch));
+    REQUIRE(welch.segments() == 29);
+    
+    // a 100 uV sine carries 5000 uV^2, quantisation adds next to nothing
+    double alpha = welch.bandPower(EDFBand{8, 12});
+    REQUIRE(Approx(alpha).epsilon(0.01) == 5000);
+    REQUIRE(welch.bandPower(EDFBand{0.5, 4}) < 0.01 * alpha);
+    
+    // the same estimator serves the next epoch
+    welch.reset();
+    REQUIRE(file.spectrum(0, 10.5, 4, &welch));
+    REQUIRE(welch.segments() == 3);
+    REQUIRE_FALSE(file.spectrum(1, 0, 1, &welch));
+}
+
+TEST_CASE("File - Resampled Matrix") {
+    string path = "edf_resample_test.edf";
+    EDFGenerator generator(6);
+    generator.setRecordCount(12);
+    generator.addChannel("EEG", 256, 10, 100, 0);
+    generator.addChannel("Resp", 32, 0.5, 1000, 0);
+    TempFile tempFile(path, generator);
+    REQUIRE(tempFile.written());
+    
+    EDFFile file(path.c_str());
+    EDFMatrix* matrix = file.extractResampled(vector<int>(), 2.25, 5, 64);
+    REQUIRE(matrix != nullptr);
+    REQUIRE(matrix->channelCount() == 2);
+    REQUIRE(matrix->sampleCount() == 320);
+    REQUIRE(matrix->channel(1) == 1);
+    REQUIRE(matrix->rate() == 64);
+    REQUIRE(matrix->row(1) == matrix->row(0) + 320);
+    
+    // samples that coincide with an original sample keep its value
+    EDFSignalSamples<double>* eeg = file.extractSamples<double>(0, 2.25, 5);
+    EDFSignalSamples<double>* resp = file.extractSamples<double>(1, 2.25, 5);
+    for (size_t m = 32; m < 288; m++) {
+        REQUIRE(std::fabs(matrix->at(0, m) - eeg->data()[4 * m]) < 1);
+        if (m % 2 == 0)
+            REQUIRE(std::fabs(matrix->at(1, m) - resp->data()[m / 2]) < 1);
+    }
+    delete eeg;
+    delete resp;
+    delete matrix;
+    
+    REQUIRE(file.extractResampled(vector<int>(1, 0), 0, 1, 0) == nullptr);
+    REQUIRE(file.extractResampled(vector<int>(1, 2), 0, 1, 64) == nullptr);
+}
+
+TEST_CASE("File - Resampled Slow Signals") {
+    string path = "edf_resample_slow_test.edf";
+    EDFGenerator generator(6);
+    generator.setRecordDuration(30);
+    generator.setRecordCount(20);
+    generator.addChannel("Temp", 1, 0.002, 100, 0);
+    TempFile tempFile(path, generator);
+    REQUIRE(tempFile.written());
+    
+    // 1 sample per 30 s record to 1 sample every 3 s is exactly 10 / 1
+    EDFFile file(path.c_str());
+    EDFMatrix* matrix = file.extractResampled(vector<int>(), 0, 600, 1.0 / 3);
+    REQUIRE(matrix != nullptr);
+    REQUIRE(matrix->sampleCount() == 200);
+    
+    EDFSignalSamples<double>* temp = file.extractSamples<double>(0, 0, 600);
+    REQUIRE(temp->size() == 20);
+    for (size_t k = 2; k < 18; k++)
+        REQUIRE(std::fabs(matrix->at(0, 10 * k) - temp->data()[k]) < 1);
+    delete temp;
+    delete matrix;
+}
+
+TEST_CASE("File - Filters") {
+    string path = "edf_filter_test.edf";
+    EDFGenerator generator(4);
+    generator.setRecordCount(12);
+    generator.addChannel("EEG", 128, 10, 100, 20);
+    TempFile tempFile(path, generator);
+    REQUIRE(tempFile.written());
+    
+    EDFFile file(path.c_str());
+    EDFSignalSamples<double>* raw = file.extractSamples<double>(0, 0, 12);
+    EDFFilterChain chain(128);
+    chain.addHighPass(1).addLowPass(30, 4);
+    file.setFilter(0, &chain);
+    
+    SECTION("records filter as one signal") {
+        vector<double> expected(raw->data());
+        EDFFilterChain reference(128);
+        reference.addHighPass(1).addLowPass(30, 4);
+        reference.process(expected.data(), expected.size());
+        
+        // state carries across the two extractions
+        EDFSignalSamples<double>* first = file.extractSamples<double>(0, 0, 5.5);
+        EDFSignalSamples<double>* second = file.extractSamples<double>(0, 5.5, 6.5);
+        vector<double> joined(first->data());
+        joined.insert(joined.end(), second->data().begin(), second->data().end());
+        REQUIRE(joined.size() == expected.size());
+        for (size_t i = 0; i < joined.size(); i++)
+            REQUIRE(Approx(joined[i]).margin(1e-9) == expected[i]);
+        double mean = 0;
+        for (double v : second->data())
+            mean += v;
+        REQUIRE(Approx(second->moments().mean()).margin(1e-9) == mean / second->size());
+        delete first;
+        delete second;
+        
+        // digital storage rounds the filtered values
+        chain.reset();
+        EDFSignalSamples<int16_t>* digital = file.extractSamples<int16_t>(0, 0, 12);
+        for (size_t i = 0; i < digital->size(); i++)
+            REQUIRE(std::fabs(digital->physical(i) - expected[i]) <= digital->gain());
+        delete digital;
+    }
+    
+    SECTION("signal data filters the same physical values") {
+        EDFSignalData* data = file.extractSignalData(0, 0, 12);
+        chain.reset();
+        EDFSignalSamples<double>* samples = file.extractSamples<double>(0, 0, 12);
+        REQUIRE(data->size() == samples->size());
+        double gain = file.header()->gain(0), offset = file.header()->offset(0);
+        for (size_t i = 0; i < data->size(); i++)
+            REQUIRE(Approx(gain * data->data()[i] + offset).margin(1e-9) == samples->data()[i]);
+        delete data;
+        delete samples;
+    }
+    
+    SECTION("detaching stops filtering") {
+        file.setFilter(0, nullptr);
+        EDFSignalSamples<double>* again = file.extractSamples<double>(0, 0, 12);
+        REQUIRE(again->data() == raw->data());
+        delete again;
+    }
+    
+    delete raw;
+}
+
+TEST_CASE("File - Montage") {
+    string path = "edf_montage_test.edf";
+    EDFGenerator generator(12);
+    generator.setRecordCount(10);
+    generator.addChannel("Fp1", 64, 3, 100, 20);
+    generator.addChannel("F3", 64, 7, 80, 20);
+    generator.addChannel("Cz", 64, 11, 60, 20);
+    generator.addChannel("Resp", 16, 0.5, 500, 0);
+    TempFile tempFile(path, generator);
+    REQUIRE(tempFile.written());
+    
+    EDFFile file(path.c_str());
+    EDFMontage montage;
+    montage.addBipolar("Fp1", "F3").addAverageReference("Cz", {"Fp1", "F3", "Cz"});
+    EDFMatrix* matrix = file.extractMontage(montage, 2.5, 4);
+    REQUIRE(matrix != nullptr);
+    REQUIRE(matrix->channelCount() == 2);
+    REQUIRE(matrix->sampleCount() == 256);
+    REQUIRE(matrix->rate() == 64);
+    REQUIRE(matrix->start() == 2.5);
+    REQUIRE(matrix->channel(0) == -1);
+    REQUIRE(matrix->label(1) == "Cz-avg");
+    
+    // the same as subtracting the separately extracted channels
+    EDFSignalSamples<double>* fp1 = file.extractSamples<double>(0, 2.5, 4);
+    EDFSignalSamples<double>* f3 = file.extractSamples<double>(1, 2.5, 4);
+    EDFSignalSamples<double>* cz = file.extractSamples<double>(2, 2.5, 4);
+    REQUIRE(fp1->size() == 256);
+    for (size_t i = 0; i < 256; i++) {
+        REQUIRE(Approx(matrix->at(0, i)).margin(1e-9) == fp1->data()[i] - f3->data()[i]);
+        double avg = (fp1->data()[i] + f3->data()[i] + cz->data()[i]) / 3;
+        REQUIRE(Approx(matrix->at(1, i)).margin(1e-9) == cz->data()[i] - avg);
+    }
+    delete fp1;
+    delete f3;
+    delete cz;
+    delete matrix;
+    
+    EDFMontage missing, mixed;
+    missing.addBipolar("Fp1", "O1");
+    mixed.addBipolar("Fp1", "Resp");
+    REQUIRE(file.extractMontage(missing, 0, 1) == nullptr);
+    REQUIRE(file.extractMontage(mixed, 0, 1) == nullptr);
+    REQUIRE(file.extractMontage(EDFMontage(), 0, 1) == nullptr);
+}
+
+TEST_CASE("File - Matrix Output") {
+    string path = "edf_matrix_test.edf";
+    EDFGenerator generator(13);
+    generator.setRecordCount(8);
+    generator.setRecordDuration(0.5);
+    generator.addChannel("A", 50, 3, 100, 20);
+    generator.addChannel("B", 50, 7, 80, 20);
+    generator.addChannel("C", 50, 11, 60, 20);
+    generator.addChannel("Slow", 10, 0.5, 500, 0);
+    TempFile tempFile(path, generator);
+    REQUIRE(tempFile.written());
+    
+    EDFFile file(path.c_str());
+    vector<int> channels = {2, 0, 1};
+    size_t samples = file.sampleCount(0, 0.73, 2.1);
+    vector<EDFSignalSamples<double>*> expected;
+    for (int c : channels)
+        expected.push_back(file.extractSamples<double>(c, 0.73, 2.1));
+    REQUIRE(samples == expected[0]->size());
+    REQUIRE(file.sampleCount(0, 1, 100) == 300);
+    REQUIRE(file.sampleCount(3, 0, 4) == 80);
+    
+    SECTION("channel major, packed and strided") {
+        vector<double> packed(3 * samples, -1);
+        REQUIRE(file.extractMatrix(channels, 0.73, 2.1, packed.data()));
+        size_t stride = samples + 3;
+        vector<double> strided(3 * stride, -1);
+        REQUIRE(file.extractMatrix(channels, 0.73, 2.1, strided.data(), EDFLayout::CHANNEL_MAJOR, stride));
+        for (size_t r = 0; r < 3; r++) {
+            for (size_t i = 0; i < samples; i++) {
+                REQUIRE(packed[r * samples + i] == expected[r]->data()[i]);
+                REQUIRE(strided[r * stride + i] == expected[r]->data()[i]);
+            }
+            REQUIRE(strided[r * stride + samples] == -1);
+        }
+    }
+    
+    SECTION("time major floats") {
+        vector<float> tensor(samples * 4, -1);
+        REQUIRE(file.extractMatrix(channels, 0.73, 2.1, tensor.data(), EDFLayout::TIME_MAJOR, 4));
+        for (size_t i = 0; i < samples; i++) {
+            for (size_t r = 0; r < 3; r++)
+                REQUIRE(tensor[i * 4 + r] == static_cast<float>(expected[r]->data()[i]));
+            REQUIRE(tensor[i * 4 + 3] == -1);
+        }
+    }
+    
+    SECTION("invalid layouts") {
+        vector<double> buffer(4 * 200);
+        REQUIRE_FALSE(file.extractMatrix(channels, 0, 1, buffer.data(), EDFLayout::TIME_MAJOR, 2));
+        REQUIRE_FALSE(file.extractMatrix(channels, 0, 1, buffer.data(), EDFLayout::CHANNEL_MAJOR, 99));
+        REQUIRE_FALSE(file.extractMatrix(vector<int>(), 0, 1, buffer.data()));
+        REQUIRE_FALSE(file.extractMatrix(vector<int>(1, 4), 0, 1, buffer.data()));
+    }
+    
+    for (auto e : expected)
+        delete e;
+}
+
+TEST_CASE("File - Caller Buffers") {
+    string path = "edf_buffer_test.edf";
+    EDFGenerator generator(14);
+    generator.setRecordCount(20);
+    generator.addChannel("EEG", 200, 10, 100, 20);
+    generator.addChannel("EMG", 100, 40, 50, 20);
+    TempFile tempFile(path, generator);
+    REQUIRE(tempFile.written());
+    
+    EDFFile file(path.c_str());
+    EDFArena arena;
+    file.setArena(&arena);
+    file.setReadSpan(4096);
+    
+    EDFSignalSamples<double>* expected = file.extractSamples<double>(0, 3.3, 7.25);
+    vector<float> buffer(4000, -1);
+    REQUIRE(file.extractInto(0, 3.3, 7.25, buffer.data(), buffer.size()) == expected->size());
+    for (size_t i = 0; i < expected->size(); i++)
+        REQUIRE(buffer[i] == static_cast<float>(expected->data()[i]));
+    REQUIRE(buffer[expected->size()] == -1);
+    delete expected;
+    REQUIRE(arena.used() == 0);
+    
+    // once the arena fits, repeated extractions stay off the heap
+    unsigned long long heap = arena.heapAllocations();
+    vector<double> window(2000);
+    for (int i = 0; i < 10; i++) {
+        REQUIRE(file.extractInto(1, i, 5, window.data(), window.size()) == 500);
+        REQUIRE(file.extractInto(0, i, 5, window.data(), window.size()) == 1000);
+    }
+    REQUIRE(arena.heapAllocations() == heap);
+    
+    REQUIRE(file.extractInto(0, 0, 5, window.data(), 999) == 0);
+    REQUIRE(file.extractInto(2, 0, 5, window.data(), window.size()) == 0);
+    
+    // the file's own arena takes over again
+    file.setArena(nullptr);
+    REQUIRE(file.extractInto(1, 0, 2, window.data(), window.size()) == 200);
+}
+
+TEST_CASE("File - Owned Results") {
+    string path = "edf_owned_test.edf";
+    EDFGenerator generator(15);
+    generator.setFiletype(FileType::EDFPLUS);
+    generator.setRecordCount(6);
+    generator.setAnnotations(2);
+    generator.addChannel("EEG", 100);
+    TempFile tempFile(path, generator);
+    REQUIRE(tempFile.written());
+    
+    EDFFile file(path.c_str());
+    std::unique_ptr<EDFSignalData> data = file.signalData(0, 1, 3);
+    REQUIRE(data != nullptr);
+    REQUIRE(data->size() == 300);
+    std::unique_ptr<EDFSignalSamples<float> > samples = file.signalSamples<float>(0, 1, 3);
+    REQUIRE(samples->size() == 300);
+    REQUIRE(file.signalData(file.header()->annotationIndex(), 0, 1) == nullptr);
+    REQUIRE(file.signalSamples<double>(7, 0, 1) == nullptr);
+    
+    // results move along a pipeline without copying
+    const double* first = data->data().data();
+    vector<EDFSignalData> pipeline;
+    pipeline.push_back(std::move(*data));
+    REQUIRE(pipeline[0].data().data() == first);
+    pipeline.reserve(pipeline.capacity() + 1);
+    REQUIRE(pipeline[0].data().data() == first);
+    
+    size_t count = file.annotations()->size();
+    REQUIRE(count == 6);
+    vector<EDFAnnotation> taken = file.takeAnnotations();
+    REQUIRE(taken.size() == count);
+    REQUIRE(file.annotations()->empty());
+    EDFAnnotation moved(std::move(taken[0]));
+    REQUIRE(taken[0].strings().empty());
+    REQUIRE_FALSE(moved.strings().empty());
+    
+    // growing vectors move rather than copy their elements
+    static_assert(std::is_nothrow_move_constructible<EDFAnnotation>::value, "");
+    static_assert(std::is_nothrow_move_assignable<EDFAnnotation>::value, "");
+    static_assert(std::is_nothrow_move_constructible<EDFSignalData>::value, "");
+    static_assert(std::is_nothrow_move_assignable<EDFSignalData>::value, "");
+    static_assert(std::is_nothrow_move_constructible<EDFHeader>::value, "");
+    static_assert(std::is_nothrow_move_assignable<EDFHeader>::value, "");
+    static_assert(std::is_nothrow_move_constructible<EDFPatient>::value, "");
+    static_assert(std::is_nothrow_move_assignable<EDFPatient>::value, "");
+}
+
+TEST_CASE("File - Compressed Container") {
+    string path = "edf_container_test.edf";
+    string packed = "edf_container_test.edfz";
+    TempFile packedFile(packed);
+    EDFGenerator generator(21);
+    generator.setFiletype(FileType::EDFPLUS);
+    generator.setRecordCount(25);
+    generator.setAnnotations(2);
+    generator.addChannel("EEG", 256);
+    generator.addChannel("ECG", 128, 1.5);
+    TempFile tempFile(path, generator);
+    REQUIRE(tempFile.written());
+    REQUIRE(compressFile(path.c_str(), packed.c_str(), 4));
+    
+    std::ifstream plainSize(path.c_str(), std::ios::binary | std::ios::ate);
+    std::ifstream packedSize(packed.c_str(), std::ios::binary | std::ios::ate);
+    REQUIRE(packedSize.tellg() < plainSize.tellg());
+    
+    // the container opens like the file it was made from
+    EDFFile plain(path.c_str());
+    EDFFile file(packed.c_str());
+    REQUIRE(file.header() != nullptr);
+    REQUIRE(file.header()->dataRecordCount() == 25);
+    REQUIRE(file.header()->signalCount() == plain.header()->signalCount());
+    REQUIRE(file.header()->label(1) == plain.header()->label(1));
+    REQUIRE(file.annotations()->size() == plain.annotations()->size());
+    REQUIRE(file.annotations()->at(9).strings() == plain.annotations()->at(9).strings());
+    
+    range_loop(ch, 0, 2, 1) {
+        EDFSignalSamples<int16_t>* expected = plain.extractSamples<int16_t>(ch, 0, 25);
+        EDFSignalSamples<int16_t>* samples = file.extractSamples<int16_t>(ch, 0, 25);
+        REQUIRE(samples->size() == expected->size());
+        REQUIRE(samples->data() == expected->data());
+        delete expected;
+        delete samples;
+    }
+    
+    EDFSignalData* expected = plain.extractSignalData(1, 2.5, 3);
+    EDFSignalData* data = file.extractSignalData(1, 2.5, 3);
+    REQUIRE(data->data() == expected->data());
+    delete expected;
+    delete data;
+    
+    vector<EDFWindow> windows = {{20, 2}, {1, 0.5}};
+    vector<EDFSignalData*> batch = file.extractSignalWindows(0, windows);
+    vector<EDFSignalData*> plainBatch = plain.extractSignalWindows(0, windows);
+    range_loop(w, static_cast<size_t>(0), windows.size(), 1) {
+        REQUIRE(batch[w] != nullptr);
+        REQUIRE(batch[w]->data() == plainBatch[w]->data());
+        delete batch[w];
+        delete plainBatch[w];
+    }
+    
+    SECTION("only overlapping blocks are decompressed") {
+        EDFContainerReader reader(packed);
+        REQUIRE(reader.valid());
+        REQUIRE(reader.recordsPerBlock() == 4);
+        int recordSize = plain.header()->dataRecordSize();
+        vector<char> records(2 * recordSize);
+        int signal = 0;
+        REQUIRE(reader.read(5, 7, &signal, 1, records.data()));
+        REQUIRE(reader.blocksDecoded() == 1);
+        REQUIRE(reader.read(7, 9, &signal, 1, records.data()));
+        REQUIRE(reader.blocksDecoded() == 2);
+        
+        vector<char> raw(2 * recordSize);
+        std::ifstream in(path.c_str(), std::ios::binary);
+        in.seekg(plain.header()->signalCount() * 256 + 256 + 7 * recordSize);
+        in.read(raw.data(), raw.size());
+        REQUIRE(std::equal(records.begin(), records.begin() + 512, raw.begin()));
+        REQUIRE(!reader.read(24, 26, &signal, 1, records.data()));
+    }
+    
+}
+
+TEST_CASE("File - Columnar Export") {
+    string path = "edf_columns_test.edf";
+    string directory = "edf_columns_test";
+    TempFile directoryFile(directory); // removed last, once it is empty
+    TempFile metadataFile(directory + "/metadata.json");
+    TempFile onsetsFile(directory + "/record_onsets.f64");
+    TempFile float0(directory + "/" + columnFileName(0, EDFColumnType::FLOAT));
+    TempFile float1(directory + "/" + columnFileName(1, EDFColumnType::FLOAT));
+    TempFile digital0(directory + "/" + columnFileName(0, EDFColumnType::DIGITAL));
+    TempFile digital1(directory + "/" + columnFileName(1, EDFColumnType::DIGITAL));
+    EDFGenerator generator(8);
+    generator.setFiletype(FileType::EDFPLUS);
+    generator.setRecordCount(7);
+    generator.setAnnotations(1);
+    generator.addChannel("EEG", 200);
+    generator.addChannel("ECG \"lead\"", 50);
+    TempFile tempFile(path, generator);
+    REQUIRE(tempFile.written());
+    
+    EDFFile file(path.c_str());
+    int annotation = file.header()->annotationIndex();
+    
+    // every record goes past in order, undecoded
+    int visited = 0;
+    REQUIRE(file.visitRecords(2, 5, [&](const char*, int recordNum) { REQUIRE(recordNum == 2 + visited++); }));
+    REQUIRE(visited == 3);
+    REQUIRE(!file.visitRecords(5, 8, [](const char*, int) {}));
+    
+    auto column = [&](int signal, EDFColumnType type) {
+        std::ifstream in((directory + "/" + columnFileName(signal, type)).c_str(), std::ios::binary);
+        return string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    };
+    
+    SECTION("physical columns") {
+        REQUIRE(exportColumns(file, directory, EDFColumnType::FLOAT, 1000));
+        vector<float> expected(350);
+        REQUIRE(file.extractMatrix<float>({1}, 0, 7, expected.data()));
+        string bytes = column(1, EDFColumnType::FLOAT);
+        REQUIRE(bytes.size() == 350 * sizeof(float));
+        vector<float> values(350);
+        memcpy(values.data(), bytes.data(), bytes.size());
+        REQUIRE(values == expected);
+        REQUIRE(column(annotation, EDFColumnType::FLOAT).empty());
+        
+        std::ifstream in((directory + "/metadata.json").c_str());
+        string json((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        REQUIRE(json.find("\"label\": \"ECG \\\"lead\\\"\"") != string::npos);
+        REQUIRE(json.find("\"file\": \"channel_0.f32\"") != string::npos);
+        REQUIRE(json.find("\"samples\": 1400") != string::npos);
+        REQUIRE(json.find("\"recordCount\": 7") != string::npos);
+        REQUIRE(json.find("\"texts\": [") != string::npos);
+    }
+    
+    SECTION("digital columns") {
+        REQUIRE(exportColumns(file, directory, EDFColumnType::DIGITAL));
+        EDFSignalSamples<int16_t>* expected = file.extractSamples<int16_t>(0, 0, 7);
+        string bytes = column(0, EDFColumnType::DIGITAL);
+        REQUIRE(bytes.size() == 1400 * sizeof(int16_t));
+        vector<int16_t> values(1400);
+        memcpy(values.data(), bytes.data(), bytes.size());
+        REQUIRE(values == expected->data());
+        delete expected;
+    }
+    
+    SECTION("record onsets place discontinuous records in time") {
+        string gappy = "edf_columns_gaps_test.edf";
+        EDFGenerator gaps(9);
+        gaps.setFiletype(FileType::EDFPLUS, Continuity::DISCONTINUOUS);
+        gaps.setRecordCount(12);
+        gaps.setGaps(0.5, 4);
+        gaps.addChannel("EEG", 10);
+        TempFile gappyFile(gappy, gaps);
+        REQUIRE(gappyFile.written());
+        EDFFile discontinuous(gappy.c_str());
+        REQUIRE(exportColumns(discontinuous, directory, EDFColumnType::DIGITAL));
+        
+        // each record's time-keeping annotation, read straight from the file
+        const EDFHeader* header = discontinuous.header();
+        std::ifstream in(gappy.c_str(), std::ios::binary);
+        vector<double> expected;
+        range_loop(r, 0, 12, 1) {
+            vector<char> tal(2 * header->signalSampleCount(header->annotationIndex()));
+            in.seekg(256 * 3 + r * header->dataRecordSize() + header->bufferOffset(header->annotationIndex()));
+            in.read(tal.data(), tal.size());
+            expected.push_back(atof(tal.data()));
+        }
+        REQUIRE(expected.back() > 11 * header->dataRecordDuration());
+        
+        std::ifstream onsetFile((directory + "/record_onsets.f64").c_str(), std::ios::binary);
+        string bytes((std::istreambuf_iterator<char>(onsetFile)), std::istreambuf_iterator<char>());
+        REQUIRE(bytes.size() == 12 * sizeof(double));
+        vector<double> onsets(12);
+        memcpy(onsets.data(), bytes.data(), bytes.size());
+        REQUIRE(onsets == expected);
+        
+        std::ifstream meta((directory + "/metadata.json").c_str());
+        string json((std::istreambuf_iterator<char>(meta)), std::istreambuf_iterator<char>());
+        REQUIRE(json.find("\"continuous\": false") != string::npos);
+        REQUIRE(json.find("\"recordOnsets\": {\"file\": \"record_onsets.f64\"") != string::npos);
+    }
+}
+
+TEST_CASE("File - Rewrite") {
+    string path = "edf_rewrite_test.edf";
+    string target = "edf_rewrite_test_out.edf";
+    TempFile targetFile(target);
+    EDFGenerator generator(4);
+    generator.setFiletype(FileType::EDFPLUS);
+    generator.setRecordCount(10);
+    generator.setAnnotations(1);
+    generator.addChannel("A", 100);
+    generator.addChannel("B", 50);
+    generator.addChannel("C", 100, 3);
+    TempFile tempFile(path, generator);
+    REQUIRE(tempFile.written());
+    EDFFile file(path.c_str());
+    
+    SECTION("crop and reorder channels") {
+        REQUIRE(rewriteFile(file, target, 3, 4, {2, 0}));
+        EDFFile cut(target.c_str());
+        REQUIRE(cut.header() != nullptr);
+        REQUIRE(cut.header()->dataRecordCount() == 4);
+        REQUIRE(cut.header()->signalCount() == 3);
+        REQUIRE(cut.header()->label(0) == "C");
+        REQUIRE(cut.header()->label(1) == "A");
+        REQUIRE(cut.header()->annotationIndex() == 2);
+        REQUIRE(cut.header()->startTime().asSeconds() == file.header()->startTime().asSeconds() + 3);
+        
+        EDFSignalSamples<int16_t>* expected = file.extractSamples<int16_t>(2, 3, 4);
+        EDFSignalSamples<int16_t>* samples = cut.extractSamples<int16_t>(0, 0, 4);
+        REQUIRE(samples->data() == expected->data());
+        delete expected;
+        delete samples;
+        
+        // annotations move with the start
+        REQUIRE(cut.annotations()->size() == 4);
+        REQUIRE(cut.annotations()->at(0).onset() == Approx(file.annotations()->at(3).onset() - 3));
+        REQUIRE(cut.annotations()->at(0).strings() == file.annotations()->at(3).strings());
+    }
+    
+    SECTION("records are copied byte for byte") {
+        REQUIRE(rewriteFile(file, target, 6.5));
+        EDFFile cut(target.c_str());
+        REQUIRE(cut.header()->dataRecordCount() == 4);
+        REQUIRE(cut.header()->signalCount() == 4);
+        
+        std::ifstream original(path.c_str(), std::ios::binary);
+        std::ifstream copy(target.c_str(), std::ios::binary);
+        string before((std::istreambuf_iterator<char>(original)), std::istreambuf_iterator<char>());
+        string after((std::istreambuf_iterator<char>(copy)), std::istreambuf_iterator<char>());
+        int recordSize = file.header()->dataRecordSize();
+        size_t talOffset = file.header()->bufferOffset(3);
+        REQUIRE(after.size() == 256 * 5 + 4 * static_cast<size_t>(recordSize));
+        REQUIRE(after.compare(256 * 5, talOffset, before, 256 * 5 + 6 * recordSize, talOffset) == 0);
+    }
+    
+    SECTION("bad selections") {
+        REQUIRE(!rewriteFile(file, target, 0, 1, {file.header()->annotationIndex()}));
+        REQUIRE(!rewriteFile(file, target, 0, 1, {5}));
+        REQUIRE(!rewriteFile(file, target, 10));
+    }
+    
+}
+
+TEST_CASE("File - Merge") {
+    string first = "edf_merge_test_1.edf";
+    string second = "edf_merge_test_2.edf";
+    string target = "edf_merge_test_out.edf";
+    TempFile targetFile(target);
+    EDFGenerator plus(5);
+    plus.setFiletype(FileType::EDFPLUS);
+    plus.setRecordCount(6);
+    plus.addChannel("A", 100);
+    plus.addChannel("B", 50);
+    plus.setAnnotations(1);
+    TempFile firstFile(first, plus);
+    REQUIRE(firstFile.written());
+    EDFFile plusFile(first.c_str());
+    EDFGenerator plain(6);
+    plain.setRecordCount(4);
+    plain.addChannel("A", 100);
+    plain.addChannel("B", 50);
+    TempFile secondFile(second, plain);
+    REQUIRE(secondFile.written());
+    
+    // the plain file starts 20 seconds into the day
+    {
+        std::fstream edit(second.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+        edit.seekp(176);
+        edit.write("00.00.20", 8);
+    }
+    
+    SECTION("gaps are kept in the onsets") {
+        REQUIRE(mergeFiles({second, first}, target));
+        EDFFile merged(target.c_str());
+        REQUIRE(merged.header() != nullptr);
+        REQUIRE(merged.header()->filetype() == FileType::EDFPLUS);
+        REQUIRE(merged.header()->continuity() == Continuity::DISCONTINUOUS);
+        REQUIRE(merged.header()->dataRecordCount() == 10);
+        REQUIRE(merged.header()->signalCount() == 3);
+        REQUIRE(merged.header()->annotationIndex() == 2);
+        REQUIRE(merged.header()->startTime().asSeconds() == 0);
+        
+        const vector<EDFAnnotation>* annotations = merged.annotations();
+        REQUIRE(annotations != nullptr);
+        REQUIRE(annotations->size() == 6);
+        REQUIRE(annotations->at(5).strings() == plusFile.annotations()->at(5).strings());
+        
+        // the plain file's records gain time-keeping lists after the gap
+        std::ifstream raw(target.c_str(), std::ios::binary);
+        int recordSize = merged.header()->dataRecordSize();
+        raw.seekg(256 * 4 + 6 * recordSize + merged.header()->bufferOffset(2));
+        char tal[8] = {0};
+        raw.read(tal, 6);
+        REQUIRE(string(tal, 6) == string("+20\x14\x14\0", 6));
+        
+        EDFFile source(second.c_str());
+        EDFSignalSamples<int16_t>* expected = source.extractSamples<int16_t>(1, 0, 4);
+        EDFSignalSamples<int16_t>* samples = merged.extractSamples<int16_t>(1, 6, 4);
+        REQUIRE(samples->data() == expected->data());
+        delete expected;
+        delete samples;
+    }
+    
+    SECTION("incompatible or overlapping files") {
+        EDFGenerator other(7);
+        other.setRecordCount(4);
+        other.addChannel("A", 100);
+        other.addChannel("B", 25);
+        REQUIRE(other.write(target.c_str()));
+        REQUIRE(!mergeFiles({first, target}, target + ".out"));
+        REQUIRE(!mergeFiles({first, first}, target));
+    }
+    
+}
+
 /***** FILE *****/
 
+/***** GENERATOR *****/
+
+TEST_CASE("Generator - Deterministic Output") {
+    EDFGenerator generator(7);
+    generator.setFiletype(FileType::EDFPLUS, Continuity::DISCONTINUOUS);
+    generator.setRecordCount(12);
+    generator.addChannel("Fp1", 256);
+    generator.addChannel("Resp", 25, 0.3, 500, 0);
+    generator.setAnnotations(3);
+    generator.setGaps(0.5, 4);
+    generator.setWriteSpan(1); // one record per write
+    
+    std::ostringstream first, second;
+    REQUIRE(generator.write(first));
+    generator.setWriteSpan(4 << 20);
+    REQUIRE(generator.write(second));
+    
+    SECTION("same bytes for the same seed") {
+        REQUIRE(first.str() == second.str());
+        REQUIRE(static_cast<long long>(first.str().size()) == generator.fileSize());
+    }
+    
+    SECTION("different bytes for another seed") {
+        EDFGenerator other(8);
+        other.setFiletype(FileType::EDFPLUS, Continuity::DISCONTINUOUS);
+        other.setRecordCount(12);
+        other.addChannel("Fp1", 256);
+        other.addChannel("Resp", 25, 0.3, 500, 0);
+        other.setAnnotations(3);
+        other.setGaps(0.5, 4);
+        std::ostringstream third;
+        REQUIRE(other.write(third));
+        REQUIRE(third.str().size() == first.str().size());
+        REQUIRE(third.str() != first.str());
+    }
+}
+
+TEST_CASE("Generator - Readable Files") {
+    string path = "edf_generator_test.edf";
+    EDFGenerator generator(3);
+    generator.setFiletype(FileType::EDFPLUS, Continuity::DISCONTINUOUS);
+    generator.setRecordCount(30);
+    generator.setRecordDuration(0.5);
+    generator.addChannel("EEG Fp1", 128, 10, 100, 0);
+    generator.addChannel("EEG Fp2", 100);
+    generator.addChannel("ECG", 250, 1.2, 1000, 5);
+    generator.setAnnotations(2);
+    generator.setGaps(0.2, 3);
+    TempFile tempFile(path, generator);
+    REQUIRE(tempFile.written());
+    
+    EDFFile file(path.c_str());
+    EDFHeader* header = file.header();
+    REQUIRE(header != nullptr);
+    
+    SECTION("header") {
+        REQUIRE(header->filetype() == FileType::EDFPLUS);
+        REQUIRE(header->continuity() == Continuity::DISCONTINUOUS);
+        REQUIRE(header->signalCount() == 4);
+        REQUIRE(header->annotationIndex() == 3);
+        REQUIRE(header->dataRecordCount() == 30);
+        REQUIRE(header->dataRecordDuration() == Approx(0.5));
+        REQUIRE(header->dataRecordSize() == generator.header().dataRecordSize());
+        REQUIRE(header->label(2) == "ECG");
+        REQUIRE(header->signalSampleCount(1) == 100);
+        REQUIRE(header->physicalMax(0) == Approx(3200));
+        REQUIRE(header->digitalMin(0) == -32768);
+        REQUIRE(header->patient().code() == "synthetic");
+    }
+    
+    SECTION("signals") {
+        EDFSignalSamples<double>* fp1 = file.extractSamples<double>(0, 0, 15);
+        REQUIRE(fp1->size() == 30 * 128);
+        REQUIRE(fp1->max() == Approx(100).epsilon(0.01));
+        REQUIRE(fp1->min() == Approx(-100).epsilon(0.01));
+        delete fp1;
+        
+        EDFSignalSamples<int16_t>* ecg = file.extractSamples<int16_t>(2, 0, 15);
+        REQUIRE(ecg->size() == 30 * 250);
+        delete ecg;
+    }
+    
+    SECTION("annotations") {
+        vector<EDFAnnotation>* annotations = file.annotations();
+        REQUIRE(annotations != nullptr);
+        REQUIRE(annotations->size() == 30);
+        for (size_t r = 0; r < annotations->size(); r++) {
+            REQUIRE((*annotations)[r].strings().size() == 2);
+            REQUIRE((*annotations)[r].onset() >= r * 0.5);
+            if (r > 0)
+                REQUIRE((*annotations)[r].onset() >= (*annotations)[r - 1].onset() + 0.5 - 1e-9);
+        }
+        REQUIRE(annotations->back().onset() > 30 * 0.5); // some gaps were inserted
+    }
+}
+
+/***** GENERATOR *****/
+
+/***** WRITER *****/
+
+TEST_CASE("Writer - Append, Commit and Recover") {
+    string path = "edf_writer_test.edf";
+    TempFile tempFile(path);
+    EDFGenerator generator;
+    generator.setFiletype(FileType::EDFPLUS);
+    generator.setAnnotations(1);
+    generator.addChannel("EEG", 100);
+    generator.addChannel("ECG", 50);
+    
+    // record r holds r * 1000 + i in both channels
+    vector<int16_t> eeg(100), ecg(50);
+    const int16_t* signals[] = {eeg.data(), ecg.data()};
+    auto fill = [&](int r) {
+        for (int i = 0; i < 100; i++)
+            eeg[i] = static_cast<int16_t>(r * 1000 + i);
+        for (int i = 0; i < 50; i++)
+            ecg[i] = static_cast<int16_t>(r * 1000 + i);
+    };
+    
+    EDFWriter writer;
+    REQUIRE(writer.create(path.c_str(), generator.header()));
+    REQUIRE(writer.committedCount() == -1);
+    writer.setCommitInterval(3);
+    range_loop(r, 0, 4, 1) {
+        if (r == 1)
+            writer.addAnnotation(1.5, "Marker");
+        fill(r);
+        REQUIRE(writer.writeRecord(signals));
+    }
+    REQUIRE(writer.recordCount() == 4);
+    REQUIRE(writer.committedCount() == 3);
+    
+    SECTION("readers see committed records while writing") {
+        EDFFile live(path.c_str());
+        REQUIRE(live.header() != nullptr);
+        REQUIRE(live.header()->dataRecordCount() == 3);
+        EDFSignalSamples<int16_t>* samples = live.extractSamples<int16_t>(1, 0, 3);
+        REQUIRE(samples->size() == 150);
+        REQUIRE(samples->data()[120] == 2020);
+        delete samples;
+    }
+    
+    SECTION("closing commits the rest") {
+        REQUIRE(writer.close());
+        EDFFile done(path.c_str());
+        REQUIRE(done.header()->dataRecordCount() == 4);
+        REQUIRE(done.annotations()->size() == 1);
+        REQUIRE(done.annotations()->at(0).strings()[0] == "Marker");
+        
+        // appending continues the recording
+        EDFWriter more;
+        REQUIRE(more.open(path.c_str()));
+        REQUIRE(more.recordCount() == 4);
+        fill(4);
+        REQUIRE(more.writeRecord(signals));
+        REQUIRE(more.close());
+        EDFFile longer(path.c_str());
+        REQUIRE(longer.header()->dataRecordCount() == 5);
+        EDFSignalSamples<int16_t>* last = longer.extractSamples<int16_t>(0, 4, 1);
+        REQUIRE(last->data()[7] == 4007);
+        delete last;
+    }
+    
+    SECTION("a crashed recording is recovered") {
+        REQUIRE(writer.close());
+        
+        // header still says -1 and half a record was being written
+        std::fstream crash(path.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+        crash.seekp(236);
+        crash.write("-1      ", 8);
+        crash.seekp(0, std::ios::end);
+        string torn(100, 'x');
+        crash.write(torn.data(), torn.size());
+        crash.close();
+        
+        EDFFile running(path.c_str());
+        REQUIRE(running.header() != nullptr);
+        REQUIRE(running.header()->dataRecordCount() == 4);
+        
+        REQUIRE(EDFWriter::recover(path.c_str()) == 4);
+        EDFFile repaired(path.c_str());
+        REQUIRE(repaired.header()->dataRecordCount() == 4);
+        std::ifstream in(path.c_str(), std::ios::binary | std::ios::ate);
+        REQUIRE(static_cast<long long>(in.tellg()) == 256 * 4 + 4LL * repaired.header()->dataRecordSize());
+    }
+    
+    SECTION("records after the last commit are dropped") {
+        REQUIRE(writer.close());
+        
+        // two whole records and part of a third reached the disk but the count was never raised
+        std::fstream crash(path.c_str(), std::ios::in | std::ios::out | std::ios::binary | std::ios::ate);
+        string uncommitted(2 * writer.header().dataRecordSize() + 100, 'x');
+        crash.write(uncommitted.data(), uncommitted.size());
+        crash.close();
+        
+        REQUIRE(EDFWriter::recover(path.c_str()) == 4);
+        EDFFile repaired(path.c_str());
+        REQUIRE(repaired.header()->dataRecordCount() == 4);
+        std::ifstream in(path.c_str(), std::ios::binary | std::ios::ate);
+        REQUIRE(static_cast<long long>(in.tellg()) == 256 * 4 + 4LL * repaired.header()->dataRecordSize());
+    }
+}
+
+TEST_CASE("Writer - Followed by a reader") {
+    string path = "edf_follow_test.edf";
+    TempFile tempFile(path);
+    EDFGenerator generator;
+    generator.setFiletype(FileType::EDFPLUS);
+    generator.setAnnotations(1);
+    generator.addChannel("EEG", 100);
+    
+    vector<int16_t> eeg(100);
+    const int16_t* signals[] = {eeg.data()};
+    auto fill = [&](int r) {
+        for (int i = 0; i < 100; i++)
+            eeg[i] = static_cast<int16_t>(r * 1000 + i);
+    };
+    
+    EDFWriter writer;
+    REQUIRE(writer.create(path.c_str(), generator.header()));
+    writer.addAnnotation(0.5, "Start");
+    range_loop(r, 0, 2, 1) {
+        fill(r);
+        REQUIRE(writer.writeRecord(signals));
+    }
+    
+    EDFFile reader(path.c_str());
+    REQUIRE(reader.header()->dataRecordCount() == 2);
+    REQUIRE(reader.annotations()->size() == 1);
+    int first = -1, added = 0;
+    int id = reader.subscribe([&](int from, int count) { first = from; added += count; });
+    REQUIRE(reader.refresh() == 0);
+    
+    // half a record is not picked up
+    {
+        std::ofstream torn(path.c_str(), std::ios::binary | std::ios::app);
+        string half(writer.header().dataRecordSize() / 2, 'x');
+        torn.write(half.data(), half.size());
+    }
+    REQUIRE(reader.refresh() == 0);
+    REQUIRE(added == 0);
+    
+    range_loop(r, 2, 4, 1) {
+        if (r == 3)
+            writer.addAnnotation(3.5, "Later");
+        fill(r);
+        REQUIRE(writer.writeRecord(signals));
+    }
+    REQUIRE(reader.refresh() == 2);
+    REQUIRE(first == 2);
+    REQUIRE(added == 2);
+    REQUIRE(reader.header()->dataRecordCount() == 4);
+    REQUIRE(reader.annotations()->size() == 2);
+    REQUIRE(reader.annotations()->back().strings()[0] == "Later");
+    EDFSignalSamples<int16_t>* samples = reader.extractSamples<int16_t>(0, 3, 1);
+    REQUIRE(samples->size() == 100);
+    REQUIRE(samples->data()[42] == 3042);
+    delete samples;
+    
+    // a wait with no writer times out, one with a writer wakes for it
+    REQUIRE(reader.follow(20) == 0);
+    reader.unsubscribe(id);
+    std::thread producer([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        fill(4);
+        writer.writeRecord(signals);
+    });
+    REQUIRE(reader.follow(5000) == 1);
+    producer.join();
+    REQUIRE(reader.header()->dataRecordCount() == 5);
+    REQUIRE(added == 2);
+    
+    REQUIRE(writer.close());
+}
+
+/***** WRITER *****/
+
 /***** HEADER *****/
 
 TEST_CASE("Header - Constructor") {
@@ -851,4 +2762,28 @@ TEST_CASE("Header - copy constructor") {
     }
 }
 
+TEST_CASE("Header - move") {
+    EDFGenerator generator(2);
+    generator.setFiletype(FileType::EDFPLUS);
+    generator.addChannel("EEG Fz", 256);
+    generator.addChannel("ECG", 128);
+    EDFHeader h1 = generator.header();
+    
+    EDFHeader h2(std::move(h1));
+    REQUIRE(h2.signalCount() == 3);
+    REQUIRE(h2.label(1) == "ECG");
+    REQUIRE(h2.signalSampleCount(0) == 256);
+    REQUIRE(h2.annotationIndex() == 2);
+    REQUIRE(h1.signalCount() == 0);
+    REQUIRE_FALSE(h1.signalAvailable(0));
+    
+    EDFHeader h3;
+    h3.setSignalCount(1);
+    h3 = std::move(h2);
+    REQUIRE(h3.signalCount() == 3);
+    REQUIRE(h3.label(0) == "EEG Fz");
+    REQUIRE(h3.filetype() == FileType::EDFPLUS);
+    REQUIRE(h2.signalCount() == 0);
+}
+
 /***** HEADER *****/